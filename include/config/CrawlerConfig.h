@@ -9,24 +9,48 @@
 enum class CrawlerMode {
     THREAD,
     COROUTINE,
-    PROCESS
+    PROCESS,
+    HYBRID
+};
+
+// CPU placement per pipeline stage: "0-3,8" or "node:1"; empty = unpinned
+struct AffinitySettings {
+    std::string network;
+    std::string parse;
+    std::string storage;
 };
 
 struct CrawlerSettings {
     CrawlerMode mode = CrawlerMode::THREAD;
-    size_t max_connections = 10;
+    size_t max_connections = 10;   // per worker process in hybrid mode
+    size_t worker_processes = 4;   // hybrid mode only
     int request_timeout = 30;
     int retry_attempts = 3;
     double delay_between_requests = 1.0;
     std::string user_agent = "AcademicCrawler/1.0";
     std::string log_level = "info";
+    size_t parallel_parse_threshold_kb = 4096;  // split larger responses across parse workers; 0 = never
+    AffinitySettings affinity;
 };
 
 struct StorageSettings {
     std::string output_dir = "./data";
-    std::string output_format = "json";
+    std::string output_format = "json";  // json, jsonl, bin, parquet, csv, xml
     size_t max_file_size_mb = 100;
     size_t batch_size = 100;
+    std::string fsync = "none";  // jsonl: none, batch, interval
+    int fsync_interval_ms = 1000;
+    size_t shards = 1;                 // independent writers, tied together by manifest.json
+    std::string shard_by = "thread";   // thread, id (thread may let a paper saved twice at once through dedup)
+    std::string parquet_codec = "zstd";   // parquet: none, zstd
+    size_t parquet_row_group_rows = 65536;
+    std::string compression = "none";  // jsonl, bin: none, zstd (seekable frames)
+    int compression_level = 3;
+    size_t compression_frame_kb = 1024;   // uncompressed bytes per zstd frame
+    bool dedup = true;                    // skip papers already stored (index/ in output_dir)
+    size_t dedup_expected_papers = 1000000;
+    bool secondary_index = true;          // jsonl, bin: source/category/month posting lists
+    size_t load_threads = 0;              // threads that parse files when loading, 0 = one per core
 };
 
 struct ApiSettings {
@@ -35,6 +59,7 @@ struct ApiSettings {
     size_t max_results = 100;
     int update_interval_hours = 24;
     size_t batch_size = 50;
+    size_t max_query_length = 2000;  // URL limit used by the query planner
 };
 
 struct DatabaseSettings {
@@ -52,6 +77,16 @@ struct MonitoringSettings {
     int log_interval_seconds = 60;
 };
 
+struct CoordinatorSettings {
+    std::string host = "127.0.0.1";
+    int port = 7700;
+    int lease_seconds = 60;
+    size_t max_attempts = 3;
+    size_t pages_per_query = 10;
+    size_t page_size = 100;
+    size_t node_concurrency = 4;
+};
+
 class CrawlerConfig {
 public:
     static CrawlerConfig& getInstance() {
@@ -61,6 +96,9 @@ public:
 
     bool loadConfig(const std::string& config_path);
     bool saveConfig(const std::string& config_path);
+    bool validate() const;
+
+    static CrawlerConfig getDefaultConfig();
 
     // Getters
     const CrawlerSettings& getCrawlerSettings() const { return crawler_settings_; }
@@ -70,6 +108,7 @@ public:
     const ApiSettings& getChemRxivSettings() const { return chemrxiv_settings_; }
     const DatabaseSettings& getDatabaseSettings() const { return database_settings_; }
     const MonitoringSettings& getMonitoringSettings() const { return monitoring_settings_; }
+    const CoordinatorSettings& getCoordinatorSettings() const { return coordinator_settings_; }
 
     const std::unordered_map<std::string, std::vector<std::string>>& getKeywords() const {
         return keywords_;
@@ -93,8 +132,21 @@ private:
     ApiSettings chemrxiv_settings_;
     DatabaseSettings database_settings_;
     MonitoringSettings monitoring_settings_;
+    CoordinatorSettings coordinator_settings_;
     std::unordered_map<std::string, std::vector<std::string>> keywords_;
 
+    // Section parsers
+    void parseCrawlerConfig(const toml::table& config);
+    void parseStorageConfig(const toml::table& config);
+    void parseApiConfigs(const toml::table& config);
+    void parseArxivConfig(const toml::table& config);
+    void parseBiorxivConfig(const toml::table& config);
+    void parseChemRxivConfig(const toml::table& config);
+    void parseKeywords(const toml::table& config);
+    void parseDatabaseConfig(const toml::table& config);
+    void parseMonitoringConfig(const toml::table& config);
+    void parseCoordinatorConfig(const toml::table& config);
+
     // Helper methods
     CrawlerMode stringToMode(const std::string& mode_str);
     std::string modeToString(CrawlerMode mode);
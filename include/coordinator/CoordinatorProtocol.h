@@ -0,0 +1,82 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_COORDINATORPROTOCOL_H
+#define CRAWLPAPER_COORDINATORPROTOCOL_H
+
+#endif //CRAWLPAPER_COORDINATORPROTOCOL_H
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+// Line-oriented text protocol between CrawlCoordinator and CrawlNode:
+//
+//   node -> coordinator                 coordinator -> node
+//   CLAIM <node_id>                     LEASE <lease_id> <ttl_ms> <work item json>
+//                                       WAIT <ms>      (everything is leased)
+//                                       DONE           (plan finished)
+//   HEARTBEAT <lease_id>                OK | LOST
+//   COMPLETE <lease_id> <paper_count>   OK | LOST
+//   FAIL <lease_id> <reason>            OK | LOST
+//   RELEASE <lease_id>                  OK | LOST
+//
+// FAIL counts an attempt against the item; RELEASE hands it back untouched,
+// for a node that is shutting down rather than failing to fetch.
+//
+// LOST means the lease expired and the item may belong to another node; the
+// holder must discard whatever it fetched for it.
+struct WorkItem {
+    uint64_t id = 0;
+    std::string source;
+    std::vector<std::string> categories;
+    size_t start_index = 0;
+    size_t max_results = 100;
+
+    nlohmann::json to_json() const {
+        return {
+                {"id", id},
+                {"source", source},
+                {"categories", categories},
+                {"start_index", start_index},
+                {"max_results", max_results}
+        };
+    }
+
+    static WorkItem from_json(const nlohmann::json& j) {
+        WorkItem item;
+        item.id = j.value("id", uint64_t{0});
+        item.source = j.value("source", "");
+        item.categories = j.value("categories", std::vector<std::string>{});
+        item.start_index = j.value("start_index", size_t{0});
+        item.max_results = j.value("max_results", size_t{100});
+        return item;
+    }
+};
+
+namespace coordinator_protocol {
+    bool send_line(int fd, const std::string& line);
+
+    // Sends as much of `pending` as the socket takes without blocking and
+    // erases what was sent. False when the connection is broken.
+    bool send_pending(int fd, std::string& pending);
+
+    // Buffers partial reads. read_line() blocks; fill() performs one recv and
+    // next_line() only drains the buffer, for use from a poll() loop.
+    class LineReader {
+    public:
+        explicit LineReader(int fd = -1) : fd_(fd) {}
+        bool read_line(std::string& line);
+        bool fill();
+        bool next_line(std::string& line);
+
+    private:
+        int fd_;
+        std::string buffer_;
+    };
+
+    int connect_to(const std::string& host, uint16_t port);
+}
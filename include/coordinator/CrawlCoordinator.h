@@ -0,0 +1,104 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_CRAWLCOORDINATOR_H
+#define CRAWLPAPER_CRAWLCOORDINATOR_H
+
+#endif //CRAWLPAPER_CRAWLCOORDINATOR_H
+
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <stop_token>
+#include "coordinator/CoordinatorProtocol.h"
+#include "scheduler/QueryPlanner.h"
+
+// Owns the crawl plan as a lease-based work queue. Nodes connect over TCP,
+// claim (source, category-set, page) items, heartbeat while fetching and
+// report completion. A lease that is not renewed within lease_ttl is
+// reassigned; the late holder gets LOST and drops its results, so every
+// item is persisted exactly once.
+class CrawlCoordinator {
+public:
+    struct Stats {
+        size_t total = 0;
+        size_t pending = 0;
+        size_t leased = 0;
+        size_t completed = 0;
+        size_t failed = 0;
+        size_t reassigned = 0;
+        size_t papers = 0;
+    };
+
+    CrawlCoordinator(uint16_t port,
+                     std::chrono::milliseconds lease_ttl = std::chrono::seconds(60),
+                     size_t max_attempts = 3);
+    ~CrawlCoordinator();
+
+    // Each planned query becomes pages_per_query items of page_size results
+    void add_plan(const std::vector<PlannedQuery>& queries, size_t pages_per_query,
+                  size_t page_size);
+    void add_item(WorkItem item);
+
+    bool start();
+    void stop();
+    void wait_completion();
+
+    // Actual listening port (useful when constructed with port 0)
+    uint16_t port() const { return port_; }
+    Stats get_stats() const;
+
+private:
+    enum class ItemState { PENDING, LEASED, COMPLETED, FAILED };
+
+    struct ItemEntry {
+        WorkItem item;
+        ItemState state = ItemState::PENDING;
+        size_t attempts = 0;
+        uint64_t lease_id = 0;
+    };
+
+    struct Lease {
+        size_t item_index;
+        std::string node_id;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    // Replies queue in `output` and are flushed when the socket is writable,
+    // so one node that stops reading cannot stall the serve loop
+    struct Connection {
+        explicit Connection(int fd) : fd(fd), reader(fd) {}
+
+        int fd;
+        coordinator_protocol::LineReader reader;
+        std::string output;
+    };
+
+    uint16_t port_;
+    std::chrono::milliseconds lease_ttl_;
+    size_t max_attempts_;
+    int listen_fd_ = -1;
+
+    std::vector<ItemEntry> items_;
+    std::deque<size_t> pending_;
+    std::unordered_map<uint64_t, Lease> leases_;
+    uint64_t next_lease_id_ = 1;
+    Stats stats_;
+
+    mutable std::mutex state_mutex_;
+    std::condition_variable done_condition_;
+    std::jthread server_thread_;
+
+    void serve(std::stop_token stop_token);
+    std::string handle_request(const std::string& line);
+    void expire_leases();
+    void release_item(size_t index, bool count_attempt);
+    bool finished() const;
+};
@@ -0,0 +1,65 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_CRAWLNODE_H
+#define CRAWLPAPER_CRAWLNODE_H
+
+#endif //CRAWLPAPER_CRAWLNODE_H
+
+#pragma once
+#include <string>
+#include <memory>
+#include <atomic>
+#include <optional>
+#include <functional>
+#include <stop_token>
+#include "coordinator/CoordinatorProtocol.h"
+#include "scheduler/Scheduler.h"
+
+// Crawler side of the coordinator protocol. Runs `concurrency` lease loops,
+// each on its own connection: claim an item, fetch it while a heartbeat
+// thread keeps the lease alive, then report completion. Papers are only
+// handed to the callback after the coordinator acknowledges the completion,
+// so a node that lost its lease never persists a duplicate.
+class CrawlNode {
+public:
+    // Response body for a work item, nullopt if it could not be fetched;
+    // must return soon after `stop_token` is triggered
+    using Fetch = std::function<std::optional<std::string>(const WorkItem& item, std::stop_token stop_token)>;
+
+    // GET of the item's query URL from its source
+    static std::optional<std::string> http_fetch(const WorkItem& item, std::stop_token stop_token);
+
+    CrawlNode(std::string host, uint16_t port, std::string node_id, size_t concurrency = 4,
+              Fetch fetch = http_fetch);
+
+    void set_paper_callback(Scheduler::PaperCallback callback) { paper_callback_ = callback; }
+    void set_error_callback(Scheduler::ErrorCallback callback) { error_callback_ = callback; }
+    void set_query_planner(std::shared_ptr<const QueryPlanner> planner) { query_planner_ = planner; }
+
+    // Blocks until the coordinator reports the plan as done or stop() is called
+    void run();
+    void stop();
+
+    size_t get_completed_count() const { return completed_.load(); }
+    size_t get_lost_count() const { return lost_.load(); }
+
+private:
+    std::string host_;
+    uint16_t port_;
+    std::string node_id_;
+    size_t concurrency_;
+    Fetch fetch_;
+
+    Scheduler::PaperCallback paper_callback_;
+    Scheduler::ErrorCallback error_callback_;
+    std::shared_ptr<const QueryPlanner> query_planner_;
+
+    std::stop_source stop_source_;
+    std::atomic<size_t> completed_{0};
+    std::atomic<size_t> lost_{0};
+
+    void lease_loop(size_t worker_index);
+    void notify_error(const std::string& source, const std::string& error);
+};
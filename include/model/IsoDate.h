@@ -0,0 +1,158 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_ISODATE_H
+#define CRAWLPAPER_ISODATE_H
+
+#endif //CRAWLPAPER_ISODATE_H
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <optional>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+// Fixed-format ISO-8601 dates as used by the preprint APIs:
+//   YYYY-MM-DD[THH:MM:SS[.fff...][Z]]
+// Always UTC, no locale and no libc timezone lookup, no allocation.
+namespace iso_date {
+
+    inline constexpr size_t kFormattedLength = 20;  // "YYYY-MM-DDTHH:MM:SSZ"
+
+    namespace detail {
+        constexpr bool read_digits(std::string_view text, size_t pos, size_t count, int& out) {
+            if (pos + count > text.size()) {
+                return false;
+            }
+            int value = 0;
+            for (size_t i = pos; i < pos + count; ++i) {
+                if (text[i] < '0' || text[i] > '9') {
+                    return false;
+                }
+                value = value * 10 + (text[i] - '0');
+            }
+            out = value;
+            return true;
+        }
+
+        constexpr void write_digits(char* out, int value, size_t count) {
+            for (size_t i = count; i > 0; --i) {
+                out[i - 1] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        }
+    }
+
+    // Seconds since the Unix epoch, or nullopt if `text` is not in the format
+    constexpr std::optional<int64_t> parse_epoch_seconds(std::string_view text) {
+        int year = 0, month = 0, day = 0;
+        if (!detail::read_digits(text, 0, 4, year) || text.size() < 10 ||
+            text[4] != '-' || !detail::read_digits(text, 5, 2, month) ||
+            text[7] != '-' || !detail::read_digits(text, 8, 2, day)) {
+            return std::nullopt;
+        }
+
+        std::chrono::year_month_day date{std::chrono::year{year},
+                                         std::chrono::month{static_cast<unsigned>(month)},
+                                         std::chrono::day{static_cast<unsigned>(day)}};
+        if (!date.ok()) {
+            return std::nullopt;
+        }
+
+        int hour = 0, minute = 0, second = 0;
+        size_t pos = 10;
+        if (pos < text.size() && (text[pos] == 'T' || text[pos] == ' ')) {
+            if (!detail::read_digits(text, 11, 2, hour) || text.size() < 19 ||
+                text[13] != ':' || !detail::read_digits(text, 14, 2, minute) ||
+                text[16] != ':' || !detail::read_digits(text, 17, 2, second) ||
+                hour > 23 || minute > 59 || second > 60) {
+                return std::nullopt;
+            }
+            pos = 19;
+
+            // Fractional seconds are accepted and truncated
+            if (pos < text.size() && text[pos] == '.') {
+                ++pos;
+                while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+            }
+        }
+
+        if (pos < text.size() && text[pos] == 'Z') {
+            ++pos;
+        }
+        if (pos != text.size()) {
+            return std::nullopt;
+        }
+
+        int64_t days = std::chrono::sys_days{date}.time_since_epoch().count();
+        return days * 86400 + hour * 3600 + minute * 60 + second;
+    }
+
+    // The four-digit years the format can hold: 0000-01-01T00:00:00Z to
+    // 9999-12-31T23:59:59Z
+    inline constexpr int64_t kMinEpochSeconds = -62167219200;
+    inline constexpr int64_t kMaxEpochSeconds = 253402300799;
+
+    // Writes exactly kFormattedLength characters (no terminator) to `out`.
+    // Times outside the four-digit years (corrupt records, time_point::min()
+    // and max() sentinels) are clamped to the nearest end.
+    constexpr void format_epoch_seconds(int64_t seconds, char* out) {
+        seconds = std::clamp(seconds, kMinEpochSeconds, kMaxEpochSeconds);
+        int64_t days = seconds / 86400;
+        int64_t rest = seconds % 86400;
+        if (rest < 0) {
+            rest += 86400;
+            --days;
+        }
+
+        std::chrono::year_month_day date{std::chrono::sys_days{std::chrono::days{days}}};
+        detail::write_digits(out, static_cast<int>(date.year()), 4);
+        out[4] = '-';
+        detail::write_digits(out + 5, static_cast<int>(static_cast<unsigned>(date.month())), 2);
+        out[7] = '-';
+        detail::write_digits(out + 8, static_cast<int>(static_cast<unsigned>(date.day())), 2);
+        out[10] = 'T';
+        detail::write_digits(out + 11, static_cast<int>(rest / 3600), 2);
+        out[13] = ':';
+        detail::write_digits(out + 14, static_cast<int>(rest / 60 % 60), 2);
+        out[16] = ':';
+        detail::write_digits(out + 17, static_cast<int>(rest % 60), 2);
+        out[19] = 'Z';
+    }
+
+    // Unparseable input maps to the epoch
+    inline std::chrono::system_clock::time_point parse(std::string_view text) {
+        auto seconds = parse_epoch_seconds(text).value_or(0);
+        return std::chrono::system_clock::time_point{std::chrono::seconds{seconds}};
+    }
+
+    inline std::string format(std::chrono::system_clock::time_point time_point) {
+        auto seconds = std::chrono::floor<std::chrono::seconds>(time_point).time_since_epoch().count();
+        std::string text(kFormattedLength, '\0');
+        format_epoch_seconds(seconds, text.data());
+        return text;
+    }
+
+    static_assert(parse_epoch_seconds("1970-01-01") == 0);
+    static_assert(parse_epoch_seconds("2024-02-29T12:34:56Z") == 1709210096);
+    static_assert(parse_epoch_seconds("2024-02-01T10:00:00.123Z") == 1706781600);
+    static_assert(!parse_epoch_seconds("2023-02-29"));
+
+    namespace detail {
+        constexpr bool formats_as(int64_t seconds, std::string_view expected) {
+            char text[kFormattedLength] = {};
+            format_epoch_seconds(seconds, text);
+            return std::string_view(text, kFormattedLength) == expected;
+        }
+    }
+
+    static_assert(parse_epoch_seconds("0000-01-01T00:00:00Z") == kMinEpochSeconds);
+    static_assert(parse_epoch_seconds("9999-12-31T23:59:59Z") == kMaxEpochSeconds);
+    static_assert(detail::formats_as(kMinEpochSeconds, "0000-01-01T00:00:00Z"));
+    static_assert(detail::formats_as(kMaxEpochSeconds, "9999-12-31T23:59:59Z"));
+    static_assert(detail::formats_as(INT64_MIN, "0000-01-01T00:00:00Z"));
+    static_assert(detail::formats_as(INT64_MAX, "9999-12-31T23:59:59Z"));
+}
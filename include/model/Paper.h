@@ -9,15 +9,45 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <chrono>
-#include <ctime>
+#include <memory_resource>
 #include <nlohmann/json.hpp>
-
+#include "IsoDate.h"
+#include "SymbolTable.h"
+
+// Symbols serialise as their text (see SymbolTable.h)
+inline void to_json(nlohmann::json& j, Symbol symbol) {
+    j = symbol.str();
+}
+
+// Paper and Author are allocator-aware: parsers build them on a per-response
+// arena (see PaperArena.h) so a whole batch is released at once. The plain
+// copy constructor allocates from the default resource, so a copy may outlive
+// the arena; moves keep the source's allocator. Sources, categories and
+// affiliations repeat across thousands of papers and are interned as Symbols.
 struct Author {
-    std::string name;
-    std::string affiliation;
-    std::string orcid;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    std::pmr::string name;
+    Symbol affiliation;
+    std::pmr::string orcid;
+
+    Author() = default;
+    explicit Author(allocator_type alloc) : name(alloc), orcid(alloc) {}
+    Author(std::string_view name, std::string_view affiliation, std::string_view orcid,
+           allocator_type alloc = {})
+            : name(name, alloc), affiliation(Symbol::intern(affiliation)), orcid(orcid, alloc) {}
+
+    Author(const Author&) = default;
+    Author(Author&&) = default;
+    Author& operator=(const Author&) = default;
+    Author& operator=(Author&&) = default;
+
+    // Allocator-extended copy/move, used by pmr containers
+    Author(const Author& other, allocator_type alloc) : Author(alloc) { *this = other; }
+    Author(Author&& other, allocator_type alloc) : Author(alloc) { *this = std::move(other); }
 
     nlohmann::json to_json() const {
         return {
@@ -37,22 +67,31 @@ struct Author {
 };
 
 struct Paper {
-    std::string id;
-    std::string title;
-    std::string abstract;
-    std::vector<Author> authors;
-    std::string doi;
-    std::string pdf_url;
-    std::string source;
-    std::vector<std::string> categories;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    std::pmr::string id;
+    std::pmr::string title;
+    std::pmr::string abstract;
+    std::pmr::vector<Author> authors;
+    std::pmr::string doi;
+    std::pmr::string pdf_url;
+    Symbol source;
+    std::pmr::vector<Symbol> categories;
     std::chrono::system_clock::time_point published_date;
     std::chrono::system_clock::time_point updated_date;
-    std::string journal_ref;
-    std::string comment;
+    std::pmr::string journal_ref;
+    std::pmr::string comment;
     int version = 1;
 
+    // Keyword groups (config [keywords]) whose categories matched this paper
+    std::pmr::vector<std::pmr::string> keywords;
+
     // Modern C++ features
     Paper() = default;
+    explicit Paper(allocator_type alloc)
+            : id(alloc), title(alloc), abstract(alloc), authors(alloc), doi(alloc),
+              pdf_url(alloc), categories(alloc), journal_ref(alloc),
+              comment(alloc), keywords(alloc) {}
 
     // Move semantics
     Paper(Paper&&) = default;
@@ -62,29 +101,31 @@ struct Paper {
     Paper(const Paper&) = default;
     Paper& operator=(const Paper&) = default;
 
+    // Allocator-extended copy/move, used by pmr containers
+    Paper(const Paper& other, allocator_type alloc) : Paper(alloc) { *this = other; }
+    Paper(Paper&& other, allocator_type alloc) : Paper(alloc) { *this = std::move(other); }
+
     nlohmann::json to_json() const {
-        auto time_to_string = [](const auto& time_point) {
-            auto time_t = std::chrono::system_clock::to_time_t(time_point);
-            std::tm tm = *std::gmtime(&time_t);
-            char buffer[64];
-            std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm);
-            return std::string(buffer);
-        };
+        auto author_list = nlohmann::json::array();
+        for (const auto& author : authors) {
+            author_list.push_back(author.to_json());
+        }
 
         return {
                 {"id", id},
                 {"title", title},
                 {"abstract", abstract},
-                {"authors", nlohmann::json::array()},
+                {"authors", author_list},
                 {"doi", doi},
                 {"pdf_url", pdf_url},
                 {"source", source},
                 {"categories", categories},
-                {"published_date", time_to_string(published_date)},
-                {"updated_date", time_to_string(updated_date)},
+                {"published_date", iso_date::format(published_date)},
+                {"updated_date", iso_date::format(updated_date)},
                 {"journal_ref", journal_ref},
                 {"comment", comment},
-                {"version", version}
+                {"version", version},
+                {"keywords", keywords}
         };
     }
 
@@ -95,7 +136,7 @@ struct Paper {
         paper.abstract = j.value("abstract", "");
         paper.doi = j.value("doi", "");
         paper.pdf_url = j.value("pdf_url", "");
-        paper.source = j.value("source", "");
+        paper.source = Symbol::intern(j.value("source", ""));
         paper.journal_ref = j.value("journal_ref", "");
         paper.comment = j.value("comment", "");
         paper.version = j.value("version", 1);
@@ -110,23 +151,23 @@ struct Paper {
         // Parse categories
         if (j.contains("categories") && j["categories"].is_array()) {
             for (const auto& category : j["categories"]) {
-                paper.categories.push_back(category);
+                paper.categories.push_back(Symbol::intern(category.get_ref<const std::string&>()));
             }
         }
 
-        // Parse dates
-        auto string_to_time = [](const std::string& str) {
-            std::tm tm = {};
-            std::istringstream ss(str);
-            ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
-            return std::chrono::system_clock::from_time_t(std::mktime(&tm));
-        };
+        // Parse keyword groups
+        if (j.contains("keywords") && j["keywords"].is_array()) {
+            for (const auto& keyword : j["keywords"]) {
+                paper.keywords.emplace_back(keyword.get_ref<const std::string&>());
+            }
+        }
 
-        if (j.contains("published_date")) {
-            paper.published_date = string_to_time(j["published_date"]);
+        // Parse dates (UTC)
+        if (j.contains("published_date") && j["published_date"].is_string()) {
+            paper.published_date = iso_date::parse(j["published_date"].get_ref<const std::string&>());
         }
-        if (j.contains("updated_date")) {
-            paper.updated_date = string_to_time(j["updated_date"]);
+        if (j.contains("updated_date") && j["updated_date"].is_string()) {
+            paper.updated_date = iso_date::parse(j["updated_date"].get_ref<const std::string&>());
         }
 
         return paper;
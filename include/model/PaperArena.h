@@ -0,0 +1,61 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_PAPERARENA_H
+#define CRAWLPAPER_PAPERARENA_H
+
+#endif //CRAWLPAPER_PAPERARENA_H
+
+#pragma once
+#include <memory_resource>
+#include <deque>
+#include <mutex>
+
+// Memory for the Papers parsed from one response. Every string and vector of
+// the batch is bump-allocated and nothing is freed individually; destroying
+// the PaperArena (after the batch has been persisted) releases it all at once.
+//
+// monotonic_buffer_resource is not thread-safe, so each parse, or each chunk
+// of a parallel parse, takes its own region. Regions of one arena compare
+// equal, which lets Papers move between them (e.g. when chunk results are
+// merged) without copying their text.
+class PaperArena {
+public:
+    PaperArena() = default;
+    PaperArena(const PaperArena&) = delete;
+    PaperArena& operator=(const PaperArena&) = delete;
+
+    // A new region sized for parsing about `input_bytes` of response text.
+    // Safe to call concurrently; each region must be used by one thread.
+    std::pmr::memory_resource* region(size_t input_bytes) {
+        std::lock_guard lock(mutex_);
+        return &regions_.emplace_back(this, input_bytes);
+    }
+
+private:
+    class Region : public std::pmr::memory_resource {
+    public:
+        Region(const PaperArena* owner, size_t initial_size)
+                : owner_(owner), buffer_(std::max<size_t>(initial_size, 1024)) {}
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            return buffer_.allocate(bytes, alignment);
+        }
+
+        // Memory is only reclaimed with the whole arena
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            auto* region = dynamic_cast<const Region*>(&other);
+            return region && region->owner_ == owner_;
+        }
+
+        const PaperArena* owner_;
+        std::pmr::monotonic_buffer_resource buffer_;
+    };
+
+    std::mutex mutex_;
+    std::deque<Region> regions_;  // deque: regions never move
+};
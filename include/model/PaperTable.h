@@ -0,0 +1,317 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_PAPERTABLE_H
+#define CRAWLPAPER_PAPERTABLE_H
+
+#endif //CRAWLPAPER_PAPERTABLE_H
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <span>
+#include <optional>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include "Paper.h"
+#include "SymbolTable.h"
+
+// Column-oriented, read-mostly copy of many Papers for bulk scans.
+//
+// Every field is its own dense array indexed by row: dates are int64 epoch
+// seconds, sources are symbols, and the multi-valued fields (categories,
+// keywords, authors) are stored CSR-style as one flat array plus per-row
+// offsets. All text lives in a single heap and is addressed by packed
+// (offset, size) references, so a filtered scan over dates or categories
+// touches a few contiguous arrays and never dereferences a string.
+class PaperTable {
+public:
+    using Row = uint32_t;
+    using Seconds = std::chrono::sys_seconds;
+
+    enum class Text : size_t {
+        Id, Title, Abstract, Doi, PdfUrl, JournalRef, Comment, Count
+    };
+
+    // Row predicate for scan()/select(); unset members match everything.
+    // Dates are compared on the half-open range [published_from, published_to).
+    struct Filter {
+        std::optional<Symbol> source;
+        std::optional<Symbol> category;
+        Seconds published_from = Seconds::min();
+        Seconds published_to = Seconds::max();
+    };
+
+    PaperTable() {
+        category_offsets_.push_back(0);
+        keyword_offsets_.push_back(0);
+        author_offsets_.push_back(0);
+    }
+
+    template <typename Papers>
+    static PaperTable from_papers(const Papers& papers) {
+        PaperTable table;
+        table.reserve(papers.size());
+        for (const auto& paper : papers) {
+            table.append(paper);
+        }
+        return table;
+    }
+
+    void reserve(size_t rows, size_t text_bytes = 0) {
+        for (auto& column : text_) {
+            column.reserve(rows);
+        }
+        source_.reserve(rows);
+        published_.reserve(rows);
+        updated_.reserve(rows);
+        version_.reserve(rows);
+        category_offsets_.reserve(rows + 1);
+        keyword_offsets_.reserve(rows + 1);
+        author_offsets_.reserve(rows + 1);
+        heap_.reserve(text_bytes);
+    }
+
+    // Throws std::length_error, leaving the table unchanged, if the paper
+    // does not fit: a text field over 16 MiB, or the row count, text heap or
+    // a CSR array past what its offsets can address
+    void append(const Paper& paper) {
+        if (size() == kMaxRows) {
+            throw std::length_error("PaperTable is full");
+        }
+        // Checked before anything is appended, so a throw leaves the table as it was
+        check_fits(paper);
+
+        set_text(Text::Id, paper.id);
+        set_text(Text::Title, paper.title);
+        set_text(Text::Abstract, paper.abstract);
+        set_text(Text::Doi, paper.doi);
+        set_text(Text::PdfUrl, paper.pdf_url);
+        set_text(Text::JournalRef, paper.journal_ref);
+        set_text(Text::Comment, paper.comment);
+
+        source_.push_back(paper.source);
+        published_.push_back(to_seconds(paper.published_date));
+        updated_.push_back(to_seconds(paper.updated_date));
+        version_.push_back(paper.version);
+
+        categories_.insert(categories_.end(), paper.categories.begin(), paper.categories.end());
+        category_offsets_.push_back(static_cast<uint32_t>(categories_.size()));
+
+        for (const auto& keyword : paper.keywords) {
+            keywords_.push_back(Symbol::intern(keyword));
+        }
+        keyword_offsets_.push_back(static_cast<uint32_t>(keywords_.size()));
+
+        for (const auto& author : paper.authors) {
+            author_names_.push_back(store(author.name));
+            author_affiliations_.push_back(author.affiliation);
+            author_orcids_.push_back(store(author.orcid));
+        }
+        author_offsets_.push_back(static_cast<uint32_t>(author_names_.size()));
+    }
+
+    size_t size() const { return source_.size(); }
+    bool empty() const { return source_.empty(); }
+
+    // Column access
+    std::string_view text(Text column, Row row) const {
+        return resolve(text_[static_cast<size_t>(column)][row]);
+    }
+    Symbol source(Row row) const { return source_[row]; }
+    int64_t published(Row row) const { return published_[row]; }
+    int64_t updated(Row row) const { return updated_[row]; }
+    int version(Row row) const { return version_[row]; }
+
+    std::span<const Symbol> categories(Row row) const {
+        return csr(categories_, category_offsets_, row);
+    }
+    std::span<const Symbol> keywords(Row row) const {
+        return csr(keywords_, keyword_offsets_, row);
+    }
+    size_t author_count(Row row) const {
+        return author_offsets_[row + 1] - author_offsets_[row];
+    }
+
+    // Whole columns, for callers that vectorise their own scans
+    std::span<const int64_t> published_column() const { return published_; }
+    std::span<const Symbol> source_column() const { return source_; }
+
+    // Calls fn(row) for every matching row, in row order. The date and source
+    // columns are tested first; categories are only read for rows that pass.
+    template <typename Fn>
+    void scan(const Filter& filter, Fn&& fn) const {
+        int64_t from = filter.published_from.time_since_epoch().count();
+        int64_t to = filter.published_to.time_since_epoch().count();
+        const size_t rows = size();
+
+        for (size_t row = 0; row < rows; ++row) {
+            if (published_[row] < from || published_[row] >= to) {
+                continue;
+            }
+            if (filter.source && source_[row] != *filter.source) {
+                continue;
+            }
+            if (filter.category) {
+                auto categories = this->categories(static_cast<Row>(row));
+                if (std::find(categories.begin(), categories.end(), *filter.category) == categories.end()) {
+                    continue;
+                }
+            }
+            fn(static_cast<Row>(row));
+        }
+    }
+
+    std::vector<Row> select(const Filter& filter) const {
+        std::vector<Row> rows;
+        scan(filter, [&](Row row) { rows.push_back(row); });
+        return rows;
+    }
+
+    // Rebuilds the Paper at `row`, e.g. to serialise a scan result
+    Paper to_paper(Row row, Paper::allocator_type alloc = {}) const {
+        Paper paper(alloc);
+        paper.id = text(Text::Id, row);
+        paper.title = text(Text::Title, row);
+        paper.abstract = text(Text::Abstract, row);
+        paper.doi = text(Text::Doi, row);
+        paper.pdf_url = text(Text::PdfUrl, row);
+        paper.journal_ref = text(Text::JournalRef, row);
+        paper.comment = text(Text::Comment, row);
+
+        paper.source = source_[row];
+        paper.published_date = Seconds(std::chrono::seconds(published_[row]));
+        paper.updated_date = Seconds(std::chrono::seconds(updated_[row]));
+        paper.version = version_[row];
+
+        auto categories = this->categories(row);
+        paper.categories.assign(categories.begin(), categories.end());
+        for (Symbol keyword : keywords(row)) {
+            paper.keywords.emplace_back(keyword.str());
+        }
+
+        paper.authors.reserve(author_count(row));
+        for (uint32_t i = author_offsets_[row]; i < author_offsets_[row + 1]; ++i) {
+            auto& author = paper.authors.emplace_back();
+            author.name = resolve(author_names_[i]);
+            author.affiliation = author_affiliations_[i];
+            author.orcid = resolve(author_orcids_[i]);
+        }
+        return paper;
+    }
+
+    std::vector<Paper> to_papers() const {
+        std::vector<Paper> papers;
+        papers.reserve(size());
+        for (Row row = 0; row < size(); ++row) {
+            papers.push_back(to_paper(row));
+        }
+        return papers;
+    }
+
+    // Bytes held by the columns and the text heap
+    size_t memory_usage() const {
+        size_t bytes = heap_.capacity();
+        for (const auto& column : text_) {
+            bytes += column.capacity() * sizeof(TextRef);
+        }
+        bytes += (source_.capacity() + categories_.capacity() + keywords_.capacity() +
+                  author_affiliations_.capacity()) * sizeof(Symbol);
+        bytes += (published_.capacity() + updated_.capacity()) * sizeof(int64_t);
+        bytes += version_.capacity() * sizeof(int32_t);
+        bytes += (category_offsets_.capacity() + keyword_offsets_.capacity() +
+                  author_offsets_.capacity()) * sizeof(uint32_t);
+        bytes += (author_names_.capacity() + author_orcids_.capacity()) * sizeof(TextRef);
+        return bytes;
+    }
+
+private:
+    // Heap offset in the high 40 bits, size in the low 24: strings up to
+    // 16 MiB in a heap of up to 1 TiB
+    using TextRef = uint64_t;
+    static constexpr int kSizeBits = 24;
+    static constexpr size_t kMaxTextSize = (size_t{1} << kSizeBits) - 1;
+    static constexpr size_t kMaxHeapSize = size_t{1} << (64 - kSizeBits);
+    // CSR offsets are 32-bit
+    static constexpr size_t kMaxRows = UINT32_MAX - 1;
+    static constexpr size_t kMaxCsrSize = UINT32_MAX;
+
+    static int64_t to_seconds(std::chrono::system_clock::time_point time) {
+        return std::chrono::floor<std::chrono::seconds>(time).time_since_epoch().count();
+    }
+
+    static std::span<const Symbol> csr(const std::vector<Symbol>& values,
+                                       const std::vector<uint32_t>& offsets, Row row) {
+        return {values.data() + offsets[row], values.data() + offsets[row + 1]};
+    }
+
+    void check_fits(const Paper& paper) const {
+        size_t text_bytes = 0;
+        auto add_text = [&](std::string_view text) {
+            if (text.size() > kMaxTextSize) {
+                throw std::length_error("PaperTable text field exceeds 16 MiB");
+            }
+            text_bytes += text.size();
+        };
+        for (std::string_view text : {std::string_view(paper.id), std::string_view(paper.title),
+                                      std::string_view(paper.abstract), std::string_view(paper.doi),
+                                      std::string_view(paper.pdf_url), std::string_view(paper.journal_ref),
+                                      std::string_view(paper.comment)}) {
+            add_text(text);
+        }
+        for (const auto& author : paper.authors) {
+            add_text(author.name);
+            add_text(author.orcid);
+        }
+        if (text_bytes > kMaxHeapSize - heap_.size()) {
+            throw std::length_error("PaperTable text heap is full");
+        }
+        if (paper.categories.size() > kMaxCsrSize - categories_.size()) {
+            throw std::length_error("PaperTable categories are full");
+        }
+        if (paper.keywords.size() > kMaxCsrSize - keywords_.size()) {
+            throw std::length_error("PaperTable keywords are full");
+        }
+        if (paper.authors.size() > kMaxCsrSize - author_names_.size()) {
+            throw std::length_error("PaperTable authors are full");
+        }
+    }
+
+    TextRef store(std::string_view text) {
+        TextRef ref = (static_cast<uint64_t>(heap_.size()) << kSizeBits) | text.size();
+        heap_.append(text);
+        return ref;
+    }
+
+    void set_text(Text column, std::string_view text) {
+        text_[static_cast<size_t>(column)].push_back(store(text));
+    }
+
+    std::string_view resolve(TextRef ref) const {
+        return {heap_.data() + (ref >> kSizeBits), static_cast<size_t>(ref & kMaxTextSize)};
+    }
+
+    std::array<std::vector<TextRef>, static_cast<size_t>(Text::Count)> text_;
+    std::vector<Symbol> source_;
+    std::vector<int64_t> published_;
+    std::vector<int64_t> updated_;
+    std::vector<int32_t> version_;
+
+    std::vector<Symbol> categories_;
+    std::vector<uint32_t> category_offsets_;
+    std::vector<Symbol> keywords_;
+    std::vector<uint32_t> keyword_offsets_;
+
+    // One entry per author, rows delimited by author_offsets_
+    std::vector<TextRef> author_names_;
+    std::vector<Symbol> author_affiliations_;
+    std::vector<TextRef> author_orcids_;
+    std::vector<uint32_t> author_offsets_;
+
+    std::string heap_;
+};
@@ -0,0 +1,197 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_PAPERVIEW_H
+#define CRAWLPAPER_PAPERVIEW_H
+
+#endif //CRAWLPAPER_PAPERVIEW_H
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstring>
+#include <nlohmann/json.hpp>
+#include "Paper.h"
+#include "IsoDate.h"
+
+// Append-only storage for text that had to be decoded (entities, CDATA) or
+// composed (pdf_url) and therefore cannot point into the response itself.
+// Blocks are never reallocated, so returned views stay valid for the
+// arena's lifetime.
+class TextArena {
+public:
+    explicit TextArena(size_t block_size = 64 * 1024) : block_size_(block_size) {}
+
+    TextArena(const TextArena&) = delete;
+    TextArena& operator=(const TextArena&) = delete;
+
+    std::string_view store(std::string_view text) {
+        if (text.empty()) {
+            return {};
+        }
+        if (text.size() > capacity_ - used_) {
+            size_t size = std::max(block_size_, text.size());
+            blocks_.push_back(std::make_unique<char[]>(size));
+            capacity_ = size;
+            used_ = 0;
+        }
+        char* destination = blocks_.back().get() + used_;
+        std::memcpy(destination, text.data(), text.size());
+        used_ += text.size();
+        bytes_used_ += text.size();
+        return {destination, text.size()};
+    }
+
+    size_t bytes_used() const { return bytes_used_; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t block_size_;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    size_t bytes_used_ = 0;
+};
+
+// Everything a batch of PaperViews points into: the immutable response body
+// and the arena for fields that could not be referenced in place
+struct ViewBuffer {
+    std::shared_ptr<const std::string> response;
+    TextArena arena;
+};
+
+struct AuthorView {
+    std::string_view name;
+    std::string_view affiliation;
+    std::string_view orcid;
+
+    Author to_author() const {
+        return {name, affiliation, orcid};
+    }
+};
+
+// Non-owning counterpart of Paper. Text fields are views into `buffer`, which
+// keeps the response and arena alive; copying a view is cheap and never
+// copies text. Call to_paper() only when the data must outlive the batch.
+struct PaperView {
+    std::string_view id;
+    std::string_view title;
+    std::string_view abstract;
+    std::vector<AuthorView> authors;
+    std::string_view doi;
+    std::string_view pdf_url;
+    std::string_view source;
+    std::vector<std::string_view> categories;
+    std::chrono::system_clock::time_point published_date;
+    std::chrono::system_clock::time_point updated_date;
+    std::string_view journal_ref;
+    std::string_view comment;
+    int version = 1;
+
+    // Assigned by routing after parsing, so owned rather than viewed
+    std::vector<std::string> keywords;
+
+    // Null for views borrowed from a Paper (see of())
+    std::shared_ptr<const ViewBuffer> buffer;
+
+    // Borrows the fields of `paper`; valid only while `paper` is alive
+    static PaperView of(const Paper& paper) {
+        PaperView view;
+        view.id = paper.id;
+        view.title = paper.title;
+        view.abstract = paper.abstract;
+        for (const auto& author : paper.authors) {
+            view.authors.push_back({author.name, author.affiliation.str(), author.orcid});
+        }
+        view.doi = paper.doi;
+        view.pdf_url = paper.pdf_url;
+        view.source = paper.source.str();
+        view.categories.reserve(paper.categories.size());
+        for (Symbol category : paper.categories) {
+            view.categories.push_back(category.str());
+        }
+        view.published_date = paper.published_date;
+        view.updated_date = paper.updated_date;
+        view.journal_ref = paper.journal_ref;
+        view.comment = paper.comment;
+        view.version = paper.version;
+        view.keywords.assign(paper.keywords.begin(), paper.keywords.end());
+        return view;
+    }
+
+    // Copies every viewed field into `arena`, e.g. to detach a view of() a
+    // temporary Paper
+    void store_in(TextArena& arena) {
+        for (auto* field : {&id, &title, &abstract, &doi, &pdf_url, &source, &journal_ref, &comment}) {
+            *field = arena.store(*field);
+        }
+        for (auto& author : authors) {
+            author.name = arena.store(author.name);
+            author.affiliation = arena.store(author.affiliation);
+            author.orcid = arena.store(author.orcid);
+        }
+        for (auto& category : categories) {
+            category = arena.store(category);
+        }
+    }
+
+    Paper to_paper() const {
+        Paper paper;
+        paper.id = id;
+        paper.title = title;
+        paper.abstract = abstract;
+        paper.authors.reserve(authors.size());
+        for (const auto& author : authors) {
+            paper.authors.push_back(author.to_author());
+        }
+        paper.doi = doi;
+        paper.pdf_url = pdf_url;
+        paper.source = Symbol::intern(source);
+        paper.categories.reserve(categories.size());
+        for (auto category : categories) {
+            paper.categories.push_back(Symbol::intern(category));
+        }
+        paper.published_date = published_date;
+        paper.updated_date = updated_date;
+        paper.journal_ref = journal_ref;
+        paper.comment = comment;
+        paper.version = version;
+        paper.keywords.assign(keywords.begin(), keywords.end());
+        return paper;
+    }
+
+    // Same layout as Paper::to_json
+    nlohmann::json to_json() const {
+        auto author_list = nlohmann::json::array();
+        for (const auto& author : authors) {
+            author_list.push_back({{"name", author.name},
+                                   {"affiliation", author.affiliation},
+                                   {"orcid", author.orcid}});
+        }
+
+        auto category_list = nlohmann::json::array();
+        for (auto category : categories) {
+            category_list.push_back(category);
+        }
+
+        return {
+                {"id", id},
+                {"title", title},
+                {"abstract", abstract},
+                {"authors", author_list},
+                {"doi", doi},
+                {"pdf_url", pdf_url},
+                {"source", source},
+                {"categories", category_list},
+                {"published_date", iso_date::format(published_date)},
+                {"updated_date", iso_date::format(updated_date)},
+                {"journal_ref", journal_ref},
+                {"comment", comment},
+                {"version", version},
+                {"keywords", keywords}
+        };
+    }
+};
@@ -0,0 +1,256 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_SYMBOLTABLE_H
+#define CRAWLPAPER_SYMBOLTABLE_H
+
+#endif //CRAWLPAPER_SYMBOLTABLE_H
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <optional>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <algorithm>
+
+// 32-bit handle for a string from a small, heavily repeated vocabulary
+// (sources, categories, affiliations). Equal strings get equal symbols, so
+// comparing symbols compares integers. Ids are only meaningful inside this
+// process: everything that leaves it (JSON, files, pipes) carries the text.
+class Symbol {
+public:
+    constexpr Symbol() = default;  // the empty string
+
+    static Symbol intern(std::string_view text);
+    // Without inserting: nullopt if `text` was never interned
+    static std::optional<Symbol> find(std::string_view text);
+
+    std::string_view str() const;
+    uint32_t id() const { return id_; }
+    bool empty() const { return id_ == 0; }
+
+    friend bool operator==(Symbol, Symbol) = default;
+
+private:
+    friend class SymbolTable;
+    explicit constexpr Symbol(uint32_t id) : id_(id) {}
+
+    uint32_t id_ = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& out, Symbol symbol) {
+    return out << symbol.str();
+}
+
+// Process-wide intern table. Lookups (find, resolve, and intern of a known
+// string) take no lock: the open-addressing index and the entry chunks are
+// only ever appended to and published with release stores. Inserts are
+// serialised by a mutex; a full index is rebuilt at twice the size and the
+// old one is kept alive for readers still probing it.
+class SymbolTable {
+public:
+    static SymbolTable& global() {
+        static SymbolTable table;
+        return table;
+    }
+
+    SymbolTable() {
+        auto index = std::make_unique<Index>(kInitialIndexSize);
+        index_.store(index.get(), std::memory_order_release);
+        indexes_.push_back(std::move(index));
+        append_entry({}, 0);  // id 0 is the empty string
+    }
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    Symbol intern(std::string_view text) {
+        if (text.empty()) {
+            return {};
+        }
+        uint32_t hash = hash_of(text);
+        if (uint32_t id = lookup(*index_.load(std::memory_order_acquire), text, hash)) {
+            return Symbol(id);
+        }
+
+        std::lock_guard lock(mutex_);
+        Index* index = index_.load(std::memory_order_relaxed);
+        if (uint32_t id = lookup(*index, text, hash)) {
+            return Symbol(id);
+        }
+
+        if ((size_ + 1) * 2 > index->mask + 1) {
+            index = grow(*index);
+        }
+
+        uint32_t id = append_entry(store_text(text), hash);
+        insert(*index, id, hash);
+        return Symbol(id);
+    }
+
+    std::optional<Symbol> find(std::string_view text) const {
+        if (text.empty()) {
+            return Symbol();
+        }
+        uint32_t hash = hash_of(text);
+        if (uint32_t id = lookup(*index_.load(std::memory_order_acquire), text, hash)) {
+            return Symbol(id);
+        }
+        // A concurrent grow() may have hidden a new entry from the index we probed
+        std::lock_guard lock(mutex_);
+        if (uint32_t id = lookup(*index_.load(std::memory_order_relaxed), text, hash)) {
+            return Symbol(id);
+        }
+        return std::nullopt;
+    }
+
+    std::string_view resolve(Symbol symbol) const {
+        const Entry& entry = entry_at(symbol.id());
+        return {entry.data, entry.size};
+    }
+
+    // Number of interned strings, not counting the empty one
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        const char* data = nullptr;
+        uint32_t size = 0;
+        uint32_t hash = 0;
+    };
+
+    // Slots hold entry ids; 0 marks an empty slot
+    struct Index {
+        explicit Index(size_t capacity)
+                : mask(capacity - 1), slots(std::make_unique<std::atomic<uint32_t>[]>(capacity)) {}
+
+        size_t mask;
+        std::unique_ptr<std::atomic<uint32_t>[]> slots;
+    };
+
+    static constexpr size_t kInitialIndexSize = 1024;
+    // Entry chunk k holds kFirstChunk << k entries, so 23 chunks cover every
+    // 32-bit id and an id maps to its chunk with one bit_width
+    static constexpr size_t kFirstChunk = 1024;
+    static constexpr size_t kMaxChunks = 23;
+    static constexpr size_t kTextBlockSize = 64 * 1024;
+
+    static uint32_t hash_of(std::string_view text) {
+        // FNV-1a
+        uint32_t hash = 2166136261u;
+        for (unsigned char c : text) {
+            hash = (hash ^ c) * 16777619u;
+        }
+        return hash;
+    }
+
+    static std::pair<size_t, size_t> locate(uint32_t id) {
+        size_t chunk = std::bit_width(id / kFirstChunk + 1) - 1;
+        size_t first_id = kFirstChunk * ((size_t{1} << chunk) - 1);
+        return {chunk, id - first_id};
+    }
+
+    const Entry& entry_at(uint32_t id) const {
+        auto [chunk, offset] = locate(id);
+        return chunks_[chunk].load(std::memory_order_acquire)[offset];
+    }
+
+    uint32_t lookup(const Index& index, std::string_view text, uint32_t hash) const {
+        for (size_t slot = hash & index.mask;; slot = (slot + 1) & index.mask) {
+            uint32_t id = index.slots[slot].load(std::memory_order_acquire);
+            if (id == 0) {
+                return 0;
+            }
+            const Entry& entry = entry_at(id);
+            if (entry.hash == hash && std::string_view(entry.data, entry.size) == text) {
+                return id;
+            }
+        }
+    }
+
+    // Writers only (mutex held)
+    static void insert(Index& index, uint32_t id, uint32_t hash) {
+        size_t slot = hash & index.mask;
+        while (index.slots[slot].load(std::memory_order_relaxed) != 0) {
+            slot = (slot + 1) & index.mask;
+        }
+        index.slots[slot].store(id, std::memory_order_release);
+    }
+
+    Index* grow(const Index& old_index) {
+        auto index = std::make_unique<Index>((old_index.mask + 1) * 2);
+        for (size_t slot = 0; slot <= old_index.mask; ++slot) {
+            uint32_t id = old_index.slots[slot].load(std::memory_order_relaxed);
+            if (id != 0) {
+                insert(*index, id, entry_at(id).hash);
+            }
+        }
+        Index* published = index.get();
+        index_.store(published, std::memory_order_release);
+        indexes_.push_back(std::move(index));
+        return published;
+    }
+
+    std::string_view store_text(std::string_view text) {
+        if (text.size() > text_capacity_ - text_used_) {
+            size_t size = std::max(kTextBlockSize, text.size());
+            text_blocks_.push_back(std::make_unique<char[]>(size));
+            text_capacity_ = size;
+            text_used_ = 0;
+        }
+        char* destination = text_blocks_.back().get() + text_used_;
+        std::memcpy(destination, text.data(), text.size());
+        text_used_ += text.size();
+        return {destination, text.size()};
+    }
+
+    uint32_t append_entry(std::string_view text, uint32_t hash) {
+        uint32_t id = static_cast<uint32_t>(next_id_++);
+        auto [chunk, offset] = locate(id);
+        Entry* entries = chunks_[chunk].load(std::memory_order_relaxed);
+        if (!entries) {
+            owned_chunks_.push_back(std::make_unique<Entry[]>(kFirstChunk << chunk));
+            entries = owned_chunks_.back().get();
+            chunks_[chunk].store(entries, std::memory_order_release);
+        }
+        // Published to readers by the release store of the index slot
+        entries[offset] = {text.data(), static_cast<uint32_t>(text.size()), hash};
+        if (id != 0) {
+            size_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return id;
+    }
+
+    std::atomic<Index*> index_{nullptr};
+    std::atomic<Entry*> chunks_[kMaxChunks] = {};
+    std::atomic<size_t> size_{0};
+
+    // Owned storage, touched by writers only
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Index>> indexes_;
+    std::vector<std::unique_ptr<Entry[]>> owned_chunks_;
+    std::vector<std::unique_ptr<char[]>> text_blocks_;
+    size_t text_capacity_ = 0;
+    size_t text_used_ = 0;
+    size_t next_id_ = 0;
+};
+
+inline Symbol Symbol::intern(std::string_view text) {
+    return SymbolTable::global().intern(text);
+}
+
+inline std::optional<Symbol> Symbol::find(std::string_view text) {
+    return SymbolTable::global().find(text);
+}
+
+inline std::string_view Symbol::str() const {
+    return SymbolTable::global().resolve(*this);
+}
@@ -16,6 +16,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <stop_token>
 #include <curl/curl.h>
 #include "HttpClient.h"
 
@@ -43,8 +44,8 @@ private:
     std::vector<std::thread> workers_;
     std::queue<Task> tasks_;
     std::mutex queue_mutex_;
-    std::condition_variable condition_;
-    std::atomic<bool> stop_{false};
+    std::condition_variable_any condition_;
+    std::stop_source stop_source_;
     std::atomic<size_t> active_tasks_{0};
 
     void worker_thread();
@@ -3,6 +3,7 @@
 #include <memory>
 #include <functional>
 #include <optional>
+#include <stop_token>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
 
@@ -14,10 +15,13 @@ public:
     HttpClient();
     ~HttpClient();
 
-    // Synchronous methods
-    std::optional<std::string> get(const std::string& url);
-    std::optional<std::string> post(const std::string& url, const std::string& data);
-    std::optional<nlohmann::json> getJson(const std::string& url);
+    // Synchronous methods; a stop request aborts the transfer within milliseconds
+    std::optional<std::string> get(const std::string& url,
+                                   std::stop_token stop_token = {});
+    std::optional<std::string> post(const std::string& url, const std::string& data,
+                                    std::stop_token stop_token = {});
+    std::optional<nlohmann::json> getJson(const std::string& url,
+                                          std::stop_token stop_token = {});
 
     // Asynchronous methods
     void async_get(const std::string& url, ResponseCallback callback);
@@ -36,6 +40,7 @@ public:
 
 private:
     CURL* curl_;
+    CURLM* multi_;
     int timeout_;
     int retry_count_;
     std::string user_agent_;
@@ -53,8 +58,8 @@ private:
     static size_t header_callback(char* buffer, size_t size, size_t nitems, void* userdata);
 
     // Helper methods
-    void setup_curl_options(CURL* curl);
-    std::optional<std::string> perform_request(CURL* curl);
+    void setup_curl_options();
+    CURLcode perform_request(std::stop_token stop_token);
 
     // Modern C++: disable copying
     HttpClient(const HttpClient&) = delete;
@@ -8,19 +8,25 @@
 #endif //CRAWLPAPER_ARXIVPARSER_H
 #pragma once
 #include "PaperParser.h"
-#include <pugixml.hpp>
+#include "AtomScanner.h"
 
 class ArxivParser : public PaperParser {
 public:
-    std::vector<Paper> parse_papers(const std::string& content) override;
+    std::pmr::vector<Paper> parse_papers(
+            const std::string& content,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) override;
     std::string build_query(const std::vector<std::string>& categories,
                             size_t start_index, size_t max_results) override;
     std::string get_source_name() const override { return "arxiv"; }
 
+    std::vector<std::string_view> split_records(std::string_view content,
+                                                size_t max_chunks) const override;
+    std::pmr::vector<Paper> parse_records(
+            std::string_view chunk,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) override;
+    std::vector<PaperView> parse_views(std::shared_ptr<const std::string> content) override;
+
 private:
-    Paper parse_paper_entry(const pugi::xml_node& entry);
-    std::string parse_arxiv_id(const std::string& id_text);
-    std::string parse_doi(const pugi::xml_node& entry);
-    std::string parse_journal_ref(const pugi::xml_node& entry);
-    std::string parse_comment(const pugi::xml_node& entry);
-};
\ No newline at end of file
+    Paper parse_paper_entry(AtomEntry& entry, Paper::allocator_type alloc);
+    PaperView parse_view_entry(AtomEntryView& entry, TextArena& arena);
+};
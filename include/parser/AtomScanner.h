@@ -0,0 +1,117 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_ATOMSCANNER_H
+#define CRAWLPAPER_ATOMSCANNER_H
+
+#endif //CRAWLPAPER_ATOMSCANNER_H
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Paper.h"
+#include "PaperView.h"
+
+// <author> as scanned; the affiliation is interned when the Paper is built
+struct AtomAuthor {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    std::pmr::string name;
+    std::pmr::string affiliation;
+
+    AtomAuthor() = default;
+    explicit AtomAuthor(allocator_type alloc) : name(alloc), affiliation(alloc) {}
+
+    AtomAuthor(const AtomAuthor&) = default;
+    AtomAuthor(AtomAuthor&&) = default;
+    AtomAuthor& operator=(const AtomAuthor&) = default;
+    AtomAuthor& operator=(AtomAuthor&&) = default;
+
+    AtomAuthor(const AtomAuthor& other, allocator_type alloc) : AtomAuthor(alloc) { *this = other; }
+    AtomAuthor(AtomAuthor&& other, allocator_type alloc) : AtomAuthor(alloc) { *this = std::move(other); }
+};
+
+// Raw fields of one Atom <entry>, as text with XML entities decoded. Fields
+// use the allocator of the Papers built from them, so they can be moved out.
+struct AtomEntry {
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    explicit AtomEntry(allocator_type alloc = {})
+            : id(alloc), title(alloc), summary(alloc), published(alloc), updated(alloc),
+              doi(alloc), doi_link(alloc), journal_ref(alloc), comment(alloc),
+              primary_category(alloc), authors(alloc), categories(alloc) {}
+
+    std::pmr::string id;
+    std::pmr::string title;
+    std::pmr::string summary;
+    std::pmr::string published;
+    std::pmr::string updated;
+    std::pmr::string doi;            // <arxiv:doi>
+    std::pmr::string doi_link;       // href of <link title="doi">
+    std::pmr::string journal_ref;
+    std::pmr::string comment;
+    std::pmr::string primary_category;
+    std::pmr::vector<AtomAuthor> authors;
+    std::pmr::vector<std::pmr::string> categories;
+
+    void clear();
+};
+
+// Same fields as views: into the scanned document where the text is plain,
+// into a TextArena where it had to be decoded
+struct AtomEntryView {
+    std::string_view id;
+    std::string_view title;
+    std::string_view summary;
+    std::string_view published;
+    std::string_view updated;
+    std::string_view doi;
+    std::string_view doi_link;
+    std::string_view journal_ref;
+    std::string_view comment;
+    std::string_view primary_category;
+    std::vector<AuthorView> authors;
+    std::vector<std::string_view> categories;
+
+    void clear();
+};
+
+// Forward-only scanner for arXiv Atom feeds. It walks the document once,
+// extracting only the fields Paper needs; there is no DOM and no XPath.
+// Input is either a complete document (string_view, not copied) or a chunk
+// stream via feed(), in which case only complete entries are returned and
+// consumed bytes are discarded.
+class AtomScanner {
+public:
+    AtomScanner() : streaming_(true) {}
+    explicit AtomScanner(std::string_view document) : input_(document) {}
+
+    // Fills the next complete entry; false when none is available (yet)
+    bool next(AtomEntry& entry);
+
+    // Zero-copy variant: views into the document, or into `arena` for
+    // decoded text. The document must outlive the views.
+    bool next(AtomEntryView& entry, TextArena& arena);
+
+    // Streaming mode only
+    void feed(std::string_view chunk);
+
+    static void append_text(std::string_view raw, std::pmr::string& out);
+
+    // Offset of the next "<entry" start tag at or after `from`, or npos.
+    // Used to split a feed into chunks of whole entries.
+    static size_t find_entry(std::string_view text, size_t from);
+
+private:
+    std::string buffer_;
+    std::string_view input_;
+    size_t pos_ = 0;
+    bool streaming_ = false;
+
+    bool next_entry(std::string_view& body);
+
+    template <typename Entry, typename Store>
+    static void scan_entry(std::string_view body, Entry& entry, Store& store);
+};
@@ -8,15 +8,51 @@
 #endif //CRAWLPAPER_BIORXIVPARSER_H
 #pragma once
 #include "PaperParser.h"
+#include "JsonFields.h"
 
 class BiorxivParser : public PaperParser {
 public:
-    std::vector<Paper> parse_papers(const std::string& content) override;
+    std::pmr::vector<Paper> parse_papers(
+            const std::string& content,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) override;
     std::string build_query(const std::vector<std::string>& categories,
                             size_t start_index, size_t max_results) override;
     std::string get_source_name() const override { return "biorxiv"; }
 
+    std::vector<std::string_view> split_records(std::string_view content,
+                                                size_t max_chunks) const override;
+    std::pmr::vector<Paper> parse_records(
+            std::string_view chunk,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) override;
+
 private:
-    Paper parse_paper_item(const nlohmann::json& item);
-    std::vector<Author> parse_authors(const std::string& authors_str);
-};
\ No newline at end of file
+    // Raw fields of one `collection` item; both JSON backends fill this and
+    // build_paper() turns it into a Paper, so their output cannot diverge.
+    // Allocated like the Paper, so build_paper() moves rather than copies.
+    struct ItemFields {
+        explicit ItemFields(Paper::allocator_type alloc)
+                : doi(alloc), title(alloc), abstract(alloc), authors(alloc),
+                  category(alloc), date(alloc), jatsxml(alloc) {}
+
+        std::pmr::string doi;
+        std::pmr::string title;
+        std::pmr::string abstract;
+        std::pmr::string authors;
+        std::pmr::string category;
+        std::pmr::string date;
+        std::pmr::string jatsxml;
+        int version = 1;
+    };
+
+    // Papers are built with the allocator of the output vector
+    Paper build_paper(ItemFields& fields, Paper::allocator_type alloc);
+    Paper parse_paper_item(const nlohmann::json& item, Paper::allocator_type alloc);
+#ifdef CRAWLER_USE_SIMDJSON
+    void parse_collection(simdjson::ondemand::array collection, std::pmr::vector<Paper>& papers);
+    Paper parse_paper_item(simdjson::ondemand::object item, Paper::allocator_type alloc);
+#else
+    void parse_collection(const nlohmann::json& collection, std::pmr::vector<Paper>& papers);
+#endif
+    std::pmr::vector<Author> parse_authors(std::string_view authors_str,
+                                           Author::allocator_type alloc = {});
+};
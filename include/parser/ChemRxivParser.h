@@ -8,14 +8,52 @@
 #endif //CRAWLPAPER_CHEMRXIVPARSER_H
 #pragma once
 #include "PaperParser.h"
+#include "JsonFields.h"
 
 class ChemRxivParser : public PaperParser {
 public:
-    std::vector<Paper> parse_papers(const std::string& content) override;
+    std::pmr::vector<Paper> parse_papers(
+            const std::string& content,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) override;
     std::string build_query(const std::vector<std::string>& categories,
                             size_t start_index, size_t max_results) override;
     std::string get_source_name() const override { return "chemrxiv"; }
 
+    std::vector<std::string_view> split_records(std::string_view content,
+                                                size_t max_chunks) const override;
+    std::pmr::vector<Paper> parse_records(
+            std::string_view chunk,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) override;
+
 private:
-    Paper parse_paper_item(const nlohmann::json& item);
-};
\ No newline at end of file
+    // Raw fields of one `itemHits[].item`; both JSON backends fill this and
+    // build_paper() turns it into a Paper, so their output cannot diverge.
+    // Allocated like the Paper, so build_paper() moves rather than copies.
+    struct ItemFields {
+        explicit ItemFields(Paper::allocator_type alloc)
+                : id(alloc), title(alloc), doi(alloc), description(alloc), authors(alloc),
+                  categories(alloc), published_date(alloc), updated_date(alloc), pdf_url(alloc) {}
+
+        std::pmr::string id;
+        std::pmr::string title;
+        std::pmr::string doi;
+        std::pmr::string description;
+        std::pmr::vector<Author> authors;
+        std::pmr::vector<Symbol> categories;
+        std::pmr::string published_date;
+        std::pmr::string updated_date;
+        std::pmr::string pdf_url;
+        int version = 1;
+    };
+
+    // Papers are built with the allocator of the output vector
+    Paper build_paper(ItemFields& fields, Paper::allocator_type alloc);
+    Paper parse_paper_item(const nlohmann::json& item, Paper::allocator_type alloc);
+#ifdef CRAWLER_USE_SIMDJSON
+    void parse_hits(simdjson::ondemand::array hits, std::pmr::vector<Paper>& papers);
+    Paper parse_paper_item(simdjson::ondemand::object item, Paper::allocator_type alloc);
+    static Author parse_author(simdjson::ondemand::object author_json, Author::allocator_type alloc);
+#else
+    void parse_hits(const nlohmann::json& hits, std::pmr::vector<Paper>& papers);
+#endif
+};
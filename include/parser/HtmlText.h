@@ -0,0 +1,34 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_HTMLTEXT_H
+#define CRAWLPAPER_HTMLTEXT_H
+
+#endif //CRAWLPAPER_HTMLTEXT_H
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// Entity decoding and HTML-to-text cleanup shared by the parsers
+namespace html_text {
+
+    // Decodes the entity at the start of `text` ("&amp;", "&#x3b1;", ...).
+    // Returns the number of bytes consumed, or 0 if `text` does not start with
+    // a known entity. Covers the full HTML 4 named set plus &apos;.
+    size_t decode_entity(std::string_view text, uint32_t& codepoint);
+
+    // Writes `codepoint` as UTF-8 (1-4 bytes) and returns the byte count
+    size_t encode_utf8(uint32_t codepoint, char* out);
+
+    // Single pass, in place: strips tags and comments, decodes entities,
+    // collapses whitespace runs to one space and trims both ends. Returns
+    // the cleaned length.
+    size_t clean_in_place(char* data, size_t size);
+
+    template <typename Allocator>
+    void clean_in_place(std::basic_string<char, std::char_traits<char>, Allocator>& text) {
+        text.resize(clean_in_place(text.data(), text.size()));
+    }
+}
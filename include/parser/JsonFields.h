@@ -0,0 +1,129 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_JSONFIELDS_H
+#define CRAWLPAPER_JSONFIELDS_H
+
+#endif //CRAWLPAPER_JSONFIELDS_H
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdexcept>
+#include <charconv>
+#include <nlohmann/json.hpp>
+#ifdef CRAWLER_USE_SIMDJSON
+#include <simdjson.h>
+#endif
+
+// Field readers shared by the JSON parsers. The nlohmann and simdjson
+// overloads follow the same rules so both backends build identical papers:
+//   - a missing or null field leaves the default (strings become empty)
+//   - a field of the wrong type throws, which skips the whole item
+//   - integers may also arrive as numeric strings ("version": "2")
+namespace json_fields {
+
+    // Splits the array stored under top-level `key` into at most `max_chunks`
+    // runs of whole, comma-separated elements (brackets excluded). Returns
+    // nothing if the key is missing, the value is not an array, the
+    // document's brackets/strings do not balance, an element is empty
+    // ("[a,,b]", "[a,]") or anything but whitespace follows the document.
+    std::vector<std::string_view> split_array(std::string_view json, std::string_view key,
+                                              size_t max_chunks);
+
+    // "[" + elements + "]", with spare capacity so simdjson can parse it in place
+    std::string wrap_array(std::string_view elements);
+
+    inline int parse_int(std::string_view text) {
+        int value = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size()) {
+            throw std::runtime_error("Invalid integer field: " + std::string(text));
+        }
+        return value;
+    }
+
+    template <typename Allocator>
+    void read(const nlohmann::json& object, const char* key,
+              std::basic_string<char, std::char_traits<char>, Allocator>& out) {
+        auto it = object.find(key);
+        if (it == object.end() || it->is_null()) {
+            out.clear();
+        } else if (it->is_string()) {
+            out = it->get_ref<const std::string&>();
+        } else {
+            throw std::runtime_error(std::string("Field is not a string: ") + key);
+        }
+    }
+
+    inline void read(const nlohmann::json& object, const char* key, int& out) {
+        auto it = object.find(key);
+        if (it == object.end() || it->is_null()) {
+            return;
+        }
+        if (it->is_number()) {
+            out = static_cast<int>(it->get<double>());
+        } else if (it->is_string()) {
+            out = parse_int(it->get_ref<const std::string&>());
+        } else {
+            throw std::runtime_error(std::string("Field is not a number: ") + key);
+        }
+    }
+
+#ifdef CRAWLER_USE_SIMDJSON
+    // Type mismatches only invalidate the current item; anything else means
+    // the document itself is broken and parsing must stop
+    inline void check(simdjson::error_code error) {
+        if (error == simdjson::INCORRECT_TYPE || error == simdjson::NUMBER_ERROR ||
+            error == simdjson::NUMBER_OUT_OF_RANGE) {
+            throw std::runtime_error(simdjson::error_message(error));
+        }
+        if (error) {
+            throw simdjson::simdjson_error(error);
+        }
+    }
+
+    template <typename Allocator>
+    void read(simdjson::ondemand::value value,
+              std::basic_string<char, std::char_traits<char>, Allocator>& out) {
+        simdjson::ondemand::json_type type;
+        check(value.type().get(type));
+        if (type == simdjson::ondemand::json_type::null) {
+            out.clear();
+            return;
+        }
+        std::string_view text;
+        check(value.get_string().get(text));
+        out.assign(text);
+    }
+
+    inline void read(simdjson::ondemand::value value, int& out) {
+        simdjson::ondemand::json_type type;
+        check(value.type().get(type));
+        if (type == simdjson::ondemand::json_type::null) {
+            return;
+        }
+        if (type == simdjson::ondemand::json_type::string) {
+            std::string_view text;
+            check(value.get_string().get(text));
+            out = parse_int(text);
+            return;
+        }
+        double number = 0;
+        check(value.get_double().get(number));
+        out = static_cast<int>(number);
+    }
+
+    // Parses in place when the string already has room for simdjson's
+    // padding, otherwise copies into `storage`
+    inline simdjson::padded_string_view padded_view(const std::string& content,
+                                                    simdjson::padded_string& storage) {
+        if (content.capacity() - content.size() >= simdjson::SIMDJSON_PADDING) {
+            return simdjson::padded_string_view(content.data(), content.size(), content.capacity());
+        }
+        storage = simdjson::padded_string(content);
+        return storage;
+    }
+#endif
+}
@@ -3,18 +3,52 @@
 #include <vector>
 #include <string>
 #include <optional>
+#include <string_view>
+#include <functional>
 #include "Paper.h"
+#include "PaperView.h"
+#include "PaperArena.h"
 
 class PaperParser {
 public:
     virtual ~PaperParser() = default;
 
-    // Pure virtual interface for different preprint servers
-    virtual std::vector<Paper> parse_papers(const std::string& content) = 0;
+    // Pure virtual interface for different preprint servers. The result and
+    // every Paper in it are allocated from `resource`, e.g. a PaperArena region.
+    virtual std::pmr::vector<Paper> parse_papers(
+            const std::string& content,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) = 0;
     virtual std::string build_query(const std::vector<std::string>& categories,
                                     size_t start_index, size_t max_results) = 0;
     virtual std::string get_source_name() const = 0;
 
+    // Zero-copy parsing for pipelines that only store what they parse. Views
+    // point into `content` (kept alive by the views) or into a per-batch
+    // arena. The default parses owning Papers and copies their text into the
+    // arena; parsers override it to reference the response in place.
+    virtual std::vector<PaperView> parse_views(std::shared_ptr<const std::string> content);
+
+    // Intra-document parallelism for very large responses. split_records()
+    // cuts `content` into at most `max_chunks` slices that each hold whole
+    // records (in source order); parse_records() parses one slice and must be
+    // safe to call concurrently. Parsers that cannot split return no slices.
+    virtual std::vector<std::string_view> split_records(std::string_view content,
+                                                        size_t max_chunks) const;
+    virtual std::pmr::vector<Paper> parse_records(
+            std::string_view chunk,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Runs a chunk task, e.g. by posting it to the scheduler's parse pool
+    using TaskExecutor = std::function<void(std::function<void()>)>;
+
+    // parse_papers() for documents of at least `threshold` bytes is split and
+    // parsed on `executor`; the calling thread works on chunks too, so this
+    // is safe to call from a worker of the same pool. Papers keep source order
+    // and live in `arena`, one region per chunk.
+    std::pmr::vector<Paper> parse_papers_parallel(const std::string& content, size_t max_chunks,
+                                                  size_t threshold, const TaskExecutor& executor,
+                                                  PaperArena& arena);
+
     // Common parsing helpers
     static std::string extract_text_between(const std::string& content,
                                             const std::string& start,
@@ -28,6 +62,7 @@ public:
 protected:
     // Common utility methods
     std::string parse_date(const std::string& date_str);
-    std::vector<Author> parse_authors(const std::string& authors_str);
+    std::pmr::vector<Author> parse_authors(const std::string& authors_str,
+                                           Author::allocator_type alloc = {});
     std::vector<std::string> parse_categories(const std::string& categories_str);
 };
\ No newline at end of file
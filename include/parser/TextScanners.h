@@ -0,0 +1,32 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_TEXTSCANNERS_H
+#define CRAWLPAPER_TEXTSCANNERS_H
+
+#endif //CRAWLPAPER_TEXTSCANNERS_H
+#pragma once
+#include <string_view>
+#include <vector>
+#include "Paper.h"
+
+// Hand-written replacements for the per-call std::regex extractors.
+// All scanners work on string_view and only allocate for their output.
+namespace text_scan {
+
+    // Old-style "hep-th/9901001", "math.AG/0301001v3"
+    bool is_old_style_arxiv_id(std::string_view id);
+
+    // Extracts the ID from an abs URL such as "http://arxiv.org/abs/2401.00001v2"
+    // or "http://arxiv.org/abs/hep-th/9901001v1"; any other text is returned as is
+    std::string_view arxiv_id(std::string_view text);
+
+    // Leftmost DOI in `text`: "10." + 4-9 digit registrant + "/" + suffix of
+    // [-._;()/:A-Za-z0-9]. Empty if there is none.
+    std::string_view find_doi(std::string_view text);
+
+    // Splits a comma-separated author list; whitespace after a comma is
+    // dropped and empty names are skipped
+    void split_authors(std::string_view list, std::pmr::vector<Author>& out);
+}
@@ -0,0 +1,36 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_CONSISTENTHASHRING_H
+#define CRAWLPAPER_CONSISTENTHASHRING_H
+
+#endif //CRAWLPAPER_CONSISTENTHASHRING_H
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Maps keys (e.g. source host names) to shard indices. Each shard owns many
+// virtual points on the ring, so adding or removing a shard only moves the
+// keys adjacent to its points.
+class ConsistentHashRing {
+public:
+    explicit ConsistentHashRing(size_t shard_count, size_t virtual_nodes = 64);
+
+    size_t shard_for(const std::string& key) const;
+    size_t shard_count() const { return shard_count_; }
+
+    // Takes a shard out of the ring: only its keys move, to the shards next
+    // to its points. shard_for() is meaningless once the ring is empty.
+    void remove_shard(size_t shard);
+    bool empty() const { return ring_.empty(); }
+
+    // FNV-1a, stable across processes and builds
+    static uint64_t hash(const std::string& key);
+
+private:
+    size_t shard_count_;
+    std::map<uint64_t, size_t> ring_;
+};
@@ -12,6 +12,7 @@
 #include "Scheduler.h"
 #include <coroutine>
 #include <atomic>
+#include <thread>
 
 struct CrawlTask {
     struct promise_type {
@@ -45,5 +46,4 @@ public:
 private:
     std::atomic<size_t> active_coroutines_{0};
     std::atomic<size_t> max_concurrent_;
-    std::atomic<bool> stop_{false};
-};};
\ No newline at end of file
+};
\ No newline at end of file
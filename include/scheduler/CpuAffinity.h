@@ -0,0 +1,43 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_CPUAFFINITY_H
+#define CRAWLPAPER_CPUAFFINITY_H
+
+#endif //CRAWLPAPER_CPUAFFINITY_H
+
+#pragma once
+#include <string>
+#include <vector>
+#include <optional>
+
+enum class PipelineStage {
+    NETWORK,
+    PARSE,
+    STORAGE
+};
+
+// A set of CPUs parsed from "0-3,8,10-11" or "node:1", plus the NUMA node
+// those CPUs belong to (-1 if they span several), so pinned threads can
+// also take their allocations from that node.
+struct CpuPlacement {
+    std::vector<int> cpus;
+    int numa_node = -1;
+
+    static std::optional<CpuPlacement> parse(const std::string& spec);
+};
+
+class CpuAffinity {
+public:
+    // Placement configured for a stage in [crawler] affinity, if any
+    static std::optional<CpuPlacement> placement_for(PipelineStage stage);
+
+    // Pins the calling thread to the stage's CPUs and binds its allocations
+    // to the local NUMA node. A no-op when the stage is not configured.
+    static bool pin_current_thread(PipelineStage stage);
+    static bool pin_current_thread(const CpuPlacement& placement);
+
+    // Worker count for a stage: size of its CPU set, or `fallback`
+    static size_t worker_count(PipelineStage stage, size_t fallback);
+};
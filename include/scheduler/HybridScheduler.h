@@ -0,0 +1,75 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_HYBRIDSCHEDULER_H
+#define CRAWLPAPER_HYBRIDSCHEDULER_H
+
+#endif //CRAWLPAPER_HYBRIDSCHEDULER_H
+
+#pragma once
+#include "Scheduler.h"
+#include "ConsistentHashRing.h"
+#include <vector>
+#include <atomic>
+#include <unistd.h>
+#include <sys/types.h>
+
+// N worker processes, each running an event loop with up to M concurrent
+// transfers on one curl multi handle. Jobs are sharded to workers by a
+// consistent hash of the source host, so per-host rate limiting stays inside
+// a single process. Papers stream back over pipes and are delivered by one
+// thread inside wait_completion() (pinned to the storage CPUs when
+// configured), giving storage a single writer.
+// Neither side blocks on a full pipe: jobs and results queue up and are
+// written as the pipe drains, from the same poll loop that reads.
+class HybridScheduler : public Scheduler {
+public:
+    HybridScheduler(size_t process_count = 4, size_t transfers_per_process = 16);
+    ~HybridScheduler();
+
+    void schedule_crawl(const std::string& source,
+                        const std::vector<std::string>& categories) override;
+    void wait_completion() override;
+    void stop() override;
+    bool is_running() const override;
+
+    size_t get_completed_count() const override;
+    size_t get_failed_count() const override;
+    size_t get_queued_count() const override;
+
+private:
+    struct Worker {
+        pid_t pid = -1;
+        int job_fd = -1;       // parent -> child, one JSON job per line; non-blocking
+        int result_fd = -1;    // child -> parent, one JSON message per line
+        std::string read_buffer;
+        std::string send_buffer;   // jobs the pipe has not taken yet
+        bool closing = false;      // close job_fd once send_buffer is written
+        size_t outstanding = 0;
+    };
+
+    // One per ring shard; a shard whose process is gone is taken out of the
+    // ring, so its hosts move to one other process instead of spreading
+    std::vector<Worker> workers_;
+    ConsistentHashRing ring_;
+    size_t transfers_per_process_;
+    std::atomic<size_t> completed_{0};
+    std::atomic<size_t> failed_{0};
+
+    static std::string shard_key(const std::string& source);
+
+    void spawn_workers(size_t process_count);
+    void retire_worker(size_t shard);
+    // Writes what the job pipe takes without blocking
+    void flush_jobs(Worker& worker);
+    // Closes each job pipe once its queued jobs are written, or at once
+    // dropping them
+    void close_job_pipes(bool discard_queued);
+    bool pump_results(int timeout_ms);
+    void handle_message(Worker& worker, const std::string& line);
+    void reap_workers();
+
+    // Child side
+    [[noreturn]] static void run_worker(int job_fd, int result_fd, size_t max_transfers);
+};
@@ -32,5 +32,4 @@ public:
 private:
     std::vector<pid_t> child_processes_;
     size_t max_processes_;
-    std::atomic<bool> stop_{false};
 };
\ No newline at end of file
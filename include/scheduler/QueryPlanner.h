@@ -0,0 +1,60 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_QUERYPLANNER_H
+#define CRAWLPAPER_QUERYPLANNER_H
+
+#endif //CRAWLPAPER_QUERYPLANNER_H
+
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <string_view>
+#include "Paper.h"
+#include "PaperView.h"
+
+struct PlannedQuery {
+    std::string source;
+    std::vector<std::string> categories;
+};
+
+// Merges the category lists of all keyword groups per source before anything
+// is fetched: duplicates and subsumed categories are dropped ("cond-mat"
+// covers "cond-mat.mtrl-sci", "hep-" covers "hep-th"), and the remaining union
+// is split into balanced OR-queries that fit the server's URL limit. Fetched
+// papers are routed back to every group whose categories match them.
+class QueryPlanner {
+public:
+    static constexpr size_t kDefaultMaxQueryLength = 2000;
+
+    void add_group(const std::string& group, const std::string& source,
+                   const std::vector<std::string>& categories);
+    void set_max_query_length(const std::string& source, size_t max_length);
+
+    std::vector<PlannedQuery> plan() const;
+
+    // Keyword groups that requested this paper, in group-name order
+    std::vector<std::string> route(const Paper& paper) const;
+    std::vector<std::string> route(const PaperView& paper) const;
+
+    static bool subsumes(std::string_view general, std::string_view specific);
+    static std::vector<std::string> normalize(const std::vector<std::string>& categories);
+
+private:
+    struct Group {
+        std::string source;
+        std::vector<std::string> categories;
+    };
+
+    std::map<std::string, Group> groups_;
+    std::map<std::string, size_t> max_query_length_;
+
+    template <typename Categories>
+    std::vector<std::string> route_categories(std::string_view source,
+                                              const Categories& categories) const;
+
+    std::vector<std::vector<std::string>> split(const std::vector<std::string>& categories,
+                                                size_t max_length) const;
+};
@@ -13,11 +13,19 @@
 #include <string>
 #include <functional>
 #include <atomic>
+#include <stop_token>
+#include <optional>
 #include "Paper.h"
+#include "scheduler/QueryPlanner.h"
+
+class PaperParser;
+class DedupIndex;
+enum class CrawlerMode;
 
 class Scheduler {
 public:
     using PaperCallback = std::function<void(const Paper&)>;
+    using ViewCallback = std::function<void(const PaperView&)>;
     using ProgressCallback = std::function<void(size_t, size_t, const std::string&)>;
     using ErrorCallback = std::function<void(const std::string&, const std::string&)>;
 
@@ -37,20 +45,65 @@ public:
 
     // Callback setters
     void set_paper_callback(PaperCallback callback) { paper_callback_ = callback; }
+    // Consumers that only serialize papers take views: when no paper
+    // callback is set, responses are parsed without copying their text
+    void set_view_callback(ViewCallback callback) { view_callback_ = callback; }
     void set_progress_callback(ProgressCallback callback) { progress_callback_ = callback; }
     void set_error_callback(ErrorCallback callback) { error_callback_ = callback; }
 
-    // Factory method
+    // Papers are tagged with the keyword groups the planner routes them to
+    void set_query_planner(std::shared_ptr<const QueryPlanner> planner) { query_planner_ = planner; }
+    // Papers the index already holds (same or later version) are not
+    // delivered; recording them is left to storage
+    void set_dedup_index(std::shared_ptr<const DedupIndex> index) { dedup_index_ = index; }
+    size_t get_duplicate_count() const { return duplicates_skipped_.load(); }
+
+    // Factory methods
     static std::unique_ptr<Scheduler> create(const std::string& mode);
+    static std::unique_ptr<Scheduler> create(CrawlerMode mode);
+
+    // Full request URL for one page of a crawl job
+    static std::string build_crawl_url(PaperParser& parser, const std::string& source,
+                                       const std::vector<std::string>& categories,
+                                       size_t start_index = 0, size_t max_results = 100);
 
 protected:
     PaperCallback paper_callback_;
+    ViewCallback view_callback_;
     ProgressCallback progress_callback_;
     ErrorCallback error_callback_;
+    std::shared_ptr<const QueryPlanner> query_planner_;
+    std::shared_ptr<const DedupIndex> dedup_index_;
+    std::atomic<size_t> duplicates_skipped_{0};
+
+    // stop() requests cancellation here; every task and HTTP transfer
+    // observes the derived token and aborts promptly.
+    std::stop_source stop_source_;
+
+    // Fetch -> parse -> notify for one crawl job. A transfer aborted by
+    // stop_token yields no papers; a body that was already received is
+    // still parsed and delivered in full.
+    void execute_crawl(const std::string& source,
+                       const std::vector<std::string>& categories,
+                       std::stop_token stop_token);
+
+    // The two halves of execute_crawl, for schedulers that run the network
+    // and parse stages on separate workers
+    std::optional<std::string> fetch_crawl(const std::string& source,
+                                           const std::vector<std::string>& categories,
+                                           std::stop_token stop_token);
+    void deliver_papers(const std::string& source, std::string content);
+
+    // Large responses are split at record boundaries and parsed on the
+    // scheduler's parse pool; schedulers without one parse on the caller
+    virtual size_t parse_parallelism() const { return 1; }
+    virtual void post_parse_task(std::function<void()> task) { task(); }
 
     // Helper methods
+    void route_paper(Paper& paper) const;
+    template <typename PaperT> bool is_duplicate(const PaperT& paper);
     void notify_paper(const Paper& paper);
+    void notify_view(const PaperView& view);
     void notify_progress(size_t completed, size_t total, const std::string& message);
     void notify_error(const std::string& source, const std::string& error);
-};
 };
\ No newline at end of file
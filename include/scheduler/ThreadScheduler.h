@@ -9,6 +9,7 @@
 
 #pragma once
 #include "Scheduler.h"
+#include "CpuAffinity.h"
 #include <vector>
 #include <thread>
 #include <atomic>
@@ -16,6 +17,10 @@
 #include <mutex>
 #include <condition_variable>
 
+// Two-stage pool: network workers fetch responses and hand the bodies to
+// parse workers. Each stage can be pinned to its own CPU set / NUMA node via
+// [crawler] affinity, so parsed paper buffers are allocated where they are
+// consumed.
 class ThreadScheduler : public Scheduler {
 public:
     ThreadScheduler(size_t thread_count = std::thread::hardware_concurrency());
@@ -31,13 +36,25 @@ public:
     size_t get_failed_count() const override;
     size_t get_queued_count() const override;
 
+protected:
+    size_t parse_parallelism() const override { return parse_workers_.size(); }
+    void post_parse_task(std::function<void()> task) override { enqueue(parse_queue_, std::move(task)); }
+
 private:
-    void worker_thread();
-
-    std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
-    std::mutex queue_mutex_;
-    std::condition_variable condition_;
-    std::atomic<bool> stop_{false};
-    std::atomic<size_t> active_tasks_{0};
+    struct StageQueue {
+        std::queue<std::function<void()>> tasks;
+        mutable std::mutex mutex;
+        std::condition_variable_any condition;
+    };
+
+    void worker_thread(StageQueue& queue, PipelineStage stage, std::stop_token stop_token);
+    void enqueue(StageQueue& queue, std::function<void()> task);
+    size_t clear(StageQueue& queue);
+
+    std::vector<std::thread> network_workers_;
+    std::vector<std::thread> parse_workers_;
+    StageQueue network_queue_;
+    StageQueue parse_queue_;
+    std::stop_source parse_stop_;           // requested once the network stage is drained
+    std::atomic<size_t> active_tasks_{0};   // jobs scheduled but not yet parsed
 };
\ No newline at end of file
@@ -0,0 +1,171 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_BINARYSEGMENT_H
+#define CRAWLPAPER_BINARYSEGMENT_H
+
+#endif //CRAWLPAPER_BINARYSEGMENT_H
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "Paper.h"
+#include "PaperView.h"
+#include "storage/JsonlWriter.h"
+#include "storage/SeekableZstd.h"
+
+// "bin" segment file: a sequence of paper_record payloads (see PaperRecord.h)
+// with a per-record checksum and an offset index in the footer.
+//
+//   header   "PAPERBIN", u32 segment version, u32 flags (0)
+//   record   u32 payload size, u32 CRC-32C of the payload, payload
+//   ...
+//   footer   u64 record offset, one per record
+//            u64 footer offset, u64 record count, u32 CRC-32C of the
+//            offsets, u32 reserved, "PAPERIDX"
+//
+// Integers are little-endian. The footer is written by close(); a segment
+// without one (the writer crashed) is still readable by scanning records up
+// to the first one that is torn or fails its checksum.
+//
+// A compressed segment (".bin.zst") is the same byte stream in the zstd
+// seekable format (see SeekableZstd.h). Frames end between records and the
+// footer is a frame of its own, so offsets refer to the decompressed stream
+// and a record is read by inflating just the frame that holds it.
+namespace binary_segment {
+    constexpr std::string_view kMagic = "PAPERBIN";
+    constexpr std::string_view kFooterMagic = "PAPERIDX";
+    constexpr uint32_t kVersion = 1;
+    constexpr size_t kHeaderSize = 16;
+    constexpr size_t kRecordHeaderSize = 8;
+    constexpr size_t kTrailerSize = 32;
+}
+
+class BinarySegmentReader;
+
+// Appends records to one segment. Not thread-safe: DataStorage calls it under
+// the shard's lock. Records are buffered and written with one write() per
+// `buffer_bytes`; with `compression`, per compressed frame instead.
+class BinarySegmentWriter {
+public:
+    explicit BinarySegmentWriter(FsyncPolicy policy = FsyncPolicy::NONE,
+                                 size_t buffer_bytes = 1024 * 1024,
+                                 std::optional<seekable_zstd::Options> compression = std::nullopt);
+    ~BinarySegmentWriter();
+
+    BinarySegmentWriter(const BinarySegmentWriter&) = delete;
+    BinarySegmentWriter& operator=(const BinarySegmentWriter&) = delete;
+
+    // Creates `path`, or reopens an existing segment for appending: its
+    // footer and any torn record at the end are cut off first
+    bool open(const std::string& path);
+    // Writes the buffer and the footer
+    bool close();
+    bool is_open() const { return fd_ >= 0; }
+
+    bool append(std::string_view payload);
+
+    // Writes the buffer out (ending the current frame if compressed); syncs
+    // the file unless the policy is NONE
+    bool flush();
+
+    // Bytes in the file including buffered records, excluding the footer.
+    // When compressed, records of the unfinished frame are not counted.
+    uint64_t size() const { return file_size_ + buffer_.size(); }
+    size_t records() const { return offsets_.size(); }
+
+private:
+    bool write_buffer();
+    // Picks up the frames of an existing compressed segment
+    void resume(const BinarySegmentReader& existing);
+    // Adds segment bytes to the buffer, through the compressor if any
+    void put(std::string_view data);
+    // After each record: ends a full frame, writes a full buffer
+    bool end_record();
+
+    FsyncPolicy policy_;
+    size_t buffer_bytes_;
+    std::unique_ptr<SeekableZstdWriter> compressor_;
+    int fd_ = -1;
+    uint64_t file_size_ = 0;         // bytes already written
+    uint64_t stream_size_ = 0;       // segment bytes before compression
+    std::string buffer_;
+    std::vector<uint64_t> offsets_;  // of every record, for the footer
+};
+
+// Random access to a segment through a read-only mapping. Records are
+// located through the footer index (or a scan if there is none) and only
+// decoded on request; every access checks the record's CRC. Compressed
+// segments are inflated frame by frame as records are requested and the
+// frames are kept until close(), unless the reader is in sequential mode.
+class BinarySegmentReader {
+public:
+    BinarySegmentReader() = default;
+    ~BinarySegmentReader();
+
+    BinarySegmentReader(const BinarySegmentReader&) = delete;
+    BinarySegmentReader& operator=(const BinarySegmentReader&) = delete;
+    BinarySegmentReader(BinarySegmentReader&& other) noexcept;
+    BinarySegmentReader& operator=(BinarySegmentReader&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return data_ != nullptr; }
+
+    size_t size() const { return record_count_; }
+    // False if the segment was not closed cleanly and had to be scanned
+    bool has_footer() const { return index_ != nullptr; }
+    // End of the last intact record, in the decompressed stream
+    uint64_t records_end() const { return records_end_; }
+    // Frames of a compressed segment, else nullptr
+    const SeekableZstdReader* frames() const { return frames_.get(); }
+    uint64_t offset(size_t index) const;
+
+    // Payload of record `index`, or nullopt if it fails its checksum. The
+    // view is valid until close(); in sequential mode, until the next read.
+    std::optional<std::string_view> record(size_t index) const;
+
+    bool read(size_t index, Paper& paper) const;
+    // Text fields point into the mapping (or an inflated frame) and are
+    // valid as long as record()'s view
+    bool read(size_t index, PaperView& paper) const;
+
+    // Every intact record, in order; corrupt ones are skipped
+    std::vector<Paper> read_all();
+
+    // For full scans: hints the kernel to read the whole mapping ahead and,
+    // for a compressed segment, keeps only the last two inflated frames
+    // instead of every frame read. Views are then valid until the next read.
+    void advise_sequential();
+
+private:
+    struct InflatedFrame {
+        size_t index = SIZE_MAX;
+        std::string data;
+    };
+
+    // Segment bytes at `offset`, of which `available` are contiguous and
+    // before `end`; nullptr if `offset` is out of range or its frame corrupt
+    const unsigned char* at(uint64_t offset, uint64_t end, uint64_t& available) const;
+    // at() with the frame kept inflated until close()
+    const unsigned char* pinned_at(uint64_t offset, uint64_t end, uint64_t& available) const;
+    // at() through the two most recently inflated frames
+    const unsigned char* streamed_at(uint64_t offset, uint64_t end, uint64_t& available) const;
+
+    const unsigned char* data_ = nullptr;
+    size_t mapped_size_ = 0;
+    std::unique_ptr<SeekableZstdReader> frames_;
+    uint64_t stream_size_ = 0;              // decompressed size
+    const unsigned char* index_ = nullptr;  // footer offsets, if present
+    std::vector<uint64_t> scanned_;         // offsets found by scanning otherwise
+    size_t record_count_ = 0;
+    uint64_t records_end_ = 0;
+    bool sequential_ = false;
+    mutable InflatedFrame recent_[2];
+    mutable size_t last_used_ = 0;     // slot of recent_ read last
+};
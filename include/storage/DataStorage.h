@@ -11,21 +11,116 @@
 #include <vector>
 #include <memory>
 #include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include <string_view>
 #include <nlohmann/json.hpp>
 #include "Paper.h"
+#include "PaperView.h"
+#include "PaperTable.h"
+#include "storage/JsonlWriter.h"
+#include "storage/BinarySegment.h"
+#include "storage/ParquetWriter.h"
+#include "storage/SeekableZstd.h"
+#include "storage/DedupIndex.h"
+#include "storage/SecondaryIndex.h"
+#include "storage/PaperScan.h"
+
+// How save_paper() picks a writer shard
+enum class ShardBy {
+    THREAD,    // each calling thread sticks to one shard: no lock contention, but
+               // the same paper saved by two threads at once may be written twice
+    PAPER_ID   // hash of the paper id: a paper always lands in the same shard
+};
+
+// "thread" | "id"
+std::optional<ShardBy> parse_shard_by(const std::string& name);
+
+// Compression of jsonl and bin files
+enum class Compression {
+    NONE,
+    ZSTD  // seekable zstd, ".jsonl.zst" / ".bin.zst"; needs -DCRAWLER_USE_ZSTD=ON
+};
+
+// "none" | "zstd"
+std::optional<Compression> parse_compression(const std::string& name);
 
 class DataStorage {
 public:
     DataStorage();
     ~DataStorage();
 
+    // Formats: json (one array per file), jsonl (one paper per line, written
+    // by a background thread), bin (checksummed binary records with an offset
+    // index, see BinarySegment.h), parquet (columnar export, readable once the
+    // file is closed; not loaded back), csv, xml
     bool initialize(const std::string& output_dir, const std::string& format = "json");
+    // Read-only access to an existing data directory, for the load_* methods:
+    // no file is created and save_paper() fails
+    bool open_for_reading(const std::string& data_dir);
+
+    // Set before initialize()
+    void set_max_file_size_mb(size_t max_file_size_mb) { max_file_size_ = max_file_size_mb; }
+    void set_fsync_policy(FsyncPolicy policy, std::chrono::milliseconds interval = std::chrono::seconds(1));
+    // Papers are spread over `shard_count` independent writers, each with its
+    // own lock, file series and buffer. manifest.json in the output directory
+    // lists every file of every shard, so loading sees one dataset.
+    void set_sharding(size_t shard_count, ShardBy shard_by = ShardBy::THREAD);
+    void set_parquet_options(const ParquetWriter::Options& options) { parquet_options_ = options; }
+    // Streams jsonl and bin files through zstd in independent frames of
+    // `frame_bytes` (uncompressed), so readers still reach a record by
+    // inflating one frame. Rotation then counts compressed bytes. Falls back
+    // to NONE in builds without zstd.
+    void set_compression(Compression compression, int level = 3, size_t frame_bytes = 1024 * 1024);
+    // Keeps a DedupIndex in output_dir/index/: save_paper() drops papers
+    // already stored with the same or a later version. Sized for
+    // `expected_papers`; it grows past that, at some cost.
+    void set_dedup(bool enabled, size_t expected_papers = 1000000);
+    // jsonl and bin: posting lists by source, category and published month
+    // in output_dir/index/ (see SecondaryIndex.h), so load_papers(source),
+    // load_papers_by_category() and load_papers_published() read only the
+    // matching records. Files the index does not cover are still scanned.
+    // On by default.
+    void set_secondary_index(bool enabled) { secondary_index_enabled_ = enabled; }
+    // Threads the load_* methods parse files on; 0 = one per core
+    void set_load_threads(size_t threads) { load_threads_ = threads; }
+
+    // The index save_paper() checks, or nullptr without set_dedup(); shared
+    // so producers can skip known papers early
+    std::shared_ptr<DedupIndex> dedup_index() const { return dedup_index_; }
 
-    // Paper storage methods
+    // Blocks until buffered papers are on disk (jsonl) or handed to the OS
+    bool flush();
+
+    // Paper storage methods. save_paper() is thread-safe; a duplicate
+    // dropped by the dedup index counts as saved.
     bool save_paper(const Paper& paper);
+    bool save_paper(const PaperView& paper);
     bool save_papers(const std::vector<Paper>& papers);
     std::vector<Paper> load_papers(const std::string& source = "");
     std::vector<Paper> load_papers_by_category(const std::string& category);
+    // Papers published in [from, to]
+    std::vector<Paper> load_papers_published(std::chrono::system_clock::time_point from,
+                                             std::chrono::system_clock::time_point to);
+    // Columnar load for bulk analytics; rows are appended without keeping a
+    // vector<Paper> of the whole data set alive
+    PaperTable load_table(const std::string& source = "");
+    // Streams the papers that pass `filter`, one file after the other, from
+    // a background thread that reads ahead, so memory does not grow with the
+    // data set. Filters are pushed down: the secondary index picks records,
+    // bin records are tested before they are copied and jsonl lines before
+    // they are parsed. The range must not outlive this DataStorage.
+    PaperScan scan(const ScanFilter& filter = {});
+    // Loads the papers that pass `filter` on set_load_threads() threads,
+    // which parse whole files and ranges of large jsonl and bin files
+    // concurrently. emit is called from those threads, but never twice at
+    // once: in the order of load_papers() if `ordered`, else as ranges are
+    // parsed. Loading stops once emit returns false. False if some range
+    // could not be read.
+    bool load_parallel(const ScanFilter& filter, const PaperScan::Emit& emit, bool ordered = false);
 
     // File management
     bool rotate_file_if_needed();
@@ -34,32 +129,149 @@ public:
     // Statistics
     struct StorageStats {
         size_t total_papers = 0;
-        size_t papers_by_source;
-        size_t papers_by_category;
+        size_t papers_by_source = 0;
+        size_t papers_by_category = 0;
         std::chrono::system_clock::time_point last_updated;
+
+        // Over every file in the manifest
+        uint64_t disk_bytes = 0;
+        // Compression by this DataStorage since initialize()
+        uint64_t uncompressed_bytes = 0;
+        uint64_t compressed_bytes = 0;
+        std::chrono::nanoseconds compression_cpu{0};
+        // Dedup since initialize(): papers dropped, newer versions stored, and
+        // duplicates written by two shards at once (see ShardBy::THREAD)
+        size_t duplicates_dropped = 0;
+        size_t version_upgrades = 0;
+        size_t duplicates_written = 0;
+
+        double bytes_per_paper() const {
+            return total_papers ? static_cast<double>(disk_bytes) / static_cast<double>(total_papers) : 0.0;
+        }
     };
 
     StorageStats get_stats() const;
 
 private:
+    // One writer: a series of files, rotated by size. Guarded by its mutex.
+    struct Shard {
+        size_t index = 0;
+        std::mutex mutex;
+        std::ofstream file;
+        std::unique_ptr<JsonlWriter> jsonl_writer;        // replaces `file` for jsonl
+        std::unique_ptr<BinarySegmentWriter> bin_writer;  // replaces `file` for bin
+        std::unique_ptr<ParquetWriter> parquet_writer;    // replaces `file` for parquet
+        std::string filename;
+        size_t size = 0;
+        size_t papers = 0;         // in the current file
+        size_t files_opened = 0;   // keeps rotated file names unique
+        bool first_record = true;  // in the current file
+        std::string record_buffer; // the record being written, reused across papers
+        uint32_t file_id = 0;      // of the current file, in the secondary index
+        SecondaryIndex::Batch index_batch;  // postings not yet written
+    };
+
+    struct ManifestEntry {
+        std::string file;  // relative to output_dir_
+        size_t shard = 0;
+        size_t papers = 0;
+        uint64_t bytes = 0;
+        bool complete = false;  // false while a writer still appends to it
+    };
+
     std::string output_dir_;
     std::string format_;
-    size_t max_file_size_;
-    mutable std::ofstream current_file_;
-    std::string current_filename_;
-    size_t current_size_ = 0;
+    size_t max_file_size_ = 100;
+    FsyncPolicy fsync_policy_ = FsyncPolicy::NONE;
+    std::chrono::milliseconds fsync_interval_ = std::chrono::seconds(1);
+    size_t shard_count_ = 1;
+    ShardBy shard_by_ = ShardBy::THREAD;
+    ParquetWriter::Options parquet_options_;
+    Compression compression_ = Compression::NONE;
+    seekable_zstd::Options compression_options_;
+    seekable_zstd::Stats compression_stats_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    bool dedup_enabled_ = false;
+    size_t dedup_expected_papers_ = 1000000;
+    std::shared_ptr<DedupIndex> dedup_index_;
+    std::atomic<size_t> duplicates_dropped_{0};
+    std::atomic<size_t> version_upgrades_{0};
+    std::atomic<size_t> duplicates_written_{0};
+
+    bool secondary_index_enabled_ = true;
+    std::unique_ptr<SecondaryIndex> secondary_index_;
+
+    size_t load_threads_ = 0;
+
+    // Lock order: a shard's mutex before manifest_mutex_
+    mutable std::mutex manifest_mutex_;
+    std::vector<ManifestEntry> manifest_;
 
-    std::string generate_filename() const;
-    bool open_new_file();
-    bool close_current_file();
+    Shard& shard_for(std::string_view paper_id);
+    std::string generate_filename(Shard& shard) const;
+    bool open_new_file(Shard& shard);
+    bool close_current_file(Shard& shard);
+    bool rotate_if_needed(Shard& shard);
+    bool is_file_open(const Shard& shard) const;
+    // Compressor settings for this format, if it is compressed
+    std::optional<seekable_zstd::Options> segment_compression();
+    // Opens the dedup index, recording the existing data if it is stale
+    bool open_dedup_index();
+    // Opens the secondary index; a writer re-indexes the data if it is
+    // stale, a reader goes without it
+    bool open_secondary_index(bool read_only);
+    // Adds the postings of every record in a jsonl or bin file
+    void index_data_file(const std::filesystem::path& path, SecondaryIndex::Batch& batch);
+    void write_index_batch(Shard& shard);
 
-    // Format-specific writers
-    bool write_json(const Paper& paper);
-    bool write_csv(const Paper& paper);
-    bool write_xml(const Paper& paper);
+    // Manifest maintenance; files are recorded when opened, flushed and closed
+    void load_manifest();
+    void update_manifest(const Shard& shard, bool complete);
+    bool write_manifest() const;
+    std::vector<std::filesystem::path> data_files() const;
+
+    // Dedup check, then append_record() under the shard lock
+    template <typename PaperT> bool write_record(const PaperT& paper);
+    // Opens or rotates the shard's file as needed and appends one record
+    template <typename PaperT> bool append_record(Shard& shard, const PaperT& paper);
+
+    // Format-specific writers, shared by Paper and PaperView; they append the
+    // formatted record to the shard's record_buffer
+    template <typename PaperT> bool write_json(Shard& shard, const PaperT& paper);
+    template <typename PaperT> bool write_csv(Shard& shard, const PaperT& paper);
+    template <typename PaperT> bool write_xml(Shard& shard, const PaperT& paper);
+
+    // The files a scan reads, and where the index says their matches are
+    struct ScanPlan {
+        ScanFilter filter;
+        std::vector<std::filesystem::path> files;
+        std::vector<std::optional<uint32_t>> file_ids;  // in the secondary index
+        // Candidates in indexed files, when the index narrows the filter
+        std::optional<std::vector<RecordLocation>> locations;
+    };
+    ScanPlan plan_scan(const ScanFilter& filter);
+    // Emits the papers of plan.files[file] that pass the filter and lie in
+    // [begin, end): record numbers in a bin segment, line offsets in a jsonl
+    // stream (whole frames of a .jsonl.zst, by where they start). False once
+    // emit refuses one.
+    bool scan_file(const ScanPlan& plan, size_t file, const PaperScan::Emit& emit,
+                   uint64_t begin = 0, uint64_t end = UINT64_MAX) const;
+    // A unit of work for load_parallel(): one range of one file
+    struct LoadRange {
+        size_t file = 0;
+        uint64_t begin = 0;
+        uint64_t end = UINT64_MAX;
+    };
+    // Ranges of about kLoadRangeBytes each, in file order
+    std::vector<LoadRange> split_load(const ScanPlan& plan) const;
+    std::vector<Paper> collect(const ScanFilter& filter);
 
     // Format-specific readers
+    std::vector<Paper> read_papers_file(const std::filesystem::path& path) const;
     std::vector<Paper> read_json_file(const std::string& filename) const;
+    std::vector<Paper> read_jsonl_file(const std::string& filename) const;
+    std::vector<Paper> read_bin_file(const std::string& filename) const;
     std::vector<Paper> read_csv_file(const std::string& filename) const;
     std::vector<Paper> read_xml_file(const std::string& filename) const;
 };
\ No newline at end of file
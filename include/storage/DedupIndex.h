@@ -0,0 +1,108 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_DEDUPINDEX_H
+#define CRAWLPAPER_DEDUPINDEX_H
+
+#endif //CRAWLPAPER_DEDUPINDEX_H
+#pragma once
+#include <string>
+#include <string_view>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+enum class DedupResult {
+    NEW,            // neither the id nor the DOI was seen before
+    DUPLICATE,      // seen with the same or a later version
+    NEWER_VERSION   // seen, but only with an older version
+};
+
+// Persistent set of the papers a data directory holds, keyed by paper id
+// and by DOI (so the same paper from two sources is caught), each with the
+// highest version seen. arXiv ids carry their version ("2401.01234v2"): the
+// suffix is stripped from the key and taken as the version.
+//
+// Keys are 64-bit hashes in open-addressing tables (linear probing, 16-byte
+// slots) mapped from files; an in-memory Bloom filter per table answers most
+// lookups of unseen keys without touching the mapping. Slots are claimed and
+// versions raised with atomic compare-and-swap, so lookups and inserts from
+// any number of threads take no lock. A table that passes its load limit is
+// not rehashed: a table of twice the size is added and new keys go there,
+// and open() merges them back into one. Adding a table waits for the inserts
+// still running against the previous one; lookups never wait.
+//
+// The file layout (per table, "dedup.<n>.idx"):
+//   header   "PAPERDUP", u32 format version, u32 flags (1 = closed cleanly),
+//            u64 capacity, u64 keys, padding to 64 bytes
+//   slots    capacity x {u64 key hash (0 = empty), u64 encoded version}
+//
+// Two different keys with the same 64-bit hash are taken as one; at 100M
+// keys the chance that any pair collides is about 0.03%.
+class DedupIndex {
+public:
+    struct Options {
+        size_t initial_capacity = 1 << 20;  // slots of the first table, a power of two
+        double max_load = 0.7;              // add a table beyond this fill ratio
+        size_t bloom_bits_per_key = 10;     // ~1% false positives
+    };
+
+    DedupIndex();
+    explicit DedupIndex(Options options);
+    ~DedupIndex();
+
+    DedupIndex(const DedupIndex&) = delete;
+    DedupIndex& operator=(const DedupIndex&) = delete;
+
+    // Opens or creates the index in directory `dir`
+    bool open(const std::string& dir);
+    // Syncs the tables and marks them closed cleanly
+    bool close();
+    bool is_open() const { return table_count_.load(std::memory_order_acquire) > 0; }
+
+    // True if the index may not match the data: it was just created, or its
+    // last writer did not close it (papers it recorded may never have reached
+    // the data files). The owner should clear() it and record the data again.
+    bool needs_rebuild() const { return needs_rebuild_; }
+    // Drops every key. Not thread-safe.
+    bool clear();
+
+    // Records a paper and says whether it should be stored. Thread-safe.
+    DedupResult record(std::string_view id, std::string_view doi, int version);
+    template <typename PaperT>
+    DedupResult record(const PaperT& paper) { return record(paper.id, paper.doi, paper.version); }
+
+    // True if record() would return DUPLICATE; records nothing. Thread-safe.
+    bool contains(std::string_view id, std::string_view doi, int version) const;
+    template <typename PaperT>
+    bool contains(const PaperT& paper) const { return contains(paper.id, paper.doi, paper.version); }
+
+    // Keys (ids and DOIs) held
+    size_t size() const;
+    size_t table_count() const { return table_count_.load(std::memory_order_acquire); }
+
+private:
+    struct Table;
+    static constexpr size_t kMaxTables = 40;
+
+    Table* find(uint64_t key, uint64_t*& value) const;
+    DedupResult record_key(uint64_t key, uint64_t version);
+    bool add_table(size_t full_tables);
+    bool merge_tables();
+    std::string table_path(size_t number) const;
+
+    Options options_;
+    std::string dir_;
+    bool needs_rebuild_ = false;
+    size_t next_number_ = 0;  // of the next table file
+
+    // Newest last; entries below table_count_ never change while open
+    std::array<std::atomic<Table*>, kMaxTables> tables_{};
+    std::array<std::unique_ptr<Table>, kMaxTables> owned_;
+    std::atomic<size_t> table_count_{0};
+    std::mutex grow_mutex_;
+};
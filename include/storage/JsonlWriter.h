@@ -0,0 +1,105 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_JSONLWRITER_H
+#define CRAWLPAPER_JSONLWRITER_H
+
+#endif //CRAWLPAPER_JSONLWRITER_H
+#pragma once
+#include <string>
+#include <string_view>
+#include <optional>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <cstdint>
+#include "storage/SeekableZstd.h"
+
+enum class FsyncPolicy {
+    NONE,      // leave it to the OS
+    BATCH,     // fdatasync after every committed batch
+    INTERVAL   // fdatasync at most once per interval while there is new data
+};
+
+// "none" | "batch" | "interval"
+std::optional<FsyncPolicy> parse_fsync_policy(const std::string& name);
+
+// Appends newline-terminated records to one file from a dedicated thread.
+//
+// Producers copy records into the active segment under a short lock; the
+// writer thread swaps it with the segment it has just written and commits
+// the whole batch with a single write(). A file only ever grows by complete
+// lines, except when the process dies mid-write: open() then cuts the torn
+// last line, so the file stays valid JSON Lines and can be appended to.
+//
+// With `compression` the writer thread compresses batches into seekable zstd
+// frames (see SeekableZstd.h) that end between lines. Lines reach the file
+// once their frame is full, or on flush() and close(); after a crash open()
+// keeps the complete frames.
+class JsonlWriter {
+public:
+    JsonlWriter(FsyncPolicy policy = FsyncPolicy::NONE,
+                std::chrono::milliseconds fsync_interval = std::chrono::seconds(1),
+                size_t segment_bytes = 4 * 1024 * 1024,
+                std::optional<seekable_zstd::Options> compression = std::nullopt);
+    ~JsonlWriter();
+
+    JsonlWriter(const JsonlWriter&) = delete;
+    JsonlWriter& operator=(const JsonlWriter&) = delete;
+
+    // Opens (or creates) `path` for appending and starts the writer thread
+    bool open(const std::string& path);
+    // Writes out everything appended so far, then stops the thread. No
+    // append() may run concurrently with close().
+    bool close();
+    bool is_open() const { return fd_ >= 0; }
+
+    // Queues `record` plus a trailing newline. `record` must not contain a
+    // newline itself. Blocks only while the active segment is full.
+    // Thread-safe; returns false once a write has failed.
+    bool append(std::string_view record);
+
+    // Blocks until every record appended before the call has been written,
+    // then syncs the file unless the policy is NONE
+    bool flush();
+
+    // File size including records still queued; compressed, only the
+    // frames written so far
+    uint64_t size() const;
+    // Offset of the next line in the uncompressed stream, counting what the
+    // file held at open()
+    uint64_t stream_size() const;
+
+private:
+    void writer_loop(std::stop_token stop_token);
+    // Turns a batch of lines into frames in `out`; `end_frame` also ends the
+    // current frame, `finish` adds the seek table
+    bool compress(const std::string& batch, bool end_frame, bool finish, std::string& out);
+    bool commit(const std::string& batch);
+    bool sync();
+
+    FsyncPolicy policy_;
+    std::chrono::milliseconds fsync_interval_;
+    size_t segment_bytes_;
+
+    int fd_ = -1;
+    uint64_t base_size_ = 0;         // file size at open(), after repair
+    uint64_t base_stream_size_ = 0;  // the same, uncompressed
+
+    mutable std::mutex mutex_;
+    std::condition_variable_any work_ready_;   // producers -> writer
+    std::condition_variable_any batch_done_;   // writer -> producers and flush()
+    std::string active_;                       // segment producers append to
+    uint64_t appended_bytes_ = 0;              // total ever appended
+    uint64_t committed_bytes_ = 0;             // total handed to write()
+    uint64_t written_bytes_ = 0;               // file bytes written, compressed
+    bool flush_requested_ = false;             // end the frame even if not full
+    bool failed_ = false;
+
+    std::unique_ptr<SeekableZstdWriter> compressor_;  // used by the writer thread
+
+    std::jthread thread_;
+};
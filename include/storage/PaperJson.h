@@ -0,0 +1,33 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_PAPERJSON_H
+#define CRAWLPAPER_PAPERJSON_H
+
+#endif //CRAWLPAPER_PAPERJSON_H
+#pragma once
+#include <string>
+#include <string_view>
+#include "Paper.h"
+#include "PaperView.h"
+
+// Streaming JSON output for Papers, without building an nlohmann::json tree.
+// Produces the same fields as Paper::to_json (including authors), readable by
+// Paper::from_json.
+namespace paper_json {
+
+    enum class Style {
+        Compact,  // one line, no spaces
+        Pretty    // 4-space indentation, as nlohmann's dump(4)
+    };
+
+    // Appends `paper` as one JSON object to `out` and returns the number of
+    // bytes appended
+    size_t write(const Paper& paper, std::string& out, Style style = Style::Compact);
+    size_t write(const PaperView& paper, std::string& out, Style style = Style::Compact);
+
+    // Appends `text` as a quoted JSON string. Invalid UTF-8 is replaced by
+    // U+FFFD so the output always parses.
+    void write_string(std::string_view text, std::string& out);
+}
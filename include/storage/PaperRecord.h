@@ -0,0 +1,49 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_PAPERRECORD_H
+#define CRAWLPAPER_PAPERRECORD_H
+
+#endif //CRAWLPAPER_PAPERRECORD_H
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include "Paper.h"
+#include "PaperView.h"
+
+// Compact binary encoding of one Paper, the payload of a "bin" segment record
+// (see BinarySegment.h). Layout, all integers little-endian:
+//
+//   u8      record version (kVersion)
+//   string  id, title, abstract, doi, pdf_url, source, journal_ref, comment
+//   i64     published_date, updated_date (seconds since the epoch, UTC)
+//   varint  version (zigzag)
+//   varint  author count, then per author: string name, affiliation, orcid
+//   varint  category count, then the category strings
+//   varint  keyword count, then the keyword strings
+//
+// where a string is a varint byte length followed by the bytes. Symbols are
+// stored as their text: ids are only meaningful inside one process.
+namespace paper_record {
+
+    constexpr uint8_t kVersion = 1;
+
+    // Appends the encoded `paper` to `out` and returns the number of bytes
+    // appended
+    size_t encode(const Paper& paper, std::string& out);
+    size_t encode(const PaperView& paper, std::string& out);
+
+    // Decodes one record. Returns false for a truncated or malformed record
+    // or an unknown record version; `paper` is then left partially filled.
+    bool decode(std::string_view record, Paper& paper);
+
+    // Text fields of `paper` point into `record`, which must outlive it;
+    // keywords are copied
+    bool decode(std::string_view record, PaperView& paper);
+
+    // CRC-32C (Castagnoli) of `data`, continuing from `crc`
+    uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0);
+}
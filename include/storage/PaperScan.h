@@ -0,0 +1,173 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_PAPERSCAN_H
+#define CRAWLPAPER_PAPERSCAN_H
+
+#endif //CRAWLPAPER_PAPERSCAN_H
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+#include "Paper.h"
+#include "PaperView.h"
+
+// Paper fields a scan fills in. id, source, categories, the dates and the
+// version are always filled; the others only if asked for.
+enum class PaperField : uint32_t {
+    TITLE = 1 << 0,
+    ABSTRACT = 1 << 1,
+    AUTHORS = 1 << 2,
+    DOI = 1 << 3,
+    PDF_URL = 1 << 4,
+    JOURNAL_REF = 1 << 5,
+    COMMENT = 1 << 6,
+    KEYWORDS = 1 << 7,
+    ALL = (1 << 8) - 1
+};
+
+constexpr PaperField operator|(PaperField a, PaperField b) {
+    return static_cast<PaperField>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+constexpr bool has_field(PaperField fields, PaperField field) {
+    return (static_cast<uint32_t>(fields) & static_cast<uint32_t>(field)) != 0;
+}
+
+// Which papers a scan yields, and which of their fields. Empty strings and
+// unset dates match anything.
+struct ScanFilter {
+    std::string source;
+    std::string category;
+    std::optional<std::chrono::system_clock::time_point> published_from;
+    std::optional<std::chrono::system_clock::time_point> published_to;  // inclusive
+    PaperField fields = PaperField::ALL;
+
+    // source and category as symbols, so Papers are matched by comparing ids.
+    // Interned rather than looked up: a scan interns the names it decodes, so
+    // a name unknown before the scan may still match.
+    void resolve_symbols() {
+        source_symbol = source.empty() ? std::nullopt : std::optional(Symbol::intern(source));
+        category_symbol = category.empty() ? std::nullopt : std::optional(Symbol::intern(category));
+    }
+
+    template <typename PaperT>
+    bool matches(const PaperT& paper) const {
+        if (!source.empty() && !same(paper.source, source_symbol, source)) {
+            return false;
+        }
+        if (!category.empty()) {
+            bool found = false;
+            for (const auto& value : paper.categories) {
+                found = found || same(value, category_symbol, category);
+            }
+            if (!found) {
+                return false;
+            }
+        }
+        return (!published_from || paper.published_date >= *published_from) &&
+               (!published_to || paper.published_date <= *published_to);
+    }
+
+    // Drops the fields not asked for
+    void project(Paper& paper) const;
+    void project(PaperView& paper) const;
+
+private:
+    std::optional<Symbol> source_symbol;
+    std::optional<Symbol> category_symbol;
+
+    // PaperView fields are text; Paper fields are compared as symbols once
+    // resolve_symbols() has run
+    static bool same(std::string_view value, const std::optional<Symbol>&, std::string_view name) {
+        return value == name;
+    }
+    static bool same(Symbol value, const std::optional<Symbol>& symbol, std::string_view name) {
+        return symbol ? value == *symbol : value.str() == name;
+    }
+};
+
+// Input range over papers produced on a background thread. The producer
+// hands papers over in batches and runs at most `read_ahead_batches` ahead
+// of the consumer, so memory stays bounded however many papers it yields.
+// Destroying the range stops the producer at its next paper.
+//
+//   for (Paper& paper : storage.scan(filter)) { ... }
+class PaperScan {
+public:
+    // Takes one paper; false once the consumer is gone and the producer
+    // should stop
+    using Emit = std::function<bool(Paper&&)>;
+    using Producer = std::function<void(const Emit&)>;
+
+    explicit PaperScan(Producer producer, size_t batch_papers = 512, size_t read_ahead_batches = 4);
+    ~PaperScan() = default;  // stops and joins the producer
+
+    PaperScan(PaperScan&&) noexcept = default;
+    PaperScan& operator=(PaperScan&&) noexcept = default;
+
+private:
+    struct State;
+
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Paper;
+        using difference_type = std::ptrdiff_t;
+        using reference = Paper&;
+        using pointer = Paper*;
+
+        iterator() = default;
+
+        // Papers may be moved out
+        Paper& operator*() const { return state_->current[index_]; }
+        Paper* operator->() const { return &state_->current[index_]; }
+        iterator& operator++();
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return state_ == nullptr; }
+
+    private:
+        friend class PaperScan;
+        explicit iterator(State* state);
+        void next_batch();
+
+        State* state_ = nullptr;  // null at the end
+        size_t index_ = 0;
+    };
+
+    // Once per scan: the range is single-pass
+    iterator begin() { return iterator(state_.get()); }
+    std::default_sentinel_t end() const { return {}; }
+
+private:
+    // Shared with the producer thread; stays put when the range is moved
+    struct State {
+        std::mutex mutex;
+        std::condition_variable_any batch_ready;  // producer -> consumer
+        std::condition_variable_any batch_taken;  // consumer -> producer
+        std::deque<std::vector<Paper>> batches;
+        bool done = false;
+        std::vector<Paper> current;  // the batch being consumed
+        std::jthread thread;         // last: stopped and joined first
+
+        void produce(std::stop_token stop_token, const Producer& producer, size_t batch_papers,
+                     size_t read_ahead_batches);
+        // Next batch into `current`; false at the end
+        bool take_batch();
+    };
+
+    std::unique_ptr<State> state_;
+};
@@ -0,0 +1,91 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_PARQUETWRITER_H
+#define CRAWLPAPER_PARQUETWRITER_H
+
+#endif //CRAWLPAPER_PARQUETWRITER_H
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <optional>
+#include <fstream>
+#include <cstdint>
+#include "Paper.h"
+#include "PaperView.h"
+
+enum class ParquetCodec {
+    UNCOMPRESSED,
+    ZSTD  // needs a build with -DCRAWLER_USE_ZSTD=ON, else written uncompressed
+};
+
+// "none" | "zstd"
+std::optional<ParquetCodec> parse_parquet_codec(const std::string& name);
+
+// Writes Papers as an Apache Parquet file, readable by pyarrow, pandas,
+// Spark, DuckDB and friends. Schema (leaf columns in file order):
+//
+//   id, title, abstract                          string
+//   authors: list<struct<name, affiliation, orcid>>
+//   doi, pdf_url                                 string
+//   source                                       string, dictionary
+//   categories: list<string>                     dictionary
+//   published_date, updated_date                 int64 timestamp (ms, UTC)
+//   journal_ref, comment                         string
+//   version                                      int32
+//   keywords: list<string>                       dictionary
+//
+// Rows are buffered column by column and written as a row group once it
+// reaches `row_group_rows` rows or `row_group_bytes` of encoded values, so
+// memory stays bounded by one row group. Every column chunk carries min/max
+// statistics (omitted for long strings such as titles), which lets readers
+// skip row groups on date ranges, sources and categories. The file is only
+// valid after close() has written the footer.
+class ParquetWriter {
+public:
+    struct Options {
+        size_t row_group_rows = 64 * 1024;
+        size_t row_group_bytes = 64 * 1024 * 1024;
+        ParquetCodec codec = ParquetCodec::ZSTD;
+        // Per-column override, by top-level column name ("abstract", "authors")
+        std::map<std::string, ParquetCodec> column_codecs;
+    };
+
+    ParquetWriter();
+    explicit ParquetWriter(Options options);
+    ~ParquetWriter();
+
+    ParquetWriter(const ParquetWriter&) = delete;
+    ParquetWriter& operator=(const ParquetWriter&) = delete;
+
+    bool open(const std::string& path);
+    // Writes the last row group and the footer
+    bool close();
+    bool is_open() const { return file_.is_open(); }
+
+    bool append(const Paper& paper);
+    bool append(const PaperView& paper);
+
+    // Bytes written so far plus the buffered row group
+    uint64_t size() const;
+    size_t rows() const { return total_rows_; }
+
+private:
+    struct Column;
+
+    template <typename PaperT> bool append_row(const PaperT& paper);
+    bool flush_row_group();
+
+    Options options_;
+    std::ofstream file_;
+    std::vector<std::unique_ptr<Column>> columns_;
+    uint64_t file_offset_ = 0;
+    size_t group_rows_ = 0;
+    size_t total_rows_ = 0;
+    std::string row_groups_;      // serialized RowGroup structs for the footer
+    size_t row_group_count_ = 0;
+};
@@ -0,0 +1,127 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_SECONDARYINDEX_H
+#define CRAWLPAPER_SECONDARYINDEX_H
+
+#endif //CRAWLPAPER_SECONDARYINDEX_H
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <optional>
+#include <chrono>
+#include <mutex>
+#include <cstdint>
+#include "SymbolTable.h"
+
+enum class IndexKind {
+    SOURCE,
+    CATEGORY,
+    MONTH  // of the published date, UTC: "2024-01"
+};
+
+// Where a record lives: the id of its data file (see SecondaryIndex::file_id)
+// and its position there, the record number in a bin segment or the byte
+// offset of its line in a jsonl stream (decompressed, for .jsonl.zst)
+struct RecordLocation {
+    uint32_t file = 0;
+    uint64_t position = 0;
+
+    auto operator<=>(const RecordLocation&) const = default;
+};
+
+// Posting lists from source, category and published month to the records
+// that have them, for loading a slice of the data set without parsing the
+// rest. Writers collect postings in a Batch per shard and append them with
+// write(); readers look up one list per key.
+//
+// The layout (in the index directory):
+//   files.txt              data file names, one per line; line n is file id n
+//   source/<value>.post    little-endian u64 per record: file id << 40 | position
+//   category/<value>.post
+//   month/<YYYY-MM>.post
+//   secondary.json         {"version": 1, "clean": true} once closed cleanly
+//
+// Postings of a file appear in the order its records were written. Values
+// are escaped to file names with %XX for anything but [A-Za-z0-9_.-].
+class SecondaryIndex {
+public:
+    // Postings not yet written, grouped by list. Not thread-safe.
+    class Batch {
+    public:
+        template <typename PaperT>
+        void add(const PaperT& paper, RecordLocation location) {
+            add(IndexKind::SOURCE, text_of(paper.source), location);
+            for (const auto& category : paper.categories) {
+                add(IndexKind::CATEGORY, text_of(category), location);
+            }
+            add(IndexKind::MONTH, month_of(paper.published_date), location);
+        }
+        void add(IndexKind kind, std::string_view value, RecordLocation location);
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        void clear();
+
+    private:
+        friend class SecondaryIndex;
+        static std::string_view text_of(std::string_view text) { return text; }
+        static std::string_view text_of(Symbol symbol) { return symbol.str(); }
+
+        std::unordered_map<std::string, std::string> lists_;  // list path -> encoded postings
+        size_t size_ = 0;
+    };
+
+    SecondaryIndex() = default;
+    ~SecondaryIndex();
+
+    SecondaryIndex(const SecondaryIndex&) = delete;
+    SecondaryIndex& operator=(const SecondaryIndex&) = delete;
+
+    // Opens or creates the index in directory `dir`; read-only opens change
+    // nothing on disk
+    bool open(const std::string& dir, bool read_only = false);
+    // Marks the index closed cleanly
+    bool close();
+    bool is_open() const { return open_; }
+
+    // True if the index may not match the data: it was just created, or its
+    // last writer did not close it. The owner should clear() it and index
+    // the data again; a read-only reader should not use it.
+    bool needs_rebuild() const { return needs_rebuild_; }
+    // Drops every posting and file id
+    bool clear();
+
+    // Id of data file `name` (relative to the data directory), assigned on
+    // first use. Thread-safe.
+    uint32_t file_id(const std::string& name);
+    std::optional<uint32_t> find_file(const std::string& name) const;
+
+    // Appends the batch's postings and empties it. Thread-safe.
+    bool write(Batch& batch);
+
+    // Records with `value`, ordered by file id and position
+    std::vector<RecordLocation> lookup(IndexKind kind, std::string_view value) const;
+    // Records published in the months from `from` to `to`; the first and
+    // last month may hold records outside the range
+    std::vector<RecordLocation> lookup_published(std::chrono::system_clock::time_point from,
+                                                 std::chrono::system_clock::time_point to) const;
+
+    static std::string month_of(std::chrono::system_clock::time_point time);
+
+private:
+    static std::string list_path(IndexKind kind, std::string_view value);
+    void read_list(const std::string& path, std::vector<RecordLocation>& out) const;
+    bool write_state(bool clean) const;
+
+    std::string dir_;
+    bool open_ = false;
+    bool read_only_ = false;
+    bool needs_rebuild_ = false;
+
+    mutable std::mutex mutex_;  // guards files_ and appends to the lists
+    std::unordered_map<std::string, uint32_t> files_;
+};
@@ -0,0 +1,149 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_SEEKABLEZSTD_H
+#define CRAWLPAPER_SEEKABLEZSTD_H
+
+#endif //CRAWLPAPER_SEEKABLEZSTD_H
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <cstdint>
+
+// Storage compression in the zstd seekable format: the stream is cut into
+// independent zstd frames, followed by a skippable frame holding a seek table
+// (compressed and decompressed size of every frame). `zstd -d` reads such a
+// file like any other .zst; readers that know the format decompress only the
+// frames they need. Writers cut frames between records, so a record never
+// spans two frames.
+//
+// Everything here needs a build with -DCRAWLER_USE_ZSTD=ON; otherwise
+// available() is false and all operations fail.
+namespace seekable_zstd {
+    constexpr uint32_t kFrameMagic = 0xFD2FB528;
+    constexpr uint32_t kSkippableMagic = 0x184D2A5E;
+    constexpr uint32_t kSeekTableMagic = 0x8F92EAB1;
+    constexpr size_t kSeekTableFooterSize = 9;
+
+    bool available();
+
+    // True if `data` starts with a zstd frame
+    bool is_compressed(const void* data, size_t size);
+
+    struct FrameEntry {
+        uint32_t compressed_size = 0;
+        uint32_t decompressed_size = 0;
+    };
+
+    // Shared by all writers of a DataStorage
+    struct Stats {
+        std::atomic<uint64_t> input_bytes{0};
+        std::atomic<uint64_t> output_bytes{0};
+        std::atomic<int64_t> cpu_ns{0};
+    };
+
+    struct Options {
+        int level = 3;
+        size_t frame_bytes = 1024 * 1024;  // uncompressed bytes per frame
+        Stats* stats = nullptr;            // optional
+    };
+}
+
+// Turns appended data into frames. Produces bytes for the caller to write;
+// not thread-safe.
+class SeekableZstdWriter {
+public:
+    explicit SeekableZstdWriter(seekable_zstd::Options options);
+    ~SeekableZstdWriter();
+
+    SeekableZstdWriter(const SeekableZstdWriter&) = delete;
+    SeekableZstdWriter& operator=(const SeekableZstdWriter&) = delete;
+
+    // Forgets all frames, for a new file
+    void reset();
+    // Continues a file whose complete frames are `frames`
+    void resume(std::vector<seekable_zstd::FrameEntry> frames);
+
+    // Adds to the current frame; call with whole records only
+    void append(std::string_view data) { pending_.append(data); }
+    bool frame_full() const { return pending_.size() >= options_.frame_bytes; }
+    // Bytes the current frame takes before it is full
+    size_t frame_room() const { return frame_full() ? 0 : options_.frame_bytes - pending_.size(); }
+    size_t pending() const { return pending_.size(); }
+
+    // Compresses the pending data as one frame and appends it to `out`;
+    // nothing is appended if there is no pending data
+    bool end_frame(std::string& out);
+    // Ends the last frame and appends the seek table
+    bool finish(std::string& out);
+
+    // Compressed bytes of all ended frames
+    uint64_t compressed_size() const { return compressed_size_; }
+
+private:
+    seekable_zstd::Options options_;
+    void* context_ = nullptr;  // ZSTD_CCtx
+    std::string pending_;
+    std::vector<seekable_zstd::FrameEntry> frames_;
+    uint64_t compressed_size_ = 0;
+};
+
+// Random access to the decompressed stream of a seekable file held in memory
+// (usually a mapping owned by the caller). Frames are decompressed on first
+// use and kept, so returned views stay valid for the reader's lifetime.
+// Thread-safe.
+class SeekableZstdReader {
+public:
+    SeekableZstdReader() = default;
+    ~SeekableZstdReader();
+
+    SeekableZstdReader(const SeekableZstdReader&) = delete;
+    SeekableZstdReader& operator=(const SeekableZstdReader&) = delete;
+
+    // Uses the seek table if there is a valid one, else walks the frames up
+    // to the first incomplete one (the writer crashed)
+    bool open(const void* data, size_t size);
+
+    size_t frame_count() const { return frame_count_; }
+    bool has_seek_table() const { return has_seek_table_; }
+    // Decompressed size of the whole stream
+    uint64_t size() const;
+    // End of the complete frames in the compressed file
+    uint64_t frames_end() const;
+
+    uint64_t frame_offset(size_t index) const { return frames_[index].decompressed_offset; }
+    uint64_t frame_end(size_t index) const {
+        return frames_[index].decompressed_offset + frames_[index].entry.decompressed_size;
+    }
+    // Frame holding decompressed byte `offset`; frame_count() if beyond the end
+    size_t frame_at(uint64_t offset) const;
+    std::vector<seekable_zstd::FrameEntry> entries(size_t count) const;
+
+    // Decompressed content of frame `index`; empty if the frame is corrupt
+    std::string_view frame(size_t index) const;
+    // The same into `out`, without keeping it: for one pass over a file,
+    // where caching every frame would hold the whole stream
+    bool read_frame(size_t index, std::string& out) const;
+
+private:
+    struct Frame {
+        seekable_zstd::FrameEntry entry;
+        uint64_t compressed_offset = 0;
+        uint64_t decompressed_offset = 0;
+        mutable std::once_flag decompressed;
+        mutable std::unique_ptr<char[]> data;
+        mutable bool valid = false;
+    };
+
+    const unsigned char* data_ = nullptr;
+    std::unique_ptr<Frame[]> frames_;
+    size_t frame_count_ = 0;
+    bool has_seek_table_ = false;
+};
@@ -1,4 +1,5 @@
 #include "config/CrawlerConfig.h"
+#include "scheduler/CpuAffinity.h"
 #include <fstream>
 #include <iostream>
 #include <algorithm>
@@ -35,6 +36,9 @@ bool CrawlerConfig::loadConfig(const std::string& config_path) {
         // 解析监控配置（如果存在）
         parseMonitoringConfig(config);
 
+        // 解析分布式协调配置（如果存在）
+        parseCoordinatorConfig(config);
+
         std::cout << "Configuration loaded successfully from: " << config_path << std::endl;
         return true;
 
@@ -57,6 +61,7 @@ void CrawlerConfig::parseCrawlerConfig(const toml::table& config) {
 
     // 解析其他爬虫参数
     crawler_settings_.max_connections = crawler_tbl["max_connections"].value_or(10);
+    crawler_settings_.worker_processes = crawler_tbl["worker_processes"].value_or(4);
     crawler_settings_.request_timeout = crawler_tbl["request_timeout"].value_or(30);
     crawler_settings_.retry_attempts = crawler_tbl["retry_attempts"].value_or(3);
     crawler_settings_.delay_between_requests =
@@ -64,6 +69,15 @@ void CrawlerConfig::parseCrawlerConfig(const toml::table& config) {
     crawler_settings_.user_agent =
             crawler_tbl["user_agent"].value_or("AcademicCrawler/1.0");
     crawler_settings_.log_level = crawler_tbl["log_level"].value_or("info");
+    crawler_settings_.parallel_parse_threshold_kb =
+            crawler_tbl["parallel_parse_threshold_kb"].value_or(4096);
+
+    // 解析各阶段的CPU/NUMA绑定
+    if (auto affinity_tbl = crawler_tbl["affinity"]; affinity_tbl.is_table()) {
+        crawler_settings_.affinity.network = affinity_tbl["network"].value_or("");
+        crawler_settings_.affinity.parse = affinity_tbl["parse"].value_or("");
+        crawler_settings_.affinity.storage = affinity_tbl["storage"].value_or("");
+    }
 }
 
 void CrawlerConfig::parseStorageConfig(const toml::table& config) {
@@ -77,6 +91,19 @@ void CrawlerConfig::parseStorageConfig(const toml::table& config) {
     storage_settings_.output_format = storage_tbl["output_format"].value_or("json");
     storage_settings_.max_file_size_mb = storage_tbl["max_file_size_mb"].value_or(100);
     storage_settings_.batch_size = storage_tbl["batch_size"].value_or(100);
+    storage_settings_.fsync = storage_tbl["fsync"].value_or("none");
+    storage_settings_.fsync_interval_ms = storage_tbl["fsync_interval_ms"].value_or(1000);
+    storage_settings_.shards = storage_tbl["shards"].value_or(1);
+    storage_settings_.shard_by = storage_tbl["shard_by"].value_or("thread");
+    storage_settings_.parquet_codec = storage_tbl["parquet_codec"].value_or("zstd");
+    storage_settings_.parquet_row_group_rows = storage_tbl["parquet_row_group_rows"].value_or(65536);
+    storage_settings_.compression = storage_tbl["compression"].value_or("none");
+    storage_settings_.compression_level = storage_tbl["compression_level"].value_or(3);
+    storage_settings_.compression_frame_kb = storage_tbl["compression_frame_kb"].value_or(1024);
+    storage_settings_.dedup = storage_tbl["dedup"].value_or(true);
+    storage_settings_.dedup_expected_papers = storage_tbl["dedup_expected_papers"].value_or(1000000);
+    storage_settings_.secondary_index = storage_tbl["secondary_index"].value_or(true);
+    storage_settings_.load_threads = storage_tbl["load_threads"].value_or(0);
 
     // 创建输出目录（如果不存在）
     create_directories(storage_settings_.output_dir);
@@ -116,6 +143,8 @@ void CrawlerConfig::parseArxivConfig(const toml::table& config) {
     arxiv_settings_.max_results = arxiv_tbl["max_results"].value_or(1000);
     arxiv_settings_.update_interval_hours =
             arxiv_tbl["update_interval_hours"].value_or(24);
+    arxiv_settings_.max_query_length =
+            arxiv_tbl["max_query_length"].value_or(2000);
     arxiv_settings_.batch_size = arxiv_tbl["batch_size"].value_or(50);
 }
 
@@ -141,6 +170,8 @@ void CrawlerConfig::parseBiorxivConfig(const toml::table& config) {
     biorxiv_settings_.max_results = biorxiv_tbl["max_results"].value_or(500);
     biorxiv_settings_.update_interval_hours =
             biorxiv_tbl["update_interval_hours"].value_or(24);
+    biorxiv_settings_.max_query_length =
+            biorxiv_tbl["max_query_length"].value_or(2000);
 }
 
 void CrawlerConfig::parseChemRxivConfig(const toml::table& config) {
@@ -166,6 +197,8 @@ void CrawlerConfig::parseChemRxivConfig(const toml::table& config) {
     chemrxiv_settings_.max_results = chemrxiv_tbl["max_results"].value_or(300);
     chemrxiv_settings_.update_interval_hours =
             chemrxiv_tbl["update_interval_hours"].value_or(24);
+    chemrxiv_settings_.max_query_length =
+            chemrxiv_tbl["max_query_length"].value_or(2000);
 }
 
 void CrawlerConfig::parseKeywords(const toml::table& config) {
@@ -216,6 +249,21 @@ void CrawlerConfig::parseMonitoringConfig(const toml::table& config) {
             monitoring_tbl["log_interval_seconds"].value_or(60);
 }
 
+void CrawlerConfig::parseCoordinatorConfig(const toml::table& config) {
+    auto coordinator_tbl = config["coordinator"];
+    if (!coordinator_tbl) {
+        return;
+    }
+
+    coordinator_settings_.host = coordinator_tbl["host"].value_or("127.0.0.1");
+    coordinator_settings_.port = coordinator_tbl["port"].value_or(7700);
+    coordinator_settings_.lease_seconds = coordinator_tbl["lease_seconds"].value_or(60);
+    coordinator_settings_.max_attempts = coordinator_tbl["max_attempts"].value_or(3);
+    coordinator_settings_.pages_per_query = coordinator_tbl["pages_per_query"].value_or(10);
+    coordinator_settings_.page_size = coordinator_tbl["page_size"].value_or(100);
+    coordinator_settings_.node_concurrency = coordinator_tbl["node_concurrency"].value_or(4);
+}
+
 CrawlerMode CrawlerConfig::stringToMode(const std::string& mode_str) {
     if (mode_str == "thread") {
         return CrawlerMode::THREAD;
@@ -223,6 +271,8 @@ CrawlerMode CrawlerConfig::stringToMode(const std::string& mode_str) {
         return CrawlerMode::COROUTINE;
     } else if (mode_str == "process") {
         return CrawlerMode::PROCESS;
+    } else if (mode_str == "hybrid") {
+        return CrawlerMode::HYBRID;
     } else {
         std::cerr << "Unknown crawler mode: " << mode_str
                   << ", using default: thread" << std::endl;
@@ -235,6 +285,7 @@ std::string CrawlerConfig::modeToString(CrawlerMode mode) {
         case CrawlerMode::THREAD: return "thread";
         case CrawlerMode::COROUTINE: return "coroutine";
         case CrawlerMode::PROCESS: return "process";
+        case CrawlerMode::HYBRID: return "hybrid";
         default: return "thread";
     }
 }
@@ -247,11 +298,18 @@ bool CrawlerConfig::saveConfig(const std::string& config_path) {
         config.insert("crawler", toml::table{
                 {"mode", modeToString(crawler_settings_.mode)},
                 {"max_connections", crawler_settings_.max_connections},
+                {"worker_processes", crawler_settings_.worker_processes},
                 {"request_timeout", crawler_settings_.request_timeout},
                 {"retry_attempts", crawler_settings_.retry_attempts},
                 {"delay_between_requests", crawler_settings_.delay_between_requests},
                 {"user_agent", crawler_settings_.user_agent},
-                {"log_level", crawler_settings_.log_level}
+                {"log_level", crawler_settings_.log_level},
+                {"parallel_parse_threshold_kb", crawler_settings_.parallel_parse_threshold_kb},
+                {"affinity", toml::table{
+                        {"network", crawler_settings_.affinity.network},
+                        {"parse", crawler_settings_.affinity.parse},
+                        {"storage", crawler_settings_.affinity.storage}
+                }}
         });
 
         // 保存存储配置
@@ -259,7 +317,20 @@ bool CrawlerConfig::saveConfig(const std::string& config_path) {
                 {"output_dir", storage_settings_.output_dir},
                 {"output_format", storage_settings_.output_format},
                 {"max_file_size_mb", storage_settings_.max_file_size_mb},
-                {"batch_size", storage_settings_.batch_size}
+                {"batch_size", storage_settings_.batch_size},
+                {"fsync", storage_settings_.fsync},
+                {"fsync_interval_ms", storage_settings_.fsync_interval_ms},
+                {"shards", storage_settings_.shards},
+                {"shard_by", storage_settings_.shard_by},
+                {"parquet_codec", storage_settings_.parquet_codec},
+                {"parquet_row_group_rows", storage_settings_.parquet_row_group_rows},
+                {"compression", storage_settings_.compression},
+                {"compression_level", storage_settings_.compression_level},
+                {"compression_frame_kb", storage_settings_.compression_frame_kb},
+                {"dedup", storage_settings_.dedup},
+                {"dedup_expected_papers", storage_settings_.dedup_expected_papers},
+                {"secondary_index", storage_settings_.secondary_index},
+                {"load_threads", storage_settings_.load_threads}
         });
 
         // 保存arXiv配置
@@ -268,6 +339,7 @@ bool CrawlerConfig::saveConfig(const std::string& config_path) {
                 {"categories", arxiv_settings_.categories},
                 {"max_results", arxiv_settings_.max_results},
                 {"update_interval_hours", arxiv_settings_.update_interval_hours},
+                {"max_query_length", arxiv_settings_.max_query_length},
                 {"batch_size", arxiv_settings_.batch_size}
         });
 
@@ -276,7 +348,8 @@ bool CrawlerConfig::saveConfig(const std::string& config_path) {
                 {"base_url", biorxiv_settings_.base_url},
                 {"categories", biorxiv_settings_.categories},
                 {"max_results", biorxiv_settings_.max_results},
-                {"update_interval_hours", biorxiv_settings_.update_interval_hours}
+                {"update_interval_hours", biorxiv_settings_.update_interval_hours},
+                {"max_query_length", biorxiv_settings_.max_query_length}
         });
 
         // 保存ChemRxiv配置
@@ -284,7 +357,8 @@ bool CrawlerConfig::saveConfig(const std::string& config_path) {
                 {"base_url", chemrxiv_settings_.base_url},
                 {"categories", chemrxiv_settings_.categories},
                 {"max_results", chemrxiv_settings_.max_results},
-                {"update_interval_hours", chemrxiv_settings_.update_interval_hours}
+                {"update_interval_hours", chemrxiv_settings_.update_interval_hours},
+                {"max_query_length", chemrxiv_settings_.max_query_length}
         });
 
         // 保存数据库配置
@@ -304,6 +378,17 @@ bool CrawlerConfig::saveConfig(const std::string& config_path) {
                 {"log_interval_seconds", monitoring_settings_.log_interval_seconds}
         });
 
+        // 保存分布式协调配置
+        config.insert("coordinator", toml::table{
+                {"host", coordinator_settings_.host},
+                {"port", coordinator_settings_.port},
+                {"lease_seconds", coordinator_settings_.lease_seconds},
+                {"max_attempts", coordinator_settings_.max_attempts},
+                {"pages_per_query", coordinator_settings_.pages_per_query},
+                {"page_size", coordinator_settings_.page_size},
+                {"node_concurrency", coordinator_settings_.node_concurrency}
+        });
+
         // 保存关键词映射
         toml::table keywords_tbl;
         for (const auto& [key, values] : keywords_) {
@@ -350,6 +435,21 @@ bool CrawlerConfig::validate() const {
         return false;
     }
 
+    if (crawler_settings_.mode == CrawlerMode::HYBRID &&
+        crawler_settings_.worker_processes == 0) {
+        std::cerr << "Validation error: worker_processes must be greater than 0" << std::endl;
+        return false;
+    }
+
+    for (const auto* spec : {&crawler_settings_.affinity.network,
+                             &crawler_settings_.affinity.parse,
+                             &crawler_settings_.affinity.storage}) {
+        if (!spec->empty() && !CpuPlacement::parse(*spec)) {
+            std::cerr << "Validation error: invalid affinity spec: " << *spec << std::endl;
+            return false;
+        }
+    }
+
     if (crawler_settings_.request_timeout <= 0) {
         std::cerr << "Validation error: request_timeout must be positive" << std::endl;
         return false;
@@ -383,17 +483,32 @@ CrawlerConfig CrawlerConfig::getDefaultConfig() {
     // 设置默认爬虫参数
     config.crawler_settings_.mode = CrawlerMode::THREAD;
     config.crawler_settings_.max_connections = 10;
+    config.crawler_settings_.worker_processes = 4;
     config.crawler_settings_.request_timeout = 30;
     config.crawler_settings_.retry_attempts = 3;
     config.crawler_settings_.delay_between_requests = 1.0;
     config.crawler_settings_.user_agent = "AcademicCrawler/1.0";
     config.crawler_settings_.log_level = "info";
+    config.crawler_settings_.parallel_parse_threshold_kb = 4096;
 
     // 设置默认存储参数
     config.storage_settings_.output_dir = "./data";
     config.storage_settings_.output_format = "json";
     config.storage_settings_.max_file_size_mb = 100;
     config.storage_settings_.batch_size = 100;
+    config.storage_settings_.fsync = "none";
+    config.storage_settings_.fsync_interval_ms = 1000;
+    config.storage_settings_.shards = 1;
+    config.storage_settings_.shard_by = "thread";
+    config.storage_settings_.parquet_codec = "zstd";
+    config.storage_settings_.parquet_row_group_rows = 65536;
+    config.storage_settings_.compression = "none";
+    config.storage_settings_.compression_level = 3;
+    config.storage_settings_.compression_frame_kb = 1024;
+    config.storage_settings_.dedup = true;
+    config.storage_settings_.dedup_expected_papers = 1000000;
+    config.storage_settings_.secondary_index = true;
+    config.storage_settings_.load_threads = 0;
 
     // 设置默认API参数
     config.arxiv_settings_.base_url = "https://export.arxiv.org/api/query";
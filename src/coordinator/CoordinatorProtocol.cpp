@@ -0,0 +1,102 @@
+#include "coordinator/CoordinatorProtocol.h"
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+namespace coordinator_protocol {
+
+bool send_line(int fd, const std::string& line) {
+    std::string data = line + "\n";
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool send_pending(int fd, std::string& pending) {
+    size_t sent = 0;
+    while (sent < pending.size()) {
+        ssize_t n = ::send(fd, pending.data() + sent, pending.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    pending.erase(0, sent);
+    return true;
+}
+
+bool LineReader::read_line(std::string& line) {
+    while (!next_line(line)) {
+        if (!fill()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LineReader::fill() {
+    char chunk[4096];
+    while (true) {
+        ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            buffer_.append(chunk, static_cast<size_t>(n));
+            return true;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return false;
+    }
+}
+
+bool LineReader::next_line(std::string& line) {
+    auto newline = buffer_.find('\n');
+    if (newline == std::string::npos) {
+        return false;
+    }
+    line = buffer_.substr(0, newline);
+    buffer_.erase(0, newline + 1);
+    return true;
+}
+
+int connect_to(const std::string& host, uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0) {
+        return -1;
+    }
+
+    int fd = -1;
+    for (addrinfo* addr = result; addr; addr = addr->ai_next) {
+        fd = ::socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+        if (fd < 0) continue;
+        if (::connect(fd, addr->ai_addr, addr->ai_addrlen) == 0) break;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+}
@@ -0,0 +1,282 @@
+#include "coordinator/CrawlCoordinator.h"
+#include <iostream>
+#include <sstream>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+using namespace coordinator_protocol;
+
+CrawlCoordinator::CrawlCoordinator(uint16_t port, std::chrono::milliseconds lease_ttl,
+                                   size_t max_attempts)
+        : port_(port), lease_ttl_(lease_ttl), max_attempts_(max_attempts == 0 ? 1 : max_attempts) {
+}
+
+CrawlCoordinator::~CrawlCoordinator() {
+    stop();
+}
+
+void CrawlCoordinator::add_plan(const std::vector<PlannedQuery>& queries, size_t pages_per_query,
+                                size_t page_size) {
+    for (const auto& query : queries) {
+        for (size_t page = 0; page < pages_per_query; ++page) {
+            WorkItem item;
+            item.source = query.source;
+            item.categories = query.categories;
+            item.start_index = page * page_size;
+            item.max_results = page_size;
+            add_item(std::move(item));
+        }
+    }
+}
+
+void CrawlCoordinator::add_item(WorkItem item) {
+    std::lock_guard lock(state_mutex_);
+    item.id = items_.size();
+    items_.push_back({std::move(item)});
+    pending_.push_back(items_.size() - 1);
+    stats_.total++;
+    stats_.pending++;
+}
+
+bool CrawlCoordinator::start() {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "Coordinator: failed to create socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port_);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 64) != 0) {
+        std::cerr << "Coordinator: failed to listen on port " << port_ << ": "
+                  << std::strerror(errno) << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    // 端口为0时由系统分配，回读实际端口
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    server_thread_ = std::jthread([this](std::stop_token stop_token) { serve(stop_token); });
+    return true;
+}
+
+void CrawlCoordinator::stop() {
+    if (server_thread_.joinable()) {
+        server_thread_.request_stop();
+        server_thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    done_condition_.notify_all();
+}
+
+void CrawlCoordinator::wait_completion() {
+    std::unique_lock lock(state_mutex_);
+    done_condition_.wait(lock, [this] {
+        return finished() || !server_thread_.joinable();
+    });
+}
+
+CrawlCoordinator::Stats CrawlCoordinator::get_stats() const {
+    std::lock_guard lock(state_mutex_);
+    return stats_;
+}
+
+bool CrawlCoordinator::finished() const {
+    return stats_.completed + stats_.failed == stats_.total;
+}
+
+void CrawlCoordinator::serve(std::stop_token stop_token) {
+    std::vector<Connection> connections;
+
+    while (!stop_token.stop_requested()) {
+        std::vector<pollfd> fds;
+        fds.push_back({listen_fd_, POLLIN, 0});
+        for (const auto& connection : connections) {
+            // 有未发出的应答时先等可写，不再读取新请求
+            short events = connection.output.empty() ? POLLIN : POLLOUT;
+            fds.push_back({connection.fd, events, 0});
+        }
+
+        // 超时用于检查租约过期和停止请求
+        int ready = poll(fds.data(), fds.size(), 100);
+        {
+            std::lock_guard lock(state_mutex_);
+            expire_leases();
+        }
+        if (ready <= 0) {
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int client = ::accept(listen_fd_, nullptr, nullptr);
+            if (client >= 0) {
+                connections.emplace_back(client);
+            }
+        }
+
+        for (size_t i = 1; i < fds.size(); ++i) {
+            auto& connection = connections[i - 1];
+            bool alive = true;
+
+            if (fds[i].revents & POLLOUT) {
+                alive = send_pending(connection.fd, connection.output);
+            } else if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                alive = connection.reader.fill();
+                std::string line;
+                while (alive && connection.reader.next_line(line)) {
+                    std::lock_guard lock(state_mutex_);
+                    connection.output += handle_request(line);
+                    connection.output += '\n';
+                    if (finished()) {
+                        done_condition_.notify_all();
+                    }
+                }
+                if (alive) {
+                    alive = send_pending(connection.fd, connection.output);
+                }
+            }
+
+            if (!alive) {
+                // 断开的节点不立即回收租约：节点可能重连，租约到期后自然重新分配
+                ::close(connection.fd);
+                connection.fd = -1;
+            }
+        }
+
+        std::erase_if(connections, [](const Connection& connection) {
+            return connection.fd < 0;
+        });
+    }
+
+    for (const auto& connection : connections) {
+        ::close(connection.fd);
+    }
+}
+
+std::string CrawlCoordinator::handle_request(const std::string& line) {
+    std::istringstream request(line);
+    std::string command;
+    request >> command;
+
+    if (command == "CLAIM") {
+        std::string node_id;
+        request >> node_id;
+
+        if (pending_.empty()) {
+            return finished() ? "DONE" : "WAIT " + std::to_string(lease_ttl_.count() / 4 + 1);
+        }
+
+        size_t index = pending_.front();
+        pending_.pop_front();
+
+        uint64_t lease_id = next_lease_id_++;
+        auto& entry = items_[index];
+        entry.state = ItemState::LEASED;
+        entry.lease_id = lease_id;
+        leases_[lease_id] = {index, node_id, std::chrono::steady_clock::now() + lease_ttl_};
+        stats_.pending--;
+        stats_.leased++;
+
+        return "LEASE " + std::to_string(lease_id) + " " + std::to_string(lease_ttl_.count()) +
+               " " + entry.item.to_json().dump();
+    }
+
+    uint64_t lease_id = 0;
+    request >> lease_id;
+    auto lease = leases_.find(lease_id);
+    if (lease == leases_.end()) {
+        return "LOST";
+    }
+
+    if (command == "HEARTBEAT") {
+        lease->second.expires = std::chrono::steady_clock::now() + lease_ttl_;
+        return "OK";
+    }
+
+    Lease held = lease->second;
+    size_t index = held.item_index;
+    leases_.erase(lease);
+    stats_.leased--;
+
+    if (command == "COMPLETE") {
+        size_t paper_count = 0;
+        request >> paper_count;
+        items_[index].state = ItemState::COMPLETED;
+        items_[index].lease_id = 0;
+        stats_.completed++;
+        stats_.papers += paper_count;
+        return "OK";
+    }
+
+    if (command == "FAIL") {
+        std::string reason;
+        std::getline(request >> std::ws, reason);
+        std::cerr << "Coordinator: item " << index << " failed on node "
+                  << held.node_id << ": " << reason << std::endl;
+        release_item(index, true);
+        return "OK";
+    }
+
+    if (command == "RELEASE") {
+        release_item(index, false);
+        return "OK";
+    }
+
+    // 未知命令：恢复租约记录，避免误释放
+    leases_[lease_id] = held;
+    stats_.leased++;
+    return "ERROR unknown command";
+}
+
+void CrawlCoordinator::expire_leases() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = leases_.begin(); it != leases_.end();) {
+        if (it->second.expires <= now) {
+            size_t index = it->second.item_index;
+            it = leases_.erase(it);
+            stats_.leased--;
+            stats_.reassigned++;
+            release_item(index, true);
+        } else {
+            ++it;
+        }
+    }
+    if (finished()) {
+        done_condition_.notify_all();
+    }
+}
+
+void CrawlCoordinator::release_item(size_t index, bool count_attempt) {
+    auto& entry = items_[index];
+    entry.lease_id = 0;
+    if (count_attempt) {
+        entry.attempts++;
+    }
+
+    if (entry.attempts >= max_attempts_) {
+        entry.state = ItemState::FAILED;
+        stats_.failed++;
+    } else {
+        // 重新分配的任务放到队首，尽快由其它节点接手
+        entry.state = ItemState::PENDING;
+        pending_.push_front(index);
+        stats_.pending++;
+    }
+}
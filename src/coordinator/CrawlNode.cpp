@@ -0,0 +1,189 @@
+#include "coordinator/CrawlNode.h"
+#include "parser/PaperParser.h"
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unistd.h>
+
+using namespace coordinator_protocol;
+
+CrawlNode::CrawlNode(std::string host, uint16_t port, std::string node_id, size_t concurrency, Fetch fetch)
+        : host_(std::move(host)), port_(port), node_id_(std::move(node_id)),
+          concurrency_(concurrency == 0 ? 1 : concurrency), fetch_(std::move(fetch)) {
+}
+
+void CrawlNode::run() {
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < concurrency_; ++i) {
+        workers.emplace_back([this, i] { lease_loop(i); });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void CrawlNode::stop() {
+    stop_source_.request_stop();
+}
+
+void CrawlNode::notify_error(const std::string& source, const std::string& error) {
+    if (error_callback_) {
+        error_callback_(source, error);
+    }
+}
+
+void CrawlNode::lease_loop(size_t worker_index) {
+    auto node_stop = stop_source_.get_token();
+    std::string claimant = node_id_ + "/" + std::to_string(worker_index);
+
+    int fd = connect_to(host_, port_);
+    if (fd < 0) {
+        notify_error("coordinator", "Failed to connect to " + host_ + ":" + std::to_string(port_));
+        return;
+    }
+
+    LineReader reader(fd);
+    std::mutex connection_mutex;
+    std::condition_variable_any idle;
+
+    // 请求-应答在同一连接上串行进行，心跳线程与本线程共用连接
+    auto request = [&](const std::string& line, std::string& reply) {
+        std::lock_guard lock(connection_mutex);
+        return send_line(fd, line) && reader.read_line(reply);
+    };
+
+    while (!node_stop.stop_requested()) {
+        std::string reply;
+        if (!request("CLAIM " + claimant, reply)) {
+            notify_error("coordinator", "Connection to coordinator lost");
+            break;
+        }
+
+        std::istringstream response(reply);
+        std::string command;
+        response >> command;
+
+        if (command == "DONE") {
+            break;
+        }
+        if (command == "WAIT") {
+            long wait_ms = 1000;
+            response >> wait_ms;
+            std::mutex wait_mutex;
+            std::unique_lock lock(wait_mutex);
+            idle.wait_for(lock, node_stop, std::chrono::milliseconds(wait_ms), [] { return false; });
+            continue;
+        }
+        if (command != "LEASE") {
+            notify_error("coordinator", "Unexpected reply: " + reply);
+            break;
+        }
+
+        uint64_t lease_id = 0;
+        long ttl_ms = 0;
+        response >> lease_id >> ttl_ms;
+        std::string item_json;
+        std::getline(response >> std::ws, item_json);
+        WorkItem item;
+        try {
+            item = WorkItem::from_json(nlohmann::json::parse(item_json));
+        } catch (const nlohmann::json::exception& e) {
+            // 租约内容损坏：交还协调器，由其计入失败次数后重新分配
+            notify_error("coordinator", "Malformed lease " + std::to_string(lease_id) + ": " + e.what());
+            std::string fail_reply;
+            if (!request("FAIL " + std::to_string(lease_id) + " malformed work item", fail_reply)) {
+                notify_error("coordinator", "Connection to coordinator lost");
+                break;
+            }
+            continue;
+        }
+
+        // 租约丢失或节点停止都会中断本次抓取
+        std::stop_source lease_stop;
+        std::stop_callback forward_stop(node_stop, [&lease_stop] { lease_stop.request_stop(); });
+        std::atomic<bool> lease_lost{false};
+
+        std::jthread heartbeat([&](std::stop_token heartbeat_stop) {
+            auto interval = std::chrono::milliseconds(std::max<long>(ttl_ms / 3, 10));
+            std::mutex wait_mutex;
+            while (true) {
+                std::unique_lock lock(wait_mutex);
+                if (idle.wait_for(lock, heartbeat_stop, interval, [] { return false; }) ||
+                    heartbeat_stop.stop_requested()) {
+                    return;
+                }
+                lock.unlock();
+
+                std::string heartbeat_reply;
+                if (!request("HEARTBEAT " + std::to_string(lease_id), heartbeat_reply) ||
+                    heartbeat_reply != "OK") {
+                    lease_lost = true;
+                    lease_stop.request_stop();
+                    return;
+                }
+            }
+        });
+
+        // 每个租约的论文分配在自己的arena上，交付后整体释放
+        PaperArena arena;
+        std::pmr::vector<Paper> papers(arena.region(0));
+        std::string failure;
+        try {
+            auto parser = PaperParser::create(item.source);
+            auto content = fetch_(item, lease_stop.get_token());
+            if (content) {
+                papers = parser->parse_papers(*content, papers.get_allocator().resource());
+            } else {
+                failure = "Failed to fetch data from " + item.source;
+            }
+        } catch (const std::exception& e) {
+            failure = e.what();
+        }
+
+        heartbeat.request_stop();
+        heartbeat.join();
+
+        if (lease_lost) {
+            // 租约已被重新分配，丢弃结果以避免重复
+            lost_++;
+            continue;
+        }
+
+        if (node_stop.stop_requested()) {
+            // 节点停止导致的中断不是抓取失败，交还时不计入尝试次数
+            std::string release_reply;
+            request("RELEASE " + std::to_string(lease_id), release_reply);
+            continue;
+        }
+
+        if (!failure.empty()) {
+            std::string fail_reply;
+            request("FAIL " + std::to_string(lease_id) + " " + failure, fail_reply);
+            notify_error(item.source, failure);
+            continue;
+        }
+
+        std::string complete_reply;
+        if (!request("COMPLETE " + std::to_string(lease_id) + " " + std::to_string(papers.size()),
+                     complete_reply) || complete_reply != "OK") {
+            lost_++;
+            continue;
+        }
+
+        // 协调器确认后才交付论文
+        completed_++;
+        for (auto& paper : papers) {
+            if (query_planner_) {
+                auto groups = query_planner_->route(paper);
+                paper.keywords.assign(groups.begin(), groups.end());
+            }
+            if (paper_callback_) {
+                paper_callback_(paper);
+            }
+        }
+    }
+
+    ::close(fd);
+}
@@ -0,0 +1,12 @@
+#include "coordinator/CrawlNode.h"
+#include "network/HttpClient.h"
+#include "parser/PaperParser.h"
+
+// Kept out of CrawlNode.cpp so the lease loop links without the HTTP stack
+std::optional<std::string> CrawlNode::http_fetch(const WorkItem& item, std::stop_token stop_token) {
+    auto parser = PaperParser::create(item.source);
+    HttpClient http_client;
+    auto url = Scheduler::build_crawl_url(*parser, item.source, item.categories,
+                                          item.start_index, item.max_results);
+    return http_client.get(url, stop_token);
+}
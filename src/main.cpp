@@ -4,10 +4,196 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <algorithm>
+#include <unistd.h>
 #include "config/CrawlerConfig.h"
 #include "scheduler/Scheduler.h"
+#include "scheduler/QueryPlanner.h"
+#include "coordinator/CrawlCoordinator.h"
+#include "coordinator/CrawlNode.h"
 #include "storage/DataStorage.h"
 
+// Parquet export settings from [storage]
+static ParquetWriter::Options parquet_options(const CrawlerConfig& config) {
+    const auto& settings = config.getStorageSettings();
+    ParquetWriter::Options options;
+    auto codec = parse_parquet_codec(settings.parquet_codec);
+    if (!codec) {
+        std::cerr << "Unknown [storage] parquet_codec '" << settings.parquet_codec << "', using none" << std::endl;
+    }
+    options.codec = codec.value_or(ParquetCodec::UNCOMPRESSED);
+    options.row_group_rows = std::max<size_t>(settings.parquet_row_group_rows, 1);
+    return options;
+}
+
+// jsonl/bin compression from [storage]
+static void set_compression(const CrawlerConfig& config, DataStorage& storage) {
+    const auto& settings = config.getStorageSettings();
+    auto compression = parse_compression(settings.compression);
+    if (!compression) {
+        std::cerr << "Unknown [storage] compression '" << settings.compression << "', using none" << std::endl;
+    }
+    storage.set_compression(compression.value_or(Compression::NONE), settings.compression_level,
+                            settings.compression_frame_kb * 1024);
+}
+
+// Disk footprint of the data set and what compressing it cost
+static void print_storage_stats(const DataStorage& storage) {
+    auto stats = storage.get_stats();
+    std::cout << "Storage: " << stats.total_papers << " papers, " << stats.disk_bytes << " bytes on disk ("
+              << static_cast<uint64_t>(stats.bytes_per_paper()) << " bytes/paper)" << std::endl;
+    if (stats.uncompressed_bytes > 0) {
+        std::cout << "Compression: " << stats.uncompressed_bytes << " -> " << stats.compressed_bytes
+                  << " bytes, " << std::chrono::duration<double>(stats.compression_cpu).count()
+                  << " s CPU" << std::endl;
+    }
+    if (storage.dedup_index()) {
+        std::cout << "Dedup: " << stats.duplicates_dropped << " duplicates dropped, " << stats.version_upgrades
+                  << " newer versions stored, " << stats.duplicates_written << " duplicates written by concurrent shards, "
+                  << storage.dedup_index()->size() << " keys" << std::endl;
+    }
+}
+
+// Storage configured from [storage]
+static std::unique_ptr<DataStorage> open_storage(const CrawlerConfig& config) {
+    const auto& settings = config.getStorageSettings();
+    auto storage = std::make_unique<DataStorage>();
+    storage->set_max_file_size_mb(settings.max_file_size_mb);
+
+    auto policy = parse_fsync_policy(settings.fsync);
+    if (!policy) {
+        std::cerr << "Unknown [storage] fsync policy '" << settings.fsync << "', using none" << std::endl;
+    }
+    storage->set_fsync_policy(policy.value_or(FsyncPolicy::NONE),
+                              std::chrono::milliseconds(settings.fsync_interval_ms));
+
+    auto shard_by = parse_shard_by(settings.shard_by);
+    if (!shard_by) {
+        std::cerr << "Unknown [storage] shard_by '" << settings.shard_by << "', using thread" << std::endl;
+    }
+    storage->set_sharding(settings.shards, shard_by.value_or(ShardBy::THREAD));
+    storage->set_parquet_options(parquet_options(config));
+    set_compression(config, *storage);
+    storage->set_dedup(settings.dedup, settings.dedup_expected_papers);
+    storage->set_secondary_index(settings.secondary_index);
+    storage->set_load_threads(settings.load_threads);
+
+    if (!storage->initialize(settings.output_dir, settings.output_format)) {
+        throw std::runtime_error("Failed to open storage in " + settings.output_dir);
+    }
+    return storage;
+}
+
+// Merge the keyword groups per source so that overlapping categories are
+// fetched only once
+static std::shared_ptr<QueryPlanner> build_query_planner(const CrawlerConfig& config) {
+    const auto& keywords = config.getKeywords();
+    auto planner = std::make_shared<QueryPlanner>();
+    planner->set_max_query_length("arxiv", config.getArxivSettings().max_query_length);
+    planner->set_max_query_length("biorxiv", config.getBiorxivSettings().max_query_length);
+    planner->set_max_query_length("chemrxiv", config.getChemRxivSettings().max_query_length);
+
+    // arXiv
+    planner->add_group("physics", "arxiv", keywords.at("physics"));
+    planner->add_group("materials", "arxiv", keywords.at("materials"));
+    planner->add_group("chemistry", "arxiv", keywords.at("chemistry"));
+    planner->add_group("electrical_engineering", "arxiv", keywords.at("electrical_engineering"));
+
+    // bioRxiv
+    planner->add_group("biology", "biorxiv", keywords.at("biology"));
+
+    // ChemRxiv
+    planner->add_group("chemistry", "chemrxiv", keywords.at("chemistry"));
+
+    return planner;
+}
+
+// Owns the crawl plan and hands out leases until every page is done
+static int run_coordinator(const CrawlerConfig& config) {
+    const auto& settings = config.getCoordinatorSettings();
+    CrawlCoordinator coordinator(static_cast<uint16_t>(settings.port),
+                                 std::chrono::seconds(settings.lease_seconds),
+                                 settings.max_attempts);
+    coordinator.add_plan(build_query_planner(config)->plan(),
+                         settings.pages_per_query, settings.page_size);
+
+    if (!coordinator.start()) {
+        return 1;
+    }
+    std::cout << "Coordinator listening on port " << coordinator.port() << std::endl;
+
+    coordinator.wait_completion();
+    auto stats = coordinator.get_stats();
+    std::cout << "Crawl plan finished: " << stats.completed << " completed, "
+              << stats.failed << " failed, " << stats.reassigned << " reassigned, "
+              << stats.papers << " papers" << std::endl;
+    return stats.failed == 0 ? 0 : 1;
+}
+
+// Claims leases from the coordinator and stores what it fetches locally
+static int run_node(const CrawlerConfig& config, std::string node_id) {
+    const auto& settings = config.getCoordinatorSettings();
+    if (node_id.empty()) {
+        char hostname[256] = {};
+        gethostname(hostname, sizeof(hostname) - 1);
+        node_id = std::string(hostname) + ":" + std::to_string(getpid());
+    }
+
+    auto storage = open_storage(config);
+    CrawlNode node(settings.host, static_cast<uint16_t>(settings.port), node_id,
+                   settings.node_concurrency);
+    node.set_query_planner(build_query_planner(config));
+    node.set_paper_callback([&storage](const Paper& paper) {
+        storage->save_paper(paper);
+    });
+    node.set_error_callback([](const std::string& source, const std::string& error) {
+        std::cerr << "[" << source << "] " << error << std::endl;
+    });
+
+    node.run();
+    std::cout << "Node " << node_id << " finished: " << node.get_completed_count()
+              << " leases completed, " << node.get_lost_count() << " lost" << std::endl;
+    return 0;
+}
+
+// Rewrites a data directory in another output format, e.g. json <-> bin or
+// json -> parquet
+static int run_convert(const CrawlerConfig& config, const std::string& input_dir,
+                       const std::string& output_dir, const std::string& format) {
+    DataStorage input;
+    input.set_load_threads(config.getStorageSettings().load_threads);
+    if (!input.open_for_reading(input_dir)) {
+        return 1;
+    }
+
+    DataStorage output;
+    output.set_max_file_size_mb(config.getStorageSettings().max_file_size_mb);
+    output.set_parquet_options(parquet_options(config));
+    set_compression(config, output);
+    if (!output.initialize(output_dir, format)) {
+        std::cerr << "Failed to open " << output_dir << " as " << format << std::endl;
+        return 1;
+    }
+
+    // Streamed in load order, so memory does not grow with the corpus
+    size_t converted = 0;
+    bool saved = true;
+    bool loaded = input.load_parallel({}, [&](Paper&& paper) {
+        saved = output.save_paper(paper);
+        converted += saved;
+        return saved;
+    }, true);
+    if (!loaded) {
+        std::cerr << "Some files in " << input_dir << " could not be read" << std::endl;
+    }
+    bool success = loaded && saved && output.flush();
+
+    std::cout << "Converted " << converted << " papers from " << input_dir
+              << " to " << format << " in " << output_dir << std::endl;
+    print_storage_stats(output);
+    return success ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
     try {
         // Load configuration
@@ -17,37 +203,49 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
+        // Distributed roles: --coordinator | --node [node_id]
+        if (argc > 1 && std::string(argv[1]) == "--coordinator") {
+            return run_coordinator(config);
+        }
+        if (argc > 1 && std::string(argv[1]) == "--node") {
+            return run_node(config, argc > 2 ? argv[2] : "");
+        }
+        // --convert <input_dir> <output_dir> <json|jsonl|bin|parquet>
+        if (argc > 1 && std::string(argv[1]) == "--convert") {
+            if (argc < 5) {
+                std::cerr << "Usage: " << argv[0] << " --convert <input_dir> <output_dir> <format>" << std::endl;
+                return 1;
+            }
+            return run_convert(config, argv[2], argv[3], argv[4]);
+        }
+
         // Initialize storage
-        auto storage = std::make_unique<DataStorage>();
+        auto storage = open_storage(config);
 
         // Create scheduler based on configuration
         auto scheduler = Scheduler::create(config.getCrawlerSettings().mode);
 
-        // Set paper processing callback
-        scheduler->set_paper_callback([&storage](const Paper& paper) {
+        // Papers are only written out, so take zero-copy views of each response
+        scheduler->set_view_callback([&storage](const PaperView& paper) {
             storage->save_paper(paper);
         });
 
-        // Schedule crawling tasks for each source
-        const auto& keywords = config.getKeywords();
-
-        // Schedule arXiv crawling
-        scheduler->schedule_crawl("arxiv", keywords.at("physics"));
-        scheduler->schedule_crawl("arxiv", keywords.at("materials"));
-        scheduler->schedule_crawl("arxiv", keywords.at("chemistry"));
-
-        // Schedule bioRxiv crawling
-        scheduler->schedule_crawl("biorxiv", keywords.at("biology"));
-
-        // Schedule ChemRxiv crawling
-        scheduler->schedule_crawl("chemrxiv", keywords.at("chemistry"));
-
-        // Electrical engineering
-        scheduler->schedule_crawl("arxiv", keywords.at("electrical_engineering"));
+        // Plan crawling tasks
+        auto planner = build_query_planner(config);
+        scheduler->set_query_planner(planner);
+        scheduler->set_dedup_index(storage->dedup_index());
+        for (const auto& query : planner->plan()) {
+            scheduler->schedule_crawl(query.source, query.categories);
+        }
 
         // Wait for completion
         scheduler->wait_completion();
+        storage->flush();
         std::cout << "Crawling completed successfully!" << std::endl;
+        if (scheduler->get_duplicate_count() > 0) {
+            std::cout << "Skipped " << scheduler->get_duplicate_count() << " papers already stored" << std::endl;
+        }
+        print_storage_stats(*storage);
 
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -55,4 +253,4 @@ int main(int argc, char* argv[]) {
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -1,9 +1,10 @@
 #include "network/AsyncHttpClient.h"
+#include "scheduler/CpuAffinity.h"
 #include <iostream>
 #include <chrono>
 
 AsyncHttpClient::AsyncHttpClient(size_t thread_count)
-        : stop_(false), active_tasks_(0) {
+        : active_tasks_(0) {
 
     // 创建工作线程
     for (size_t i = 0; i < thread_count; ++i) {
@@ -16,16 +17,19 @@ AsyncHttpClient::~AsyncHttpClient() {
 }
 
 void AsyncHttpClient::worker_thread() {
-    while (!stop_.load() || !tasks_.empty()) {
+    auto stop_token = stop_source_.get_token();
+    CpuAffinity::pin_current_thread(PipelineStage::NETWORK);
+
+    while (!stop_token.stop_requested()) {
         Task task;
 
         {
             std::unique_lock lock(queue_mutex_);
-            condition_.wait(lock, [this] {
-                return stop_.load() || !tasks_.empty();
+            condition_.wait(lock, stop_token, [this] {
+                return !tasks_.empty();
             });
 
-            if (stop_.load() && tasks_.empty()) {
+            if (stop_token.stop_requested()) {
                 break;
             }
 
@@ -49,14 +53,17 @@ void AsyncHttpClient::worker_thread() {
 
 void AsyncHttpClient::get(const std::string& url, HttpClient::ResponseCallback callback) {
     add_task([this, url, callback]() {
-        http_client_.async_get(url, callback);
+        auto response = http_client_.get(url, stop_source_.get_token());
+        if (callback) {
+            callback(response.value_or(""), response ? CURLE_OK : CURLE_HTTP_RETURNED_ERROR);
+        }
     });
 }
 
 void AsyncHttpClient::post(const std::string& url, const std::string& data,
                            HttpClient::ResponseCallback callback) {
     add_task([this, url, data, callback]() {
-        auto response = http_client_.post(url, data);
+        auto response = http_client_.post(url, data, stop_source_.get_token());
         if (callback) {
             callback(response.value_or(""), response ? CURLE_OK : CURLE_HTTP_RETURNED_ERROR);
         }
@@ -65,7 +72,7 @@ void AsyncHttpClient::post(const std::string& url, const std::string& data,
 
 void AsyncHttpClient::get_json(const std::string& url, HttpClient::JsonCallback callback) {
     add_task([this, url, callback]() {
-        auto response = http_client_.getJson(url);
+        auto response = http_client_.getJson(url, stop_source_.get_token());
         if (callback) {
             callback(response.value_or(nlohmann::json()), response ? CURLE_OK : CURLE_HTTP_RETURNED_ERROR);
         }
@@ -88,8 +95,13 @@ void AsyncHttpClient::batch_get(const std::vector<std::string>& urls,
         std::vector<std::string> results;
         results.reserve(urls.size());
 
+        auto stop_token = stop_source_.get_token();
         for (const auto& url : urls) {
-            auto response = http_client_.get(url);
+            if (stop_token.stop_requested()) {
+                break;
+            }
+
+            auto response = http_client_.get(url, stop_token);
             results.push_back(response.value_or(""));
 
             // 添加延迟以避免过于频繁的请求
@@ -117,8 +129,13 @@ void AsyncHttpClient::wait_completion() {
 }
 
 void AsyncHttpClient::stop() {
-    stop_.store(true);
-    condition_.notify_all();
+    // 中断进行中的传输并丢弃尚未开始的请求
+    stop_source_.request_stop();
+
+    {
+        std::lock_guard lock(queue_mutex_);
+        std::queue<Task>().swap(tasks_);
+    }
 
     for (auto& worker : workers_) {
         if (worker.joinable()) {
@@ -3,15 +3,22 @@
 #include <sstream>
 #include <chrono>
 
-HttpClient::HttpClient() {
+HttpClient::HttpClient()
+        : timeout_(30), retry_count_(3), user_agent_("AcademicCrawler/1.0"),
+          headers_(nullptr) {
     curl_global_init(CURL_GLOBAL_DEFAULT);
     curl_ = curl_easy_init();
+    multi_ = curl_multi_init();
     if (curl_) {
         setup_curl_options();
     }
 }
 
 HttpClient::~HttpClient() {
+    clear_headers();
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+    }
     if (curl_) {
         curl_easy_cleanup(curl_);
     }
@@ -40,7 +47,55 @@ size_t HttpClient::header_callback(char* buffer, size_t size, size_t nitems, voi
     return size * nitems;
 }
 
-std::optional<std::string> HttpClient::get(const std::string& url) {
+CURLcode HttpClient::perform_request(std::stop_token stop_token) {
+    // 设置自定义头部
+    if (headers_) {
+        curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers_);
+    }
+
+    if (!multi_ || !stop_token.stop_possible()) {
+        return curl_easy_perform(curl_);
+    }
+
+    // 通过multi接口驱动单个传输：停止请求会唤醒curl_multi_poll，
+    // 随后把句柄从multi中移除即可中断传输，无需等待request_timeout
+    curl_multi_add_handle(multi_, curl_);
+    std::stop_callback wake_on_stop(stop_token, [this] {
+        curl_multi_wakeup(multi_);
+    });
+
+    CURLcode result = CURLE_OK;
+    int running = 1;
+    while (running) {
+        CURLMcode mc = curl_multi_perform(multi_, &running);
+        if (mc != CURLM_OK) {
+            result = CURLE_FAILED_INIT;
+            break;
+        }
+        if (stop_token.stop_requested()) {
+            result = CURLE_ABORTED_BY_CALLBACK;
+            break;
+        }
+        if (running) {
+            curl_multi_poll(multi_, nullptr, 0, 1000, nullptr);
+        }
+    }
+
+    if (!running) {
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &queued)) {
+            if (msg->msg == CURLMSG_DONE && msg->easy_handle == curl_) {
+                result = msg->data.result;
+            }
+        }
+    }
+
+    curl_multi_remove_handle(multi_, curl_);
+    return result;
+}
+
+std::optional<std::string> HttpClient::get(const std::string& url,
+                                           std::stop_token stop_token) {
     if (!curl_) {
         return std::nullopt;
     }
@@ -50,12 +105,11 @@ std::optional<std::string> HttpClient::get(const std::string& url) {
     curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response_data);
     curl_easy_setopt(curl_, CURLOPT_HTTPGET, 1L);
 
-    // 设置自定义头部
-    if (headers_) {
-        curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers_);
-    }
+    CURLcode res = perform_request(stop_token);
 
-    CURLcode res = curl_easy_perform(curl_);
+    if (res == CURLE_ABORTED_BY_CALLBACK) {
+        return std::nullopt;
+    }
 
     if (res != CURLE_OK) {
         std::cerr << "HTTP GET failed: " << curl_easy_strerror(res) << std::endl;
@@ -73,7 +127,8 @@ std::optional<std::string> HttpClient::get(const std::string& url) {
     return response_data;
 }
 
-std::optional<std::string> HttpClient::post(const std::string& url, const std::string& data) {
+std::optional<std::string> HttpClient::post(const std::string& url, const std::string& data,
+                                            std::stop_token stop_token) {
     if (!curl_) {
         return std::nullopt;
     }
@@ -85,11 +140,11 @@ std::optional<std::string> HttpClient::post(const std::string& url, const std::s
     curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, data.c_str());
     curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, data.size());
 
-    if (headers_) {
-        curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, headers_);
-    }
+    CURLcode res = perform_request(stop_token);
 
-    CURLcode res = curl_easy_perform(curl_);
+    if (res == CURLE_ABORTED_BY_CALLBACK) {
+        return std::nullopt;
+    }
 
     if (res != CURLE_OK) {
         std::cerr << "HTTP POST failed: " << curl_easy_strerror(res) << std::endl;
@@ -107,8 +162,9 @@ std::optional<std::string> HttpClient::post(const std::string& url, const std::s
     return response_data;
 }
 
-std::optional<nlohmann::json> HttpClient::getJson(const std::string& url) {
-    auto response = get(url);
+std::optional<nlohmann::json> HttpClient::getJson(const std::string& url,
+                                                  std::stop_token stop_token) {
+    auto response = get(url, stop_token);
     if (!response) {
         return std::nullopt;
     }
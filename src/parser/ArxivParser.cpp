@@ -1,24 +1,24 @@
 #include "parser/ArxivParser.h"
+#include "parser/TextScanners.h"
+#include "IsoDate.h"
 #include <sstream>
-#include <pugixml.hpp>
 #include <algorithm>
-#include <iomanip>
-#include <ctime>
 
-std::vector<Paper> ArxivParser::parse_papers(const std::string& content) {
-    std::vector<Paper> papers;
-    pugi::xml_document doc;
+std::pmr::vector<Paper> ArxivParser::parse_papers(const std::string& content,
+                                                  std::pmr::memory_resource* resource) {
+    return parse_records(content, resource);
+}
 
-    pugi::xml_parse_result result = doc.load_string(content.c_str());
-    if (!result) {
-        return papers;
-    }
+std::pmr::vector<Paper> ArxivParser::parse_records(std::string_view chunk,
+                                                   std::pmr::memory_resource* resource) {
+    std::pmr::vector<Paper> papers(resource);
 
-    pugi::xpath_node_set entries = doc.select_nodes("//entry");
-    for (pugi::xpath_node node : entries) {
+    // Single forward pass over the feed; no DOM is built
+    AtomScanner scanner(chunk);
+    AtomEntry entry(papers.get_allocator());
+    while (scanner.next(entry)) {
         try {
-            Paper paper = parse_paper_entry(node.node());
-            papers.push_back(std::move(paper));
+            papers.push_back(parse_paper_entry(entry, papers.get_allocator()));
         } catch (const std::exception& e) {
             // Log parsing error but continue with other entries
             continue;
@@ -28,55 +28,126 @@ std::vector<Paper> ArxivParser::parse_papers(const std::string& content) {
     return papers;
 }
 
-Paper ArxivParser::parse_paper_entry(const pugi::xml_node& entry) {
-    Paper paper;
-    paper.source = "arxiv";
+std::vector<PaperView> ArxivParser::parse_views(std::shared_ptr<const std::string> content) {
+    auto buffer = std::make_shared<ViewBuffer>();
+    buffer->response = content;
 
-    // Parse ID
-    paper.id = parse_arxiv_id(entry.child("id").text().as_string());
+    std::vector<PaperView> views;
+    AtomScanner scanner(*content);
+    AtomEntryView entry;
+    while (scanner.next(entry, buffer->arena)) {
+        try {
+            views.push_back(parse_view_entry(entry, buffer->arena));
+        } catch (const std::exception& e) {
+            continue;
+        }
+    }
+
+    // Shared only once parsing is done; the arena is immutable from here on
+    for (auto& view : views) {
+        view.buffer = buffer;
+    }
+    return views;
+}
+
+std::vector<std::string_view> ArxivParser::split_records(std::string_view content,
+                                                        size_t max_chunks) const {
+    std::vector<std::string_view> chunks;
+    size_t begin = AtomScanner::find_entry(content, 0);
+    if (begin == std::string_view::npos || max_chunks == 0) {
+        return chunks;
+    }
+
+    // Cut at the first <entry> past each size target, so every chunk holds
+    // whole entries; the feed header before the first entry carries no papers
+    size_t target = (content.size() - begin) / max_chunks + 1;
+    while (begin < content.size()) {
+        size_t cut = chunks.size() + 1 < max_chunks ?
+                     AtomScanner::find_entry(content, begin + target) : std::string_view::npos;
+        size_t end = cut == std::string_view::npos ? content.size() : cut;
+        chunks.push_back(content.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
 
-    // Parse title
-    paper.title = entry.child("title").text().as_string();
+Paper ArxivParser::parse_paper_entry(AtomEntry& entry, Paper::allocator_type alloc) {
+    static const Symbol kSource = Symbol::intern("arxiv");
 
-    // Parse abstract/summary
-    paper.abstract = entry.child("summary").text().as_string();
+    Paper paper(alloc);
+    paper.source = kSource;
 
-    // Parse authors
-    pugi::xpath_node_set authors = entry.select_nodes("author/name");
-    for (pugi::xpath_node author_node : authors) {
-        Author author;
-        author.name = author_node.node().text().as_string();
-        paper.authors.push_back(author);
+    // Parse ID
+    paper.id = text_scan::arxiv_id(entry.id);
+
+    // Title, abstract and author names are moved out of the scanner's entry,
+    // which shares the paper's allocator
+    paper.title = std::move(entry.title);
+    paper.abstract = std::move(entry.summary);
+    paper.authors.reserve(entry.authors.size());
+    for (auto& scanned : entry.authors) {
+        auto& author = paper.authors.emplace_back();
+        author.name = std::move(scanned.name);
+        author.affiliation = Symbol::intern(scanned.affiliation);
     }
 
-    // Parse DOI
-    paper.doi = parse_doi(entry);
+    // Prefer <arxiv:doi>, fall back to the DOI link
+    if (!entry.doi.empty()) {
+        paper.doi = std::move(entry.doi);
+    } else {
+        paper.doi = text_scan::find_doi(entry.doi_link);
+    }
 
     // Parse categories
-    std::string categories_str = entry.child("arxiv:categories").text().as_string();
-    paper.categories = parse_categories(categories_str);
+    paper.categories.reserve(entry.categories.size());
+    for (const auto& category : entry.categories) {
+        paper.categories.push_back(Symbol::intern(category));
+    }
+    if (paper.categories.empty() && !entry.primary_category.empty()) {
+        paper.categories.push_back(Symbol::intern(entry.primary_category));
+    }
 
     // Parse dates
-    auto parse_arxiv_date = [](const std::string& date_str) {
-        std::tm tm = {};
-        std::istringstream ss(date_str);
-        ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
-        return std::chrono::system_clock::from_time_t(std::mktime(&tm));
-    };
-
-    paper.published_date = parse_arxiv_date(entry.child("published").text().as_string());
-    paper.updated_date = parse_arxiv_date(entry.child("updated").text().as_string());
+    paper.published_date = iso_date::parse(entry.published);
+    paper.updated_date = iso_date::parse(entry.updated);
 
     // Parse journal reference and comment
-    paper.journal_ref = parse_journal_ref(entry);
-    paper.comment = parse_comment(entry);
+    paper.journal_ref = std::move(entry.journal_ref);
+    paper.comment = std::move(entry.comment);
 
     // Construct PDF URL
-    paper.pdf_url = "https://arxiv.org/pdf/" + paper.id + ".pdf";
+    paper.pdf_url.append("https://arxiv.org/pdf/").append(paper.id).append(".pdf");
 
     return paper;
 }
 
+PaperView ArxivParser::parse_view_entry(AtomEntryView& entry, TextArena& arena) {
+    PaperView view;
+    view.source = "arxiv";
+    view.id = text_scan::arxiv_id(entry.id);
+    view.title = entry.title;
+    view.abstract = entry.summary;
+    view.authors = std::move(entry.authors);
+    view.doi = !entry.doi.empty() ? entry.doi : text_scan::find_doi(entry.doi_link);
+
+    view.categories = std::move(entry.categories);
+    if (view.categories.empty() && !entry.primary_category.empty()) {
+        view.categories.push_back(entry.primary_category);
+    }
+
+    view.published_date = iso_date::parse(entry.published);
+    view.updated_date = iso_date::parse(entry.updated);
+    view.journal_ref = entry.journal_ref;
+    view.comment = entry.comment;
+
+    // The only composed field
+    std::string pdf_url = "https://arxiv.org/pdf/";
+    pdf_url.append(view.id).append(".pdf");
+    view.pdf_url = arena.store(pdf_url);
+
+    return view;
+}
+
 std::string ArxivParser::build_query(const std::vector<std::string>& categories,
                                      size_t start_index, size_t max_results) {
     std::stringstream query;
@@ -95,38 +166,3 @@ std::string ArxivParser::build_query(const std::vector<std::string>& categories,
 
     return query.str();
 }
-
-std::string ArxivParser::parse_arxiv_id(const std::string& id_text) {
-    // Extract arXiv ID from full URL
-    std::regex id_regex(R"(arxiv\.org/abs/([^/]+)$)");
-    std::smatch match;
-
-    if (std::regex_search(id_text, match, id_regex) && match.size() > 1) {
-        return match[1];
-    }
-
-    // If no match, return the original text
-    return id_text;
-}
-
-std::string ArxivParser::parse_doi(const pugi::xml_node& entry) {
-    pugi::xpath_node_set links = entry.select_nodes("link[@title='doi']");
-    for (pugi::xpath_node link : links) {
-        std::string href = link.node().attribute("href").as_string();
-        std::regex doi_regex(R"(10\.\d{4,9}/[-._;()/:A-Z0-9]+)", std::regex::icase);
-        std::smatch match;
-
-        if (std::regex_search(href, match, doi_regex)) {
-            return match[0];
-        }
-    }
-    return "";
-}
-
-std::string ArxivParser::parse_journal_ref(const pugi::xml_node& entry) {
-    return entry.child("arxiv:journal_ref").text().as_string();
-}
-
-std::string ArxivParser::parse_comment(const pugi::xml_node& entry) {
-    return entry.child("arxiv:comment").text().as_string();
-}
\ No newline at end of file
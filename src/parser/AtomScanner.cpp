@@ -0,0 +1,311 @@
+#include "parser/AtomScanner.h"
+#include "parser/HtmlText.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+    constexpr std::string_view kEntryOpen = "<entry";
+    constexpr std::string_view kEntryClose = "</entry>";
+
+    bool is_name_end(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '/' || c == '>';
+    }
+
+    // Value of attribute `name` inside a start tag's attribute text
+    std::string_view attribute(std::string_view attrs, std::string_view name) {
+        size_t pos = 0;
+        while ((pos = attrs.find(name, pos)) != std::string_view::npos) {
+            size_t after = pos + name.size();
+            bool starts_word = pos == 0 || attrs[pos - 1] == ' ' || attrs[pos - 1] == '\t' ||
+                               attrs[pos - 1] == '\n' || attrs[pos - 1] == '\r';
+            while (after < attrs.size() && attrs[after] == ' ') ++after;
+            if (starts_word && after + 1 < attrs.size() && attrs[after] == '=') {
+                ++after;
+                while (after < attrs.size() && attrs[after] == ' ') ++after;
+                if (after < attrs.size() && (attrs[after] == '"' || attrs[after] == '\'')) {
+                    char quote = attrs[after];
+                    auto end = attrs.find(quote, after + 1);
+                    if (end != std::string_view::npos) {
+                        return attrs.substr(after + 1, end - after - 1);
+                    }
+                }
+                return {};
+            }
+            pos = after;
+        }
+        return {};
+    }
+
+    // Offset of the "</name" tag that closes an element opened before `from`
+    size_t find_close_tag(std::string_view body, std::string_view name, size_t from) {
+        size_t pos = from;
+        while ((pos = body.find("</", pos)) != std::string_view::npos) {
+            size_t after = pos + 2 + name.size();
+            if (body.substr(pos + 2, name.size()) == name &&
+                after < body.size() && is_name_end(body[after])) {
+                return pos;
+            }
+            pos += 2;
+        }
+        return std::string_view::npos;
+    }
+}
+
+template <typename Entry, typename Store>
+void AtomScanner::scan_entry(std::string_view body, Entry& entry, Store& store) {
+    bool in_author = false;
+    size_t i = 0;
+
+    while ((i = body.find('<', i)) != std::string_view::npos) {
+        if (body.substr(i, 4) == "<!--") {
+            auto end = body.find("-->", i + 4);
+            i = end == std::string_view::npos ? body.size() : end + 3;
+            continue;
+        }
+        if (body.substr(i, 2) == "<?" || body.substr(i, 2) == "<!") {
+            auto end = body.find('>', i);
+            i = end == std::string_view::npos ? body.size() : end + 1;
+            continue;
+        }
+
+        bool closing = i + 1 < body.size() && body[i + 1] == '/';
+        size_t name_begin = i + 1 + (closing ? 1 : 0);
+        size_t name_end = name_begin;
+        while (name_end < body.size() && !is_name_end(body[name_end])) ++name_end;
+        size_t tag_end = body.find('>', name_end);
+        if (tag_end == std::string_view::npos) {
+            break;
+        }
+
+        std::string_view name = body.substr(name_begin, name_end - name_begin);
+        std::string_view attrs = body.substr(name_end, tag_end - name_end);
+        bool self_closing = body[tag_end - 1] == '/';
+        i = tag_end + 1;
+
+        if (closing) {
+            if (name == "author") in_author = false;
+            continue;
+        }
+
+        if (name == "author") {
+            if (!self_closing) {
+                in_author = true;
+                entry.authors.emplace_back();
+            }
+            continue;
+        }
+        if (name == "link") {
+            if (attribute(attrs, "title") == "doi") {
+                store(attribute(attrs, "href"), entry.doi_link);
+            }
+            continue;
+        }
+        if (name == "category") {
+            auto term = attribute(attrs, "term");
+            if (!term.empty()) {
+                store(term, entry.categories.emplace_back());
+            }
+            continue;
+        }
+        if (name == "arxiv:primary_category") {
+            store(attribute(attrs, "term"), entry.primary_category);
+            continue;
+        }
+
+        decltype(&entry.id) target = nullptr;
+        if (in_author) {
+            if (name == "name") target = &entry.authors.back().name;
+            else if (name == "arxiv:affiliation") target = &entry.authors.back().affiliation;
+        } else if (name == "id") target = &entry.id;
+        else if (name == "title") target = &entry.title;
+        else if (name == "summary") target = &entry.summary;
+        else if (name == "published") target = &entry.published;
+        else if (name == "updated") target = &entry.updated;
+        else if (name == "arxiv:doi") target = &entry.doi;
+        else if (name == "arxiv:journal_ref") target = &entry.journal_ref;
+        else if (name == "arxiv:comment") target = &entry.comment;
+
+        if (target && !self_closing) {
+            size_t close = find_close_tag(body, name, i);
+            if (close == std::string_view::npos) {
+                break;
+            }
+            store(body.substr(i, close - i), *target);
+            i = close;
+        }
+    }
+}
+
+void AtomEntryView::clear() {
+    // Keep the vectors' capacity across entries
+    auto reuse_authors = std::move(authors);
+    auto reuse_categories = std::move(categories);
+    *this = AtomEntryView();
+    authors = std::move(reuse_authors);
+    authors.clear();
+    categories = std::move(reuse_categories);
+    categories.clear();
+}
+
+void AtomEntry::clear() {
+    id.clear();
+    title.clear();
+    summary.clear();
+    published.clear();
+    updated.clear();
+    doi.clear();
+    doi_link.clear();
+    journal_ref.clear();
+    comment.clear();
+    primary_category.clear();
+    authors.clear();
+    categories.clear();
+}
+
+void AtomScanner::feed(std::string_view chunk) {
+    // Drop consumed input but keep any partially received entry
+    buffer_.erase(0, pos_);
+    buffer_.append(chunk);
+    input_ = buffer_;
+    pos_ = 0;
+}
+
+bool AtomScanner::next_entry(std::string_view& body) {
+    while (true) {
+        size_t start = input_.find(kEntryOpen, pos_);
+        if (start == std::string_view::npos) {
+            // When streaming, keep a possibly truncated "<entr" prefix for the next chunk
+            if (streaming_ && input_.size() >= kEntryOpen.size()) {
+                pos_ = std::max(pos_, input_.size() - kEntryOpen.size() + 1);
+            } else if (!streaming_) {
+                pos_ = input_.size();
+            }
+            return false;
+        }
+
+        size_t name_end = start + kEntryOpen.size();
+        if (name_end >= input_.size()) {
+            pos_ = start;
+            return false;
+        }
+        if (!is_name_end(input_[name_end])) {
+            // e.g. <entryX>, not the element we want
+            pos_ = name_end;
+            continue;
+        }
+
+        size_t open_end = input_.find('>', name_end);
+        if (open_end == std::string_view::npos) {
+            pos_ = start;
+            return false;
+        }
+        if (input_[open_end - 1] == '/') {
+            pos_ = open_end + 1;
+            continue;
+        }
+
+        size_t close = input_.find(kEntryClose, open_end);
+        if (close == std::string_view::npos) {
+            pos_ = start;
+            return false;
+        }
+
+        body = input_.substr(open_end + 1, close - open_end - 1);
+        pos_ = close + kEntryClose.size();
+        return true;
+    }
+}
+
+bool AtomScanner::next(AtomEntry& entry) {
+    std::string_view body;
+    if (!next_entry(body)) {
+        return false;
+    }
+
+    // Repeated elements (e.g. several affiliations) are joined with "; "
+    auto store = [](std::string_view raw, std::pmr::string& field) {
+        if (!field.empty()) {
+            field.append("; ");
+        }
+        append_text(raw, field);
+    };
+
+    entry.clear();
+    scan_entry(body, entry, store);
+    return true;
+}
+
+bool AtomScanner::next(AtomEntryView& entry, TextArena& arena) {
+    std::string_view body;
+    if (!next_entry(body)) {
+        return false;
+    }
+
+    // Plain text is referenced in place; decoded or joined text goes to the
+    // arena. In streaming mode the buffer is compacted, so everything is copied.
+    thread_local std::pmr::string scratch;
+    auto store = [this, &arena](std::string_view raw, std::string_view& field) {
+        if (!streaming_ && field.empty() && raw.find_first_of("&<") == std::string_view::npos) {
+            field = raw;
+            return;
+        }
+        scratch.assign(field);
+        if (!field.empty()) {
+            scratch.append("; ");
+        }
+        append_text(raw, scratch);
+        field = arena.store(scratch);
+    };
+
+    entry.clear();
+    scan_entry(body, entry, store);
+    return true;
+}
+
+size_t AtomScanner::find_entry(std::string_view text, size_t from) {
+    size_t pos = from;
+    while ((pos = text.find(kEntryOpen, pos)) != std::string_view::npos) {
+        size_t name_end = pos + kEntryOpen.size();
+        if (name_end < text.size() && is_name_end(text[name_end])) {
+            return pos;
+        }
+        pos = name_end;
+    }
+    return std::string_view::npos;
+}
+
+void AtomScanner::append_text(std::string_view raw, std::pmr::string& out) {
+    size_t i = 0;
+    while (i < raw.size()) {
+        size_t special = raw.find_first_of("&<", i);
+        if (special == std::string_view::npos) {
+            out.append(raw.substr(i));
+            return;
+        }
+        out.append(raw.substr(i, special - i));
+        i = special;
+
+        if (raw[i] == '&') {
+            uint32_t codepoint = 0;
+            size_t used = html_text::decode_entity(raw.substr(i), codepoint);
+            if (used == 0) {
+                out.push_back('&');
+                ++i;
+            } else {
+                char buffer[4];
+                out.append(buffer, html_text::encode_utf8(codepoint, buffer));
+                i += used;
+            }
+        } else if (raw.substr(i, 9) == "<![CDATA[") {
+            auto end = raw.find("]]>", i + 9);
+            auto stop = end == std::string_view::npos ? raw.size() : end;
+            out.append(raw.substr(i + 9, stop - i - 9));
+            i = end == std::string_view::npos ? raw.size() : end + 3;
+        } else {
+            // Nested markup inside text: drop the tag, keep its text
+            auto end = raw.find('>', i);
+            i = end == std::string_view::npos ? raw.size() : end + 1;
+        }
+    }
+}
+
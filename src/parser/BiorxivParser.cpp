@@ -1,23 +1,122 @@
 #include "parser/BiorxivParser.h"
+#include "parser/TextScanners.h"
+#include "parser/HtmlText.h"
+#include "IsoDate.h"
 #include <sstream>
-#include <nlohmann/json.hpp>
 #include <algorithm>
 
-std::vector<Paper> BiorxivParser::parse_papers(const std::string& content) {
-    std::vector<Paper> papers;
+#ifdef CRAWLER_USE_SIMDJSON
+std::pmr::vector<Paper> BiorxivParser::parse_papers(const std::string& content,
+                                                    std::pmr::memory_resource* resource) {
+    std::pmr::vector<Paper> papers(resource);
+    thread_local simdjson::ondemand::parser parser;
+
+    try {
+        simdjson::padded_string storage;
+        simdjson::ondemand::document doc;
+        json_fields::check(parser.iterate(json_fields::padded_view(content, storage)).get(doc));
+
+        simdjson::ondemand::object root;
+        if (doc.get_object().get(root)) {
+            return papers;
+        }
+
+        // Walk the top-level object once; only `collection` is materialised
+        for (auto field : root) {
+            std::string_view key;
+            json_fields::check(field.unescaped_key().get(key));
+            if (key != "collection") {
+                continue;
+            }
+
+            simdjson::ondemand::array collection;
+            if (field.value().get_array().get(collection)) {
+                continue;
+            }
+            parse_collection(collection, papers);
+        }
+
+        if (!doc.at_end()) {
+            papers.clear();
+        }
+    } catch (const simdjson::simdjson_error& e) {
+        // Malformed document: like the nlohmann backend, return nothing
+        papers.clear();
+    }
+
+    return papers;
+}
+
+std::pmr::vector<Paper> BiorxivParser::parse_records(std::string_view chunk,
+                                                     std::pmr::memory_resource* resource) {
+    std::pmr::vector<Paper> papers(resource);
+    thread_local simdjson::ondemand::parser parser;
+
+    // Errors propagate so parse_papers_parallel() can reject the document
+    auto array_text = json_fields::wrap_array(chunk);
+    simdjson::padded_string storage;
+    simdjson::ondemand::document doc;
+    json_fields::check(parser.iterate(json_fields::padded_view(array_text, storage)).get(doc));
+
+    simdjson::ondemand::array collection;
+    json_fields::check(doc.get_array().get(collection));
+    parse_collection(collection, papers);
+    if (!doc.at_end()) {
+        throw simdjson::simdjson_error(simdjson::TRAILING_CONTENT);
+    }
+    return papers;
+}
+
+void BiorxivParser::parse_collection(simdjson::ondemand::array collection, std::pmr::vector<Paper>& papers) {
+    for (auto element : collection) {
+        simdjson::ondemand::object item;
+        auto error = element.get_object().get(item);
+        if (error == simdjson::INCORRECT_TYPE) {
+            continue;
+        }
+        json_fields::check(error);
+
+        try {
+            papers.push_back(parse_paper_item(item, papers.get_allocator()));
+        } catch (const simdjson::simdjson_error&) {
+            throw;
+        } catch (const std::exception& e) {
+            continue;
+        }
+    }
+}
+
+Paper BiorxivParser::parse_paper_item(simdjson::ondemand::object item, Paper::allocator_type alloc) {
+    ItemFields fields(alloc);
+
+    for (auto field : item) {
+        std::string_view key;
+        json_fields::check(field.unescaped_key().get(key));
+        simdjson::ondemand::value value;
+        json_fields::check(field.value().get(value));
+
+        if (key == "doi") json_fields::read(value, fields.doi);
+        else if (key == "title") json_fields::read(value, fields.title);
+        else if (key == "abstract") json_fields::read(value, fields.abstract);
+        else if (key == "authors") json_fields::read(value, fields.authors);
+        else if (key == "category") json_fields::read(value, fields.category);
+        else if (key == "date") json_fields::read(value, fields.date);
+        else if (key == "jatsxml") json_fields::read(value, fields.jatsxml);
+        else if (key == "version") json_fields::read(value, fields.version);
+    }
+
+    return build_paper(fields, alloc);
+}
+#else
+std::pmr::vector<Paper> BiorxivParser::parse_papers(const std::string& content,
+                                                    std::pmr::memory_resource* resource) {
+    std::pmr::vector<Paper> papers(resource);
 
     try {
         auto json = nlohmann::json::parse(content);
 
         if (json.contains("collection") && json["collection"].is_array()) {
-            for (const auto& item : json["collection"]) {
-                try {
-                    Paper paper = parse_paper_item(item);
-                    papers.push_back(std::move(paper));
-                } catch (const std::exception& e) {
-                    continue;
-                }
-            }
+            parse_collection(json["collection"], papers);
         }
     } catch (const nlohmann::json::exception& e) {
         // Handle JSON parsing errors
@@ -26,47 +125,87 @@ std::vector<Paper> BiorxivParser::parse_papers(const std::string& content) {
     return papers;
 }
 
-Paper BiorxivParser::parse_paper_item(const nlohmann::json& item) {
-    Paper paper;
-    paper.source = "biorxiv";
+std::pmr::vector<Paper> BiorxivParser::parse_records(std::string_view chunk,
+                                                     std::pmr::memory_resource* resource) {
+    std::pmr::vector<Paper> papers(resource);
+
+    // Errors propagate so parse_papers_parallel() can reject the document
+    auto json = nlohmann::json::parse(json_fields::wrap_array(chunk));
+    parse_collection(json, papers);
+    return papers;
+}
+
+void BiorxivParser::parse_collection(const nlohmann::json& collection, std::pmr::vector<Paper>& papers) {
+    for (const auto& item : collection) {
+        try {
+            Paper paper = parse_paper_item(item, papers.get_allocator());
+            papers.push_back(std::move(paper));
+        } catch (const std::exception& e) {
+            continue;
+        }
+    }
+}
+#endif
+
+std::vector<std::string_view> BiorxivParser::split_records(std::string_view content,
+                                                          size_t max_chunks) const {
+    // Items of the top-level `collection` array
+    return json_fields::split_array(content, "collection", max_chunks);
+}
+
+Paper BiorxivParser::parse_paper_item(const nlohmann::json& item, Paper::allocator_type alloc) {
+    if (!item.is_object()) {
+        throw std::runtime_error("bioRxiv item is not an object");
+    }
+
+    ItemFields fields(alloc);
+    json_fields::read(item, "doi", fields.doi);
+    json_fields::read(item, "title", fields.title);
+    json_fields::read(item, "abstract", fields.abstract);
+    json_fields::read(item, "authors", fields.authors);
+    json_fields::read(item, "category", fields.category);
+    json_fields::read(item, "date", fields.date);
+    json_fields::read(item, "jatsxml", fields.jatsxml);
+    json_fields::read(item, "version", fields.version);
+
+    return build_paper(fields, alloc);
+}
+
+Paper BiorxivParser::build_paper(ItemFields& fields, Paper::allocator_type alloc) {
+    static const Symbol kSource = Symbol::intern("biorxiv");
+
+    Paper paper(alloc);
+    paper.source = kSource;
 
     // Parse basic fields
-    paper.id = item.value("doi", "");
-    paper.title = item.value("title", "");
-    paper.abstract = item.value("abstract", "");
-    paper.doi = item.value("doi", "");
+    paper.id = fields.doi;
+    paper.title = std::move(fields.title);
+    // Abstracts occasionally carry inline HTML (<i>, <sup>, entities)
+    html_text::clean_in_place(fields.abstract);
+    paper.abstract = std::move(fields.abstract);
+    paper.doi = std::move(fields.doi);
 
     // Parse authors
-    std::string authors_str = item.value("authors", "");
-    paper.authors = parse_authors(authors_str);
+    paper.authors = parse_authors(fields.authors, alloc);
 
     // Parse categories
-    std::string category = item.value("category", "");
-    if (!category.empty()) {
-        paper.categories.push_back(category);
+    if (!fields.category.empty()) {
+        paper.categories.push_back(Symbol::intern(fields.category));
     }
 
     // Parse dates
-    auto parse_biorxiv_date = [](const std::string& date_str) {
-        std::tm tm = {};
-        std::istringstream ss(date_str);
-        ss >> std::get_time(&tm, "%Y-%m-%d");
-        return std::chrono::system_clock::from_time_t(std::mktime(&tm));
-    };
-
-    paper.published_date = parse_biorxiv_date(item.value("date", ""));
+    paper.published_date = iso_date::parse(fields.date);
     paper.updated_date = paper.published_date; // bioRxiv doesn't typically have update dates
 
     // Parse PDF URL
-    paper.pdf_url = item.value("jatsxml", "");
-    if (!paper.pdf_url.empty()) {
+    paper.pdf_url = std::move(fields.jatsxml);
+    if (paper.pdf_url.ends_with(".xml")) {
         // Convert to PDF URL
-        std::regex pdf_regex(R"(\.xml$)");
-        paper.pdf_url = std::regex_replace(paper.pdf_url, pdf_regex, ".pdf");
+        paper.pdf_url.replace(paper.pdf_url.size() - 4, 4, ".pdf");
     }
 
     // Parse version
-    paper.version = item.value("version", 1);
+    paper.version = fields.version;
 
     return paper;
 }
@@ -90,23 +229,12 @@ std::string BiorxivParser::build_query(const std::vector<std::string>& categorie
     return query.str();
 }
 
-std::vector<Author> BiorxivParser::parse_authors(const std::string& authors_str) {
-    std::vector<Author> authors;
+std::pmr::vector<Author> BiorxivParser::parse_authors(std::string_view authors_str,
+                                                      Author::allocator_type alloc) {
+    std::pmr::vector<Author> authors(alloc);
 
     // bioRxiv authors are typically in "LastName1 FirstName1, LastName2 FirstName2" format
-    std::regex author_regex(R"(([^,]+)(?:,\s*|$))");
-    std::sregex_iterator it(authors_str.begin(), authors_str.end(), author_regex);
-    std::sregex_iterator end;
-
-    while (it != end) {
-        std::smatch match = *it;
-        if (match.size() > 1) {
-            Author author;
-            author.name = match[1].str();
-            authors.push_back(author);
-        }
-        ++it;
-    }
+    text_scan::split_authors(authors_str, authors);
 
     return authors;
-}
\ No newline at end of file
+}
@@ -1,25 +1,180 @@
 #include "parser/ChemRxivParser.h"
+#include "parser/HtmlText.h"
+#include "IsoDate.h"
 #include <sstream>
-#include <nlohmann/json.hpp>
 #include <algorithm>
 
-std::vector<Paper> ChemRxivParser::parse_papers(const std::string& content) {
-    std::vector<Paper> papers;
+#ifdef CRAWLER_USE_SIMDJSON
+std::pmr::vector<Paper> ChemRxivParser::parse_papers(const std::string& content,
+                                                     std::pmr::memory_resource* resource) {
+    std::pmr::vector<Paper> papers(resource);
+    thread_local simdjson::ondemand::parser parser;
+
+    try {
+        simdjson::padded_string storage;
+        simdjson::ondemand::document doc;
+        json_fields::check(parser.iterate(json_fields::padded_view(content, storage)).get(doc));
+
+        simdjson::ondemand::object root;
+        if (doc.get_object().get(root)) {
+            return papers;
+        }
+
+        // Walk the top-level object once; only `itemHits` is materialised
+        for (auto field : root) {
+            std::string_view key;
+            json_fields::check(field.unescaped_key().get(key));
+            if (key != "itemHits") {
+                continue;
+            }
+
+            simdjson::ondemand::array hits;
+            if (field.value().get_array().get(hits)) {
+                continue;
+            }
+            parse_hits(hits, papers);
+        }
+
+        if (!doc.at_end()) {
+            papers.clear();
+        }
+    } catch (const simdjson::simdjson_error& e) {
+        // Malformed document: like the nlohmann backend, return nothing
+        papers.clear();
+    }
+
+    return papers;
+}
+
+std::pmr::vector<Paper> ChemRxivParser::parse_records(std::string_view chunk,
+                                                      std::pmr::memory_resource* resource) {
+    std::pmr::vector<Paper> papers(resource);
+    thread_local simdjson::ondemand::parser parser;
+
+    // Errors propagate so parse_papers_parallel() can reject the document
+    auto array_text = json_fields::wrap_array(chunk);
+    simdjson::padded_string storage;
+    simdjson::ondemand::document doc;
+    json_fields::check(parser.iterate(json_fields::padded_view(array_text, storage)).get(doc));
+
+    simdjson::ondemand::array hits;
+    json_fields::check(doc.get_array().get(hits));
+    parse_hits(hits, papers);
+    if (!doc.at_end()) {
+        throw simdjson::simdjson_error(simdjson::TRAILING_CONTENT);
+    }
+    return papers;
+}
+
+void ChemRxivParser::parse_hits(simdjson::ondemand::array hits, std::pmr::vector<Paper>& papers) {
+    for (auto element : hits) {
+        simdjson::ondemand::object hit;
+        auto error = element.get_object().get(hit);
+        if (error == simdjson::INCORRECT_TYPE) {
+            continue;
+        }
+        json_fields::check(error);
+
+        simdjson::ondemand::object item;
+        error = hit.find_field_unordered("item").get_object().get(item);
+        if (error == simdjson::NO_SUCH_FIELD || error == simdjson::INCORRECT_TYPE) {
+            continue;
+        }
+        json_fields::check(error);
+
+        try {
+            papers.push_back(parse_paper_item(item, papers.get_allocator()));
+        } catch (const simdjson::simdjson_error&) {
+            throw;
+        } catch (const std::exception& e) {
+            continue;
+        }
+    }
+}
+
+Paper ChemRxivParser::parse_paper_item(simdjson::ondemand::object item, Paper::allocator_type alloc) {
+    ItemFields fields(alloc);
+
+    for (auto field : item) {
+        std::string_view key;
+        json_fields::check(field.unescaped_key().get(key));
+        simdjson::ondemand::value value;
+        json_fields::check(field.value().get(value));
+
+        if (key == "id") json_fields::read(value, fields.id);
+        else if (key == "title") json_fields::read(value, fields.title);
+        else if (key == "doi") json_fields::read(value, fields.doi);
+        else if (key == "publishedDate") json_fields::read(value, fields.published_date);
+        else if (key == "updatedDate") json_fields::read(value, fields.updated_date);
+        else if (key == "version") json_fields::read(value, fields.version);
+        else if (key == "description" || key == "pdfUrl") {
+            // Optional: only taken when it is a string
+            auto& target = key == "description" ? fields.description : fields.pdf_url;
+            std::string_view text;
+            if (!value.get_string().get(text)) {
+                target.assign(text);
+            } else {
+                target.clear();
+            }
+        } else if (key == "authors") {
+            fields.authors.clear();
+            simdjson::ondemand::array authors;
+            if (value.get_array().get(authors)) {
+                continue;
+            }
+            for (auto author_json : authors) {
+                simdjson::ondemand::object author_object;
+                json_fields::check(author_json.get_object().get(author_object));
+                fields.authors.push_back(parse_author(author_object, alloc));
+            }
+        } else if (key == "categories") {
+            fields.categories.clear();
+            simdjson::ondemand::array categories;
+            if (value.get_array().get(categories)) {
+                continue;
+            }
+            for (auto category : categories) {
+                std::string_view text;
+                json_fields::check(category.get_string().get(text));
+                fields.categories.push_back(Symbol::intern(text));
+            }
+        }
+    }
+
+    return build_paper(fields, alloc);
+}
+
+Author ChemRxivParser::parse_author(simdjson::ondemand::object author_json,
+                                    Author::allocator_type alloc) {
+    std::string first_name, last_name, affiliation;
+    Author author(alloc);
+
+    for (auto field : author_json) {
+        std::string_view key;
+        json_fields::check(field.unescaped_key().get(key));
+        simdjson::ondemand::value value;
+        json_fields::check(field.value().get(value));
+
+        if (key == "firstName") json_fields::read(value, first_name);
+        else if (key == "lastName") json_fields::read(value, last_name);
+        else if (key == "affiliation") json_fields::read(value, affiliation);
+        else if (key == "orcid") json_fields::read(value, author.orcid);
+    }
+
+    author.name.append(first_name).append(" ").append(last_name);
+    author.affiliation = Symbol::intern(affiliation);
+    return author;
+}
+#else
+std::pmr::vector<Paper> ChemRxivParser::parse_papers(const std::string& content,
+                                                     std::pmr::memory_resource* resource) {
+    std::pmr::vector<Paper> papers(resource);
 
     try {
         auto json = nlohmann::json::parse(content);
 
         if (json.contains("itemHits") && json["itemHits"].is_array()) {
-            for (const auto& hit : json["itemHits"]) {
-                if (hit.contains("item") && hit["item"].is_object()) {
-                    try {
-                        Paper paper = parse_paper_item(hit["item"]);
-                        papers.push_back(std::move(paper));
-                    } catch (const std::exception& e) {
-                        continue;
-                    }
-                }
-            }
+            parse_hits(json["itemHits"], papers);
         }
     } catch (const nlohmann::json::exception& e) {
         // Handle JSON parsing errors
@@ -28,59 +183,126 @@ std::vector<Paper> ChemRxivParser::parse_papers(const std::string& content) {
     return papers;
 }
 
-Paper ChemRxivParser::parse_paper_item(const nlohmann::json& item) {
-    Paper paper;
-    paper.source = "chemrxiv";
+std::pmr::vector<Paper> ChemRxivParser::parse_records(std::string_view chunk,
+                                                      std::pmr::memory_resource* resource) {
+    std::pmr::vector<Paper> papers(resource);
+
+    // Errors propagate so parse_papers_parallel() can reject the document
+    auto json = nlohmann::json::parse(json_fields::wrap_array(chunk));
+    parse_hits(json, papers);
+    return papers;
+}
+
+void ChemRxivParser::parse_hits(const nlohmann::json& hits, std::pmr::vector<Paper>& papers) {
+    for (const auto& hit : hits) {
+        if (hit.contains("item") && hit["item"].is_object()) {
+            try {
+                Paper paper = parse_paper_item(hit["item"], papers.get_allocator());
+                papers.push_back(std::move(paper));
+            } catch (const std::exception& e) {
+                continue;
+            }
+        }
+    }
+}
+#endif
+
+std::vector<std::string_view> ChemRxivParser::split_records(std::string_view content,
+                                                           size_t max_chunks) const {
+    // Elements of the top-level `itemHits` array
+    return json_fields::split_array(content, "itemHits", max_chunks);
+}
+
+Paper ChemRxivParser::parse_paper_item(const nlohmann::json& item, Paper::allocator_type alloc) {
+    ItemFields fields(alloc);
 
     // Parse basic fields
-    paper.id = item.value("id", "");
-    paper.title = item.value("title", "");
-    paper.doi = item.value("doi", "");
+    json_fields::read(item, "id", fields.id);
+    json_fields::read(item, "title", fields.title);
+    json_fields::read(item, "doi", fields.doi);
 
     // Parse abstract
     if (item.contains("description") && item["description"].is_string()) {
-        paper.abstract = item["description"];
+        fields.description = item["description"].get_ref<const std::string&>();
     }
 
     // Parse authors
     if (item.contains("authors") && item["authors"].is_array()) {
         for (const auto& author_json : item["authors"]) {
-            Author author;
-            author.name = author_json.value("firstName", "") + " " +
-                          author_json.value("lastName", "");
-            author.affiliation = author_json.value("affiliation", "");
-            author.orcid = author_json.value("orcid", "");
-            paper.authors.push_back(author);
+            if (!author_json.is_object()) {
+                throw std::runtime_error("ChemRxiv author is not an object");
+            }
+            std::string first_name, last_name, affiliation;
+            Author author(alloc);
+            json_fields::read(author_json, "firstName", first_name);
+            json_fields::read(author_json, "lastName", last_name);
+            json_fields::read(author_json, "affiliation", affiliation);
+            json_fields::read(author_json, "orcid", author.orcid);
+            author.name.append(first_name).append(" ").append(last_name);
+            author.affiliation = Symbol::intern(affiliation);
+            fields.authors.push_back(std::move(author));
         }
     }
 
     // Parse categories
     if (item.contains("categories") && item["categories"].is_array()) {
         for (const auto& category : item["categories"]) {
-            paper.categories.push_back(category);
+            fields.categories.push_back(Symbol::intern(category.get_ref<const std::string&>()));
         }
     }
 
-    // Parse dates
-    auto parse_chemrxiv_date = [](const std::string& date_str) {
-        std::tm tm = {};
-        std::istringstream ss(date_str);
-        ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S.%fZ");
-        return std::chrono::system_clock::from_time_t(std::mktime(&tm));
-    };
-
-    paper.published_date = parse_chemrxiv_date(item.value("publishedDate", ""));
-    paper.updated_date = parse_chemrxiv_date(item.value("updatedDate", ""));
+    json_fields::read(item, "publishedDate", fields.published_date);
+    json_fields::read(item, "updatedDate", fields.updated_date);
 
     // Parse PDF URL
     if (item.contains("pdfUrl") && item["pdfUrl"].is_string()) {
-        paper.pdf_url = item["pdfUrl"];
+        fields.pdf_url = item["pdfUrl"].get_ref<const std::string&>();
     }
 
     // Parse version
-    paper.version = item.value("version", 1);
+    json_fields::read(item, "version", fields.version);
+
+    return build_paper(fields, alloc);
+}
+
+Paper ChemRxivParser::build_paper(ItemFields& fields, Paper::allocator_type alloc) {
+    static const Symbol kSource = Symbol::intern("chemrxiv");
+
+    Paper paper(alloc);
+    paper.source = kSource;
+
+    paper.id = std::move(fields.id);
+    paper.title = std::move(fields.title);
+    paper.doi = std::move(fields.doi);
+    // Descriptions are HTML fragments
+    html_text::clean_in_place(fields.description);
+    paper.abstract = std::move(fields.description);
+    paper.authors = std::move(fields.authors);
+    paper.categories = std::move(fields.categories);
+
+    // Parse dates
+    paper.published_date = iso_date::parse(fields.published_date);
+    paper.updated_date = iso_date::parse(fields.updated_date);
+
+    paper.pdf_url = std::move(fields.pdf_url);
+    paper.version = fields.version;
 
     return paper;
 }
 
-std::string Chem
\ No newline at end of file
+std::string ChemRxivParser::build_query(const std::vector<std::string>& categories,
+                                        size_t start_index, size_t max_results) {
+    std::stringstream query;
+    query << "?limit=" << max_results
+          << "&skip=" << start_index;
+
+    if (!categories.empty()) {
+        query << "&categoryIds=";
+        for (size_t i = 0; i < categories.size(); ++i) {
+            if (i > 0) query << ",";
+            query << categories[i];
+        }
+    }
+
+    return query.str();
+}
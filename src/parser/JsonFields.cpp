@@ -0,0 +1,133 @@
+#include "parser/JsonFields.h"
+
+namespace {
+    bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    // Matches simdjson::SIMDJSON_PADDING without requiring simdjson
+    constexpr size_t kParsePadding = 64;
+}
+
+namespace json_fields {
+
+    std::vector<std::string_view> split_array(std::string_view json, std::string_view key,
+                                              size_t max_chunks) {
+        // Structural scan only: strings, nesting and top-level commas of the
+        // target array. Values themselves are validated when chunks are parsed,
+        // so what no chunk covers is checked here: empty elements (which the
+        // chunks would not see as such) and anything after the document.
+        size_t depth = 0;
+        bool in_string = false;
+        size_t string_start = 0;
+        bool key_matched = false;   // last token was `key` at depth 1
+        bool awaiting_value = false;  // saw `key` ':'
+        size_t array_begin = std::string_view::npos;
+        size_t array_end = std::string_view::npos;
+        std::vector<size_t> commas;
+        bool element_seen = false;  // since the array's '[' or its last comma
+        bool document_closed = false;
+
+        for (size_t i = 0; i < json.size(); ++i) {
+            char c = json[i];
+            if (in_string) {
+                if (c == '\\') {
+                    ++i;
+                } else if (c == '"') {
+                    in_string = false;
+                    key_matched = depth == 1 && array_begin == std::string_view::npos &&
+                                  json.substr(string_start, i - string_start) == key;
+                }
+                continue;
+            }
+            if (is_space(c)) {
+                continue;
+            }
+            if (document_closed) {
+                return {};
+            }
+            bool in_array = array_begin != std::string_view::npos && array_end == std::string_view::npos;
+            if (in_array && depth >= 2 && c != ',' && c != ']') {
+                element_seen = true;
+            }
+
+            bool was_awaiting = awaiting_value;
+            awaiting_value = false;
+            if (c != ':') {
+                key_matched = false;
+            }
+
+            switch (c) {
+                case '"':
+                    in_string = true;
+                    string_start = i + 1;
+                    break;
+                case ':':
+                    awaiting_value = key_matched;
+                    key_matched = false;
+                    break;
+                case '[':
+                    if (was_awaiting) {
+                        array_begin = i;
+                    }
+                    ++depth;
+                    break;
+                case '{':
+                    ++depth;
+                    break;
+                case ']':
+                case '}':
+                    if (depth == 0) {
+                        return {};
+                    }
+                    --depth;
+                    if (c == ']' && depth == 1 && in_array) {
+                        // "[]" is empty, "[a,]" has an empty last element
+                        if (!element_seen && !commas.empty()) {
+                            return {};
+                        }
+                        array_end = i;
+                    }
+                    document_closed = depth == 0;
+                    break;
+                case ',':
+                    if (depth == 2 && in_array) {
+                        if (!element_seen) {
+                            return {};
+                        }
+                        commas.push_back(i);
+                        element_seen = false;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (in_string || depth != 0 || array_end == std::string_view::npos || max_chunks == 0) {
+            return {};
+        }
+
+        // Cut at the first element boundary past each size target
+        std::vector<std::string_view> chunks;
+        size_t chunk_start = array_begin + 1;
+        size_t target = (array_end - chunk_start) / max_chunks + 1;
+        for (size_t comma : commas) {
+            if (comma - chunk_start >= target && chunks.size() + 1 < max_chunks) {
+                chunks.push_back(json.substr(chunk_start, comma - chunk_start));
+                chunk_start = comma + 1;
+            }
+        }
+        chunks.push_back(json.substr(chunk_start, array_end - chunk_start));
+        return chunks;
+    }
+
+    std::string wrap_array(std::string_view elements) {
+        std::string array;
+        array.reserve(elements.size() + 2 + kParsePadding);
+        array.push_back('[');
+        array.append(elements);
+        array.push_back(']');
+        return array;
+    }
+}
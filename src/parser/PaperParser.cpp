@@ -2,8 +2,15 @@
 #include "parser/ArxivParser.h"
 #include "parser/BiorxivParser.h"
 #include "parser/ChemRxivParser.h"
+#include "parser/HtmlText.h"
+#include "parser/TextScanners.h"
+#include "IsoDate.h"
 #include <algorithm>
-#include <regex>
+#include <cctype>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <iterator>
 
 std::unique_ptr<PaperParser> PaperParser::create(const std::string& source) {
     if (source == "arxiv") {
@@ -16,6 +23,114 @@ std::unique_ptr<PaperParser> PaperParser::create(const std::string& source) {
     throw std::invalid_argument("Unknown paper source: " + source);
 }
 
+std::vector<PaperView> PaperParser::parse_views(std::shared_ptr<const std::string> content) {
+    auto buffer = std::make_shared<ViewBuffer>();
+    buffer->response = content;
+
+    // The Papers are only a step towards the views, so they get a scratch
+    // arena that is dropped in one go
+    std::pmr::monotonic_buffer_resource scratch;
+    std::vector<PaperView> views;
+    auto papers = parse_papers(*content, &scratch);
+    views.reserve(papers.size());
+    for (const auto& paper : papers) {
+        auto& view = views.emplace_back(PaperView::of(paper));
+        view.store_in(buffer->arena);
+        view.buffer = buffer;
+    }
+    return views;
+}
+
+std::vector<std::string_view> PaperParser::split_records(std::string_view, size_t) const {
+    return {};
+}
+
+std::pmr::vector<Paper> PaperParser::parse_records(std::string_view chunk,
+                                                   std::pmr::memory_resource* resource) {
+    return parse_papers(std::string(chunk), resource);
+}
+
+std::pmr::vector<Paper> PaperParser::parse_papers_parallel(const std::string& content, size_t max_chunks,
+                                                           size_t threshold, const TaskExecutor& executor,
+                                                           PaperArena& arena) {
+    if (max_chunks < 2 || threshold == 0 || content.size() < threshold || !executor) {
+        return parse_papers(content, arena.region(content.size()));
+    }
+
+    auto chunks = split_records(content, max_chunks);
+    if (chunks.size() < 2) {
+        return parse_papers(content, arena.region(content.size()));
+    }
+
+    // Shared with the pool tasks, which may only start after this call has
+    // returned; by then every chunk is claimed and they exit immediately
+    struct Batch {
+        std::vector<std::string_view> chunks;
+        std::vector<std::pmr::vector<Paper>> results;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::atomic<bool> failed{false};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->chunks = std::move(chunks);
+    // Each chunk parses into its own region: monotonic arenas are not
+    // thread-safe, but regions of one arena compare equal, so results and
+    // the merge below move papers without copying their text
+    batch->results.reserve(batch->chunks.size());
+    for (auto chunk : batch->chunks) {
+        batch->results.emplace_back(arena.region(chunk.size()));
+    }
+
+    auto work = [this, batch] {
+        size_t index;
+        while ((index = batch->next++) < batch->chunks.size()) {
+            try {
+                auto& result = batch->results[index];
+                result = parse_records(batch->chunks[index], result.get_allocator().resource());
+            } catch (const std::exception& e) {
+                batch->failed = true;
+            }
+            if (++batch->done == batch->chunks.size()) {
+                std::lock_guard lock(batch->mutex);
+                batch->finished.notify_all();
+            }
+        }
+    };
+
+    for (size_t i = 1; i < batch->chunks.size(); ++i) {
+        executor(work);
+    }
+    work();
+
+    {
+        std::unique_lock lock(batch->mutex);
+        batch->finished.wait(lock, [&batch] {
+            return batch->done.load() == batch->chunks.size();
+        });
+    }
+
+    // A chunk that fails to parse means the document is malformed; the
+    // whole-document path would have returned nothing as well
+    std::pmr::vector<Paper> papers(arena.region(0));
+    if (!batch->failed) {
+        size_t total = 0;
+        for (const auto& result : batch->results) {
+            total += result.size();
+        }
+        papers.reserve(total);
+        for (auto& result : batch->results) {
+            std::move(result.begin(), result.end(), std::back_inserter(papers));
+        }
+    }
+
+    // Late pool tasks may keep the batch alive after the arena is gone
+    batch->results.clear();
+    return papers;
+}
+
 std::string PaperParser::extract_text_between(const std::string& content,
                                               const std::string& start,
                                               const std::string& end) {
@@ -31,17 +146,27 @@ std::string PaperParser::extract_text_between(const std::string& content,
 
 std::vector<std::string> PaperParser::extract_links(const std::string& content) {
     std::vector<std::string> links;
-    std::regex link_regex(R"(href="([^"]*)")", std::regex::icase);
-
-    std::sregex_iterator it(content.begin(), content.end(), link_regex);
-    std::sregex_iterator end;
+    constexpr std::string_view attribute = "href=\"";
 
-    while (it != end) {
-        std::smatch match = *it;
-        if (match.size() > 1) {
-            links.push_back(match[1].str());
+    // Case-insensitive search for href="..."
+    auto matches_at = [&](size_t pos) {
+        for (size_t i = 0; i < attribute.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(content[pos + i])) != attribute[i]) {
+                return false;
+            }
         }
-        ++it;
+        return true;
+    };
+
+    for (size_t pos = 0; pos + attribute.size() <= content.size(); ++pos) {
+        if (!matches_at(pos)) continue;
+
+        size_t start = pos + attribute.size();
+        size_t end = content.find('"', start);
+        if (end == std::string::npos) break;
+
+        links.push_back(content.substr(start, end - start));
+        pos = end;
     }
 
     return links;
@@ -50,13 +175,37 @@ std::vector<std::string> PaperParser::extract_links(const std::string& content)
 std::string PaperParser::clean_html(const std::string& html) {
     std::string result = html;
 
-    // Remove HTML tags
-    std::regex tag_regex("<[^>]*>");
-    result = std::regex_replace(result, tag_regex, "");
+    // Strip tags, decode entities and collapse whitespace in one pass
+    html_text::clean_in_place(result);
+
+    return result;
+}
+
+std::string PaperParser::parse_date(const std::string& date_str) {
+    // Normalise to the canonical UTC form used in the output
+    return iso_date::format(iso_date::parse(date_str));
+}
+
+std::pmr::vector<Author> PaperParser::parse_authors(const std::string& authors_str,
+                                                    Author::allocator_type alloc) {
+    std::pmr::vector<Author> authors(alloc);
+    text_scan::split_authors(authors_str, authors);
+    return authors;
+}
 
-    // Replace HTML entities
-    std::regex entity_regex("&[^;]*;");
-    result = std::regex_replace(result, entity_regex, " ");
+std::vector<std::string> PaperParser::parse_categories(const std::string& categories_str) {
+    std::vector<std::string> categories;
 
-    // Remove extra whitespace
-    std::
\ No newline at end of file
+    // Categories are separated by whitespace or commas
+    size_t pos = 0;
+    while (pos < categories_str.size()) {
+        auto start = categories_str.find_first_not_of(" \t\r\n,", pos);
+        if (start == std::string::npos) break;
+        auto end = categories_str.find_first_of(" \t\r\n,", start);
+        if (end == std::string::npos) end = categories_str.size();
+        categories.push_back(categories_str.substr(start, end - start));
+        pos = end;
+    }
+
+    return categories;
+}
@@ -0,0 +1,121 @@
+#include "parser/TextScanners.h"
+
+namespace {
+    constexpr std::string_view kAbsMarker = "arxiv.org/abs/";
+
+    bool is_digit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    bool is_lower(char c) {
+        return c >= 'a' && c <= 'z';
+    }
+
+    bool is_upper(char c) {
+        return c >= 'A' && c <= 'Z';
+    }
+
+    bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    bool is_doi_suffix_char(char c) {
+        return is_digit(c) || is_lower(c) || is_upper(c) ||
+               c == '-' || c == '.' || c == '_' || c == ';' ||
+               c == '(' || c == ')' || c == '/' || c == ':';
+    }
+
+    size_t count_digits(std::string_view text, size_t pos) {
+        size_t end = pos;
+        while (end < text.size() && is_digit(text[end])) ++end;
+        return end - pos;
+    }
+
+    // Optional "vN" version suffix; true if `pos` then reaches the end
+    bool version_suffix_ok(std::string_view id, size_t pos) {
+        if (pos == id.size()) {
+            return true;
+        }
+        if (id[pos] != 'v') {
+            return false;
+        }
+        size_t digits = count_digits(id, pos + 1);
+        return digits > 0 && pos + 1 + digits == id.size();
+    }
+}
+
+namespace text_scan {
+
+    bool is_old_style_arxiv_id(std::string_view id) {
+        // archive: lowercase letters and '-', optionally ".XX" subject class
+        size_t pos = 0;
+        while (pos < id.size() && (is_lower(id[pos]) || id[pos] == '-')) ++pos;
+        if (pos == 0 || pos == id.size()) {
+            return false;
+        }
+        if (id[pos] == '.') {
+            if (pos + 3 > id.size() || !is_upper(id[pos + 1]) || !is_upper(id[pos + 2])) {
+                return false;
+            }
+            pos += 3;
+        }
+        if (pos >= id.size() || id[pos] != '/' || count_digits(id, pos + 1) != 7) {
+            return false;
+        }
+        return version_suffix_ok(id, pos + 8);
+    }
+
+    std::string_view arxiv_id(std::string_view text) {
+        // Only the text after the last marker can be slash-free (or a single
+        // old-style ID), so that is the one the regex used to match
+        auto marker = text.rfind(kAbsMarker);
+        if (marker == std::string_view::npos) {
+            return text;
+        }
+
+        auto id = text.substr(marker + kAbsMarker.size());
+        if (id.empty()) {
+            return text;
+        }
+        if (id.find('/') != std::string_view::npos && !is_old_style_arxiv_id(id)) {
+            return text;
+        }
+        return id;
+    }
+
+    std::string_view find_doi(std::string_view text) {
+        size_t pos = 0;
+        while ((pos = text.find("10.", pos)) != std::string_view::npos) {
+            size_t registrant = count_digits(text, pos + 3);
+            size_t slash = pos + 3 + registrant;
+            if (registrant >= 4 && registrant <= 9 &&
+                slash + 1 < text.size() && text[slash] == '/' && is_doi_suffix_char(text[slash + 1])) {
+                size_t end = slash + 1;
+                while (end < text.size() && is_doi_suffix_char(text[end])) ++end;
+                return text.substr(pos, end - pos);
+            }
+            ++pos;
+        }
+        return {};
+    }
+
+    void split_authors(std::string_view list, std::pmr::vector<Author>& out) {
+        size_t pos = 0;
+        while (pos < list.size()) {
+            if (list[pos] == ',') {
+                ++pos;
+                continue;
+            }
+
+            auto comma = list.find(',', pos);
+            auto end = comma == std::string_view::npos ? list.size() : comma;
+            out.emplace_back(list.substr(pos, end - pos), "", "");
+
+            pos = end;
+            if (comma != std::string_view::npos) {
+                ++pos;
+                while (pos < list.size() && is_space(list[pos])) ++pos;
+            }
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#include "scheduler/ConsistentHashRing.h"
+
+ConsistentHashRing::ConsistentHashRing(size_t shard_count, size_t virtual_nodes)
+        : shard_count_(shard_count == 0 ? 1 : shard_count) {
+    for (size_t shard = 0; shard < shard_count_; ++shard) {
+        for (size_t replica = 0; replica < virtual_nodes; ++replica) {
+            ring_.emplace(hash("shard-" + std::to_string(shard) + "#" + std::to_string(replica)),
+                          shard);
+        }
+    }
+}
+
+size_t ConsistentHashRing::shard_for(const std::string& key) const {
+    if (ring_.empty()) {
+        return 0;
+    }
+
+    // 顺时针找到第一个虚拟节点，越过末尾则回到环首
+    auto it = ring_.lower_bound(hash(key));
+    if (it == ring_.end()) {
+        it = ring_.begin();
+    }
+    return it->second;
+}
+
+void ConsistentHashRing::remove_shard(size_t shard) {
+    std::erase_if(ring_, [shard](const auto& point) { return point.second == shard; });
+}
+
+uint64_t ConsistentHashRing::hash(const std::string& key) {
+    uint64_t value = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        value ^= c;
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
@@ -0,0 +1,138 @@
+#include "scheduler/CpuAffinity.h"
+#include "config/CrawlerConfig.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+namespace {
+    std::vector<int> parse_cpu_ranges(const std::string& text) {
+        std::vector<int> cpus;
+        std::stringstream ranges(text);
+        std::string range;
+        while (std::getline(ranges, range, ',')) {
+            range.erase(std::remove_if(range.begin(), range.end(),
+                                       [](unsigned char c) { return std::isspace(c); }),
+                        range.end());
+            if (range.empty()) continue;
+
+            auto dash = range.find('-');
+            try {
+                int first = std::stoi(range.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            } catch (const std::exception&) {
+                return {};
+            }
+        }
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+        return cpus;
+    }
+
+    std::vector<int> node_cpus(int node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string line;
+        std::getline(file, line);
+        return parse_cpu_ranges(line);
+    }
+
+    // 所有CPU都属于同一个NUMA节点时返回该节点，否则返回-1
+    int numa_node_of(const std::vector<int>& cpus) {
+        const std::filesystem::path nodes("/sys/devices/system/node");
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(nodes, ec)) {
+            auto name = entry.path().filename().string();
+            if (name.rfind("node", 0) != 0 || name.size() == 4 || !std::isdigit(name[4])) {
+                continue;
+            }
+
+            int node = std::stoi(name.substr(4));
+            auto local = node_cpus(node);
+            if (std::includes(local.begin(), local.end(), cpus.begin(), cpus.end())) {
+                return node;
+            }
+        }
+        return -1;
+    }
+}
+
+std::optional<CpuPlacement> CpuPlacement::parse(const std::string& spec) {
+    if (spec.empty()) {
+        return std::nullopt;
+    }
+
+    CpuPlacement placement;
+    if (spec.rfind("node:", 0) == 0) {
+        try {
+            placement.numa_node = std::stoi(spec.substr(5));
+        } catch (const std::exception&) {
+            return std::nullopt;
+        }
+        placement.cpus = node_cpus(placement.numa_node);
+    } else {
+        placement.cpus = parse_cpu_ranges(spec);
+        if (!placement.cpus.empty()) {
+            placement.numa_node = numa_node_of(placement.cpus);
+        }
+    }
+
+    if (placement.cpus.empty()) {
+        return std::nullopt;
+    }
+    return placement;
+}
+
+std::optional<CpuPlacement> CpuAffinity::placement_for(PipelineStage stage) {
+    const auto& affinity = CrawlerConfig::getInstance().getCrawlerSettings().affinity;
+    switch (stage) {
+        case PipelineStage::NETWORK: return CpuPlacement::parse(affinity.network);
+        case PipelineStage::PARSE: return CpuPlacement::parse(affinity.parse);
+        case PipelineStage::STORAGE: return CpuPlacement::parse(affinity.storage);
+    }
+    return std::nullopt;
+}
+
+bool CpuAffinity::pin_current_thread(PipelineStage stage) {
+    auto placement = placement_for(stage);
+    return !placement || pin_current_thread(*placement);
+}
+
+bool CpuAffinity::pin_current_thread(const CpuPlacement& placement) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : placement.cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        std::cerr << "Failed to set CPU affinity" << std::endl;
+        return false;
+    }
+
+    // 线程的后续分配优先来自本地节点；页面在首次访问时落在该节点上
+    if (placement.numa_node >= 0 && placement.numa_node < 64) {
+        unsigned long nodemask = 1UL << placement.numa_node;
+        if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &nodemask, sizeof(nodemask) * 8) != 0) {
+            std::cerr << "Failed to set NUMA memory policy for node "
+                      << placement.numa_node << std::endl;
+        }
+    }
+    return true;
+}
+
+size_t CpuAffinity::worker_count(PipelineStage stage, size_t fallback) {
+    auto placement = placement_for(stage);
+    return placement ? placement->cpus.size() : fallback;
+}
@@ -0,0 +1,557 @@
+#include "scheduler/HybridScheduler.h"
+#include "config/CrawlerConfig.h"
+#include "scheduler/CpuAffinity.h"
+#include "parser/PaperParser.h"
+#include "storage/PaperJson.h"
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <map>
+#include <unordered_map>
+#include <csignal>
+#include <cerrno>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+namespace {
+    volatile std::sig_atomic_t g_worker_stop = 0;
+
+    // Results a worker holds before it stops starting transfers
+    constexpr size_t kMaxOutbox = 16 * 1024 * 1024;
+
+    void handle_worker_stop(int) {
+        g_worker_stop = 1;
+    }
+
+    // Writes the front of `buffer` to a non-blocking fd until it would
+    // block; false on a write error (the reader is gone)
+    bool write_some(int fd, std::string& buffer) {
+        size_t written = 0;
+        while (written < buffer.size()) {
+            ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            written += static_cast<size_t>(n);
+        }
+        buffer.erase(0, written);
+        return true;
+    }
+
+    void set_nonblocking(int fd, bool enabled) {
+        int flags = fcntl(fd, F_GETFL);
+        fcntl(fd, F_SETFL, enabled ? flags | O_NONBLOCK : flags & ~O_NONBLOCK);
+    }
+
+    std::string host_of(const std::string& url) {
+        auto begin = url.find("://");
+        begin = begin == std::string::npos ? 0 : begin + 3;
+        auto end = url.find_first_of(":/?", begin);
+        return url.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+    }
+
+    size_t write_body(char* ptr, size_t size, size_t nmemb, void* userdata) {
+        static_cast<std::string*>(userdata)->append(ptr, size * nmemb);
+        return size * nmemb;
+    }
+}
+
+HybridScheduler::HybridScheduler(size_t process_count, size_t transfers_per_process)
+        : ring_(process_count),
+          transfers_per_process_(transfers_per_process == 0 ? 1 : transfers_per_process) {
+    // 子进程退出后写任务管道返回EPIPE，而不是终止本进程
+    std::signal(SIGPIPE, SIG_IGN);
+    spawn_workers(ring_.shard_count());
+}
+
+HybridScheduler::~HybridScheduler() {
+    if (!stop_source_.stop_requested()) {
+        // 正常结束：发完排队的任务后关闭任务管道，子进程处理完剩余任务后自行退出
+        close_job_pipes(false);
+        while (pump_results(100)) {
+        }
+        reap_workers();
+    }
+}
+
+void HybridScheduler::spawn_workers(size_t process_count) {
+    // 下标即分片号；创建失败的分片留空位并移出哈希环
+    workers_.resize(process_count);
+    for (size_t i = 0; i < process_count; ++i) {
+        int job_pipe[2];
+        int result_pipe[2];
+        if (pipe(job_pipe) != 0) {
+            notify_error("hybrid", "Failed to create job pipe");
+            retire_worker(i);
+            continue;
+        }
+        if (pipe(result_pipe) != 0) {
+            close(job_pipe[0]);
+            close(job_pipe[1]);
+            notify_error("hybrid", "Failed to create result pipe");
+            retire_worker(i);
+            continue;
+        }
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            // 子进程：关闭其它worker的父端管道，避免EOF无法传递
+            for (size_t j = 0; j < i; ++j) {
+                if (workers_[j].job_fd >= 0) close(workers_[j].job_fd);
+                if (workers_[j].result_fd >= 0) close(workers_[j].result_fd);
+            }
+            close(job_pipe[1]);
+            close(result_pipe[0]);
+            run_worker(job_pipe[0], result_pipe[1], transfers_per_process_);
+        } else if (pid > 0) {
+            close(job_pipe[0]);
+            close(result_pipe[1]);
+            set_nonblocking(job_pipe[1], true);
+
+            workers_[i].pid = pid;
+            workers_[i].job_fd = job_pipe[1];
+            workers_[i].result_fd = result_pipe[0];
+        } else {
+            close(job_pipe[0]);
+            close(job_pipe[1]);
+            close(result_pipe[0]);
+            close(result_pipe[1]);
+            notify_error("hybrid", "Failed to create worker process");
+            retire_worker(i);
+        }
+    }
+}
+
+void HybridScheduler::retire_worker(size_t shard) {
+    // 只有该分片的主机迁移到相邻分片，其它主机仍留在原进程
+    ring_.remove_shard(shard);
+}
+
+std::string HybridScheduler::shard_key(const std::string& source) {
+    const auto& config = CrawlerConfig::getInstance();
+    if (source == "arxiv") return host_of(config.getArxivSettings().base_url);
+    if (source == "biorxiv") return host_of(config.getBiorxivSettings().base_url);
+    if (source == "chemrxiv") return host_of(config.getChemRxivSettings().base_url);
+    return source;
+}
+
+void HybridScheduler::schedule_crawl(const std::string& source,
+                                     const std::vector<std::string>& categories) {
+    if (stop_source_.stop_requested() || ring_.empty()) {
+        notify_error(source, "Hybrid scheduler is not accepting jobs");
+        failed_++;
+        return;
+    }
+
+    // 同一主机的任务总是落在同一个进程，按主机限速无需跨进程协调
+    auto& worker = workers_[ring_.shard_for(shard_key(source))];
+    if (worker.job_fd < 0 || worker.closing) {
+        notify_error(source, "Failed to dispatch job to worker " + std::to_string(worker.pid));
+        failed_++;
+        return;
+    }
+
+    // 管道写满时任务留在队列里，由pump_results在可写时继续发送
+    nlohmann::json job = {
+            {"source", source},
+            {"categories", categories}
+    };
+    worker.send_buffer += job.dump() + "\n";
+    worker.outstanding++;
+    flush_jobs(worker);
+}
+
+void HybridScheduler::flush_jobs(Worker& worker) {
+    if (worker.job_fd < 0) {
+        return;
+    }
+    if (!write_some(worker.job_fd, worker.send_buffer)) {
+        // 子进程已退出：未发送的任务随结果管道的EOF记为失败
+        worker.send_buffer.clear();
+        worker.closing = true;
+    }
+    if (worker.closing && worker.send_buffer.empty()) {
+        close(worker.job_fd);
+        worker.job_fd = -1;
+    }
+}
+
+void HybridScheduler::wait_completion() {
+    auto has_outstanding = [this] {
+        for (const auto& worker : workers_) {
+            if (worker.outstanding > 0) return true;
+        }
+        return false;
+    };
+    auto deliver = [&] {
+        while (has_outstanding() && pump_results(100)) {
+        }
+    };
+
+    // 论文交付即本模式下的存储阶段：配置了storage CPU时由固定在该集合上的线程交付，
+    // 调用线程自身的亲和性保持不变
+    if (!CpuAffinity::placement_for(PipelineStage::STORAGE)) {
+        deliver();
+        return;
+    }
+    std::thread delivery([&] {
+        CpuAffinity::pin_current_thread(PipelineStage::STORAGE);
+        deliver();
+    });
+    delivery.join();
+}
+
+bool HybridScheduler::pump_results(int timeout_ms) {
+    // 读结果的同时发送排队的任务，双方都不会因对方管道写满而阻塞
+    std::vector<pollfd> fds;
+    std::vector<size_t> owners;
+    for (size_t shard = 0; shard < workers_.size(); ++shard) {
+        auto& worker = workers_[shard];
+        if (worker.result_fd >= 0) {
+            fds.push_back({worker.result_fd, POLLIN, 0});
+            owners.push_back(shard);
+        }
+        if (worker.job_fd >= 0 && !worker.send_buffer.empty()) {
+            fds.push_back({worker.job_fd, POLLOUT, 0});
+            owners.push_back(shard);
+        }
+    }
+    if (fds.empty()) {
+        return false;
+    }
+
+    int ready = poll(fds.data(), fds.size(), timeout_ms);
+    if (ready <= 0) {
+        return ready == 0 || errno == EINTR;
+    }
+
+    char buffer[65536];
+    for (size_t i = 0; i < fds.size(); ++i) {
+        Worker& worker = workers_[owners[i]];
+        if (fds[i].events == POLLOUT) {
+            if (fds[i].revents != 0) {
+                flush_jobs(worker);
+            }
+            continue;
+        }
+        if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+            continue;
+        }
+
+        ssize_t n = read(worker.result_fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            worker.read_buffer.append(buffer, static_cast<size_t>(n));
+            size_t line_start = 0;
+            size_t newline;
+            while ((newline = worker.read_buffer.find('\n', line_start)) != std::string::npos) {
+                handle_message(worker, worker.read_buffer.substr(line_start, newline - line_start));
+                line_start = newline + 1;
+            }
+            worker.read_buffer.erase(0, line_start);
+        } else if (n == 0 || errno != EINTR) {
+            // 子进程退出：其未完成的任务记为失败，其主机改由环上相邻的进程负责
+            close(worker.result_fd);
+            worker.result_fd = -1;
+            worker.send_buffer.clear();
+            worker.closing = true;
+            flush_jobs(worker);
+            retire_worker(owners[i]);
+            if (worker.outstanding > 0) {
+                notify_error("hybrid", "Worker " + std::to_string(worker.pid) +
+                                       " exited with " + std::to_string(worker.outstanding) +
+                                       " unfinished jobs");
+                failed_ += worker.outstanding;
+                worker.outstanding = 0;
+            }
+        }
+    }
+    return true;
+}
+
+void HybridScheduler::handle_message(Worker& worker, const std::string& line) {
+    try {
+        auto message = nlohmann::json::parse(line);
+
+        if (message.contains("paper")) {
+            Paper paper = Paper::from_json(message["paper"]);
+            if (is_duplicate(paper)) {
+                return;
+            }
+            route_paper(paper);
+            notify_paper(paper);
+        } else if (message.contains("done")) {
+            const auto& done = message["done"];
+            std::string source = done.value("source", "");
+            std::string error = done.value("error", "");
+
+            if (worker.outstanding > 0) worker.outstanding--;
+            if (error.empty()) {
+                completed_++;
+                notify_progress(completed_.load(), completed_.load() + failed_.load(),
+                                "Completed crawling " + source);
+            } else {
+                failed_++;
+                notify_error(source, error);
+            }
+        }
+    } catch (const std::exception& e) {
+        notify_error("hybrid", "Malformed worker message: " + std::string(e.what()));
+    }
+}
+
+void HybridScheduler::close_job_pipes(bool discard_queued) {
+    for (auto& worker : workers_) {
+        worker.closing = true;
+        if (discard_queued) {
+            worker.send_buffer.clear();
+        }
+        flush_jobs(worker);
+    }
+}
+
+void HybridScheduler::reap_workers() {
+    for (auto& worker : workers_) {
+        if (worker.result_fd >= 0) {
+            close(worker.result_fd);
+            worker.result_fd = -1;
+        }
+        if (worker.pid > 0) {
+            int status;
+            waitpid(worker.pid, &status, 0);
+            worker.pid = -1;
+        }
+    }
+}
+
+void HybridScheduler::stop() {
+    if (stop_source_.stop_requested()) {
+        return;
+    }
+    stop_source_.request_stop();
+
+    // 通知子进程中断传输；已解析的论文仍会写回管道，读尽后再回收。
+    // 未发出的任务随结果管道的EOF记为失败
+    close_job_pipes(true);
+    for (const auto& worker : workers_) {
+        if (worker.pid > 0) {
+            kill(worker.pid, SIGTERM);
+        }
+    }
+    while (pump_results(100)) {
+    }
+    reap_workers();
+}
+
+bool HybridScheduler::is_running() const {
+    if (stop_source_.stop_requested()) {
+        return false;
+    }
+    for (const auto& worker : workers_) {
+        if (worker.outstanding > 0) return true;
+    }
+    return false;
+}
+
+size_t HybridScheduler::get_completed_count() const {
+    return completed_.load();
+}
+
+size_t HybridScheduler::get_failed_count() const {
+    return failed_.load();
+}
+
+size_t HybridScheduler::get_queued_count() const {
+    size_t queued = 0;
+    for (const auto& worker : workers_) {
+        queued += worker.outstanding;
+    }
+    return queued;
+}
+
+void HybridScheduler::run_worker(int job_fd, int result_fd, size_t max_transfers) {
+    std::signal(SIGTERM, handle_worker_stop);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    const auto settings = CrawlerConfig::getInstance().getCrawlerSettings();
+    auto host_delay = std::chrono::milliseconds(
+            static_cast<long>(settings.delay_between_requests * 1000));
+
+    struct Job {
+        std::string source;
+        std::vector<std::string> categories;
+    };
+
+    struct Transfer {
+        std::string source;
+        std::unique_ptr<PaperParser> parser;
+        std::string body;
+    };
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    CURLM* multi = curl_multi_init();
+
+    std::deque<Job> pending;
+    std::map<CURL*, Transfer> active;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> next_allowed;
+    std::string job_buffer;
+    bool jobs_open = true;
+
+    // 结果先进入发件箱，结果管道可写时再发送；父进程暂时不读时不阻塞事件循环
+    set_nonblocking(result_fd, true);
+    std::string outbox;
+    bool results_open = true;
+    auto send_results = [&] {
+        if (results_open && !write_some(result_fd, outbox)) {
+            results_open = false;  // 父进程已退出
+        }
+        if (!results_open) {
+            outbox.clear();
+        }
+    };
+    auto report_done = [&](const std::string& source, const std::string& error) {
+        nlohmann::json done = {{"done", {{"source", source}, {"error", error}}}};
+        outbox += done.dump() + "\n";
+    };
+
+    while (!g_worker_stop && (jobs_open || !pending.empty() || !active.empty())) {
+        // 启动新的传输：受并发上限和同一主机的请求间隔约束；
+        // 发件箱积压过多时先等父进程读走，不再开始新的传输
+        auto now = std::chrono::steady_clock::now();
+        bool backlogged = outbox.size() > kMaxOutbox;
+        for (auto it = pending.begin(); !backlogged && it != pending.end() && active.size() < max_transfers;) {
+            auto host = shard_key(it->source);
+            auto allowed = next_allowed.find(host);
+            if (allowed != next_allowed.end() && now < allowed->second) {
+                ++it;
+                continue;
+            }
+
+            Transfer transfer;
+            transfer.source = it->source;
+            std::string url;
+            try {
+                transfer.parser = PaperParser::create(it->source);
+                url = build_crawl_url(*transfer.parser, it->source, it->categories);
+            } catch (const std::exception& e) {
+                report_done(it->source, e.what());
+                it = pending.erase(it);
+                continue;
+            }
+
+            CURL* easy = curl_easy_init();
+            auto& slot = active.emplace(easy, std::move(transfer)).first->second;
+            curl_easy_setopt(easy, CURLOPT_URL, url.c_str());
+            curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, write_body);
+            curl_easy_setopt(easy, CURLOPT_WRITEDATA, &slot.body);
+            curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+            curl_easy_setopt(easy, CURLOPT_TIMEOUT, static_cast<long>(settings.request_timeout));
+            curl_easy_setopt(easy, CURLOPT_USERAGENT, settings.user_agent.c_str());
+            curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+            curl_multi_add_handle(multi, easy);
+
+            next_allowed[host] = now + host_delay;
+            it = pending.erase(it);
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        // 处理完成的传输：解析后逐篇写回父进程
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+            if (msg->msg != CURLMSG_DONE) continue;
+
+            CURL* easy = msg->easy_handle;
+            CURLcode result = msg->data.result;
+            long http_code = 0;
+            curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &http_code);
+
+            auto node = active.extract(easy);
+            curl_multi_remove_handle(multi, easy);
+            curl_easy_cleanup(easy);
+
+            Transfer& transfer = node.mapped();
+            if (result != CURLE_OK || http_code != 200) {
+                report_done(transfer.source, result != CURLE_OK ?
+                                             curl_easy_strerror(result) :
+                                             "HTTP status " + std::to_string(http_code));
+                continue;
+            }
+
+            try {
+                for (const auto& paper : transfer.parser->parse_papers(transfer.body)) {
+                    // {"paper": ...}，直接序列化，不构建json树
+                    outbox.append("{\"paper\":");
+                    paper_json::write(paper, outbox);
+                    outbox.append("}\n");
+                }
+                report_done(transfer.source, "");
+            } catch (const std::exception& e) {
+                report_done(transfer.source, e.what());
+            }
+        }
+        send_results();
+
+        // 同时等待任务管道、结果管道（有待发结果时）和curl套接字；超时用于检查限速与停止信号
+        curl_waitfd waits[2];
+        unsigned wait_count = 0;
+        curl_waitfd* job_wait = nullptr;
+        if (jobs_open) {
+            job_wait = &waits[wait_count++];
+            *job_wait = {job_fd, CURL_WAIT_POLLIN, 0};
+        }
+        if (!outbox.empty()) {
+            waits[wait_count++] = {result_fd, CURL_WAIT_POLLOUT, 0};
+        }
+        curl_multi_poll(multi, wait_count ? waits : nullptr, wait_count, 100, nullptr);
+        send_results();
+
+        if (job_wait && (job_wait->revents & CURL_WAIT_POLLIN)) {
+            char buffer[4096];
+            ssize_t n = read(job_fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                job_buffer.append(buffer, static_cast<size_t>(n));
+                size_t newline;
+                while ((newline = job_buffer.find('\n')) != std::string::npos) {
+                    try {
+                        auto job = nlohmann::json::parse(job_buffer.substr(0, newline));
+                        pending.push_back({job.value("source", ""),
+                                           job.value("categories", std::vector<std::string>{})});
+                    } catch (const std::exception& e) {
+                        // 父进程已为该任务计数，必须回报，否则wait_completion永远等不到它
+                        report_done("hybrid", "Malformed job: " + std::string(e.what()));
+                    }
+                    job_buffer.erase(0, newline + 1);
+                }
+            } else if (n == 0 || errno != EINTR) {
+                jobs_open = false;
+            }
+        }
+    }
+
+    // 被停止时中断剩余传输并如实回报
+    for (auto& [easy, transfer] : active) {
+        curl_multi_remove_handle(multi, easy);
+        curl_easy_cleanup(easy);
+        report_done(transfer.source, "Stopped");
+    }
+    for (const auto& job : pending) {
+        report_done(job.source, "Stopped");
+    }
+
+    // 退出前把剩余结果全部写完；父进程一直在读，阻塞写不会死锁
+    set_nonblocking(result_fd, false);
+    send_results();
+
+    curl_multi_cleanup(multi);
+    curl_global_cleanup();
+    close(job_fd);
+    close(result_fd);
+    _exit(0);
+}
@@ -1,12 +1,16 @@
 #include "scheduler/ProcessScheduler.h"
+#include "network/HttpClient.h"
+#include "parser/PaperParser.h"
+#include "storage/PaperJson.h"
 #include <iostream>
 #include <chrono>
 #include <cstring>
+#include <csignal>
 #include <unistd.h>
 #include <sys/wait.h>
 
 ProcessScheduler::ProcessScheduler(size_t max_processes)
-        : max_processes_(max_processes), stop_(false) {
+        : max_processes_(max_processes) {
 }
 
 ProcessScheduler::~ProcessScheduler() {
@@ -26,10 +30,7 @@ void ProcessScheduler::schedule_crawl(const std::string& source,
             auto http_client = std::make_unique<HttpClient>();
 
             // 构建查询URL
-            auto query = parser->build_query(categories, 0, 100);
-            auto full_url = source == "arxiv" ?
-                            "https://export.arxiv.org/api/query?" + query :
-                            parser->get_source_name() + query;
+            auto full_url = build_crawl_url(*parser, source, categories);
 
             // 发送请求
             auto content = http_client->get(full_url);
@@ -41,9 +42,17 @@ void ProcessScheduler::schedule_crawl(const std::string& source,
 
             // 解析论文
             auto papers = parser->parse_papers(*content);
+            std::string line;
             for (auto& paper : papers) {
+                // 子进程继承了去重索引的映射；跳过的数量只计入子进程自己的计数
+                if (is_duplicate(paper)) {
+                    continue;
+                }
+                route_paper(paper);
                 // 将论文输出到标准输出，父进程会读取
-                std::cout << paper.to_json().dump() << std::endl;
+                line.clear();
+                paper_json::write(paper, line);
+                std::cout << line << std::endl;
             }
 
             exit(0);
@@ -75,7 +84,7 @@ void ProcessScheduler::wait_completion() {
 }
 
 void ProcessScheduler::stop() {
-    stop_.store(true);
+    stop_source_.request_stop();
 
     // 终止所有子进程
     for (pid_t pid : child_processes_) {
@@ -87,7 +96,7 @@ void ProcessScheduler::stop() {
 }
 
 bool ProcessScheduler::is_running() const {
-    return !stop_.load() && !child_processes_.empty();
+    return !stop_source_.stop_requested() && !child_processes_.empty();
 }
 
 size_t ProcessScheduler::get_completed_count() const {
@@ -0,0 +1,173 @@
+#include "scheduler/QueryPlanner.h"
+#include <algorithm>
+#include <set>
+
+namespace {
+    // 查询串中除分类之外的固定部分（基础URL、分页与排序参数）
+    constexpr size_t kQueryOverhead = 160;
+
+    // 每个分类在OR查询中的长度开销："+OR+cat:" + 分类名
+    size_t category_cost(const std::string& category) {
+        return category.size() + 8;
+    }
+
+    std::string trim(const std::string& str) {
+        auto begin = str.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) return "";
+        auto end = str.find_last_not_of(" \t\r\n");
+        return str.substr(begin, end - begin + 1);
+    }
+
+    // Paper的分类是驻留符号，PaperView的分类是文本
+    std::string_view category_text(std::string_view category) { return category; }
+    std::string_view category_text(Symbol category) { return category.str(); }
+}
+
+void QueryPlanner::add_group(const std::string& group, const std::string& source,
+                             const std::vector<std::string>& categories) {
+    auto& entry = groups_[group + "@" + source];
+    entry.source = source;
+    entry.categories.insert(entry.categories.end(), categories.begin(), categories.end());
+    entry.categories = normalize(entry.categories);
+}
+
+void QueryPlanner::set_max_query_length(const std::string& source, size_t max_length) {
+    max_query_length_[source] = max_length;
+}
+
+bool QueryPlanner::subsumes(std::string_view general, std::string_view specific) {
+    if (general.empty() || specific.size() < general.size()) {
+        return false;
+    }
+    if (!specific.starts_with(general)) {
+        return false;
+    }
+    if (specific.size() == general.size()) {
+        return true;
+    }
+
+    // "hep-" 是前缀通配；"cond-mat" 只覆盖 "cond-mat.xxx" 子分类，不覆盖 "cond-matter"
+    return general.back() == '-' || specific[general.size()] == '.';
+}
+
+std::vector<std::string> QueryPlanner::normalize(const std::vector<std::string>& categories) {
+    std::set<std::string> unique;
+    for (const auto& category : categories) {
+        auto trimmed = trim(category);
+        if (!trimmed.empty()) {
+            unique.insert(trimmed);
+        }
+    }
+
+    std::vector<std::string> result;
+    for (const auto& candidate : unique) {
+        bool covered = std::any_of(unique.begin(), unique.end(), [&](const std::string& other) {
+            return other != candidate && subsumes(other, candidate);
+        });
+        if (!covered) {
+            result.push_back(candidate);
+        }
+    }
+    return result;
+}
+
+std::vector<PlannedQuery> QueryPlanner::plan() const {
+    // 按数据源合并所有关键词组的分类
+    std::map<std::string, std::vector<std::string>> by_source;
+    for (const auto& [name, group] : groups_) {
+        auto& merged = by_source[group.source];
+        merged.insert(merged.end(), group.categories.begin(), group.categories.end());
+    }
+
+    std::vector<PlannedQuery> queries;
+    for (const auto& [source, categories] : by_source) {
+        auto limit_it = max_query_length_.find(source);
+        size_t max_length = limit_it != max_query_length_.end() ?
+                            limit_it->second : kDefaultMaxQueryLength;
+
+        for (auto& chunk : split(normalize(categories), max_length)) {
+            queries.push_back({source, std::move(chunk)});
+        }
+    }
+    return queries;
+}
+
+std::vector<std::vector<std::string>> QueryPlanner::split(const std::vector<std::string>& categories,
+                                                          size_t max_length) const {
+    if (categories.empty()) {
+        return {};
+    }
+
+    size_t budget = max_length > 2 * kQueryOverhead ? max_length - kQueryOverhead : max_length / 2;
+    size_t total = 0;
+    for (const auto& category : categories) {
+        total += category_cost(category);
+    }
+
+    // 先按最长优先分配到负载最小的查询中，超出预算则增加查询数重新分配
+    std::vector<std::string> by_cost = categories;
+    std::stable_sort(by_cost.begin(), by_cost.end(), [](const auto& a, const auto& b) {
+        return category_cost(a) > category_cost(b);
+    });
+
+    size_t bins = std::max<size_t>(1, (total + budget - 1) / budget);
+    std::vector<std::vector<std::string>> chunks;
+    while (true) {
+        chunks.assign(bins, {});
+        std::vector<size_t> loads(bins, 0);
+        for (const auto& category : by_cost) {
+            size_t target = std::min_element(loads.begin(), loads.end()) - loads.begin();
+            chunks[target].push_back(category);
+            loads[target] += category_cost(category);
+        }
+
+        bool fits = std::all_of(loads.begin(), loads.end(), [&](size_t load) {
+            return load <= budget;
+        });
+        if (fits || bins >= categories.size()) {
+            break;
+        }
+        ++bins;
+    }
+
+    for (auto& chunk : chunks) {
+        std::sort(chunk.begin(), chunk.end());
+    }
+    std::sort(chunks.begin(), chunks.end());
+    return chunks;
+}
+
+std::vector<std::string> QueryPlanner::route(const Paper& paper) const {
+    return route_categories(paper.source.str(), paper.categories);
+}
+
+std::vector<std::string> QueryPlanner::route(const PaperView& paper) const {
+    return route_categories(paper.source, paper.categories);
+}
+
+template <typename Categories>
+std::vector<std::string> QueryPlanner::route_categories(std::string_view source,
+                                                        const Categories& categories) const {
+    std::vector<std::string> matched;
+    for (const auto& [key, group] : groups_) {
+        if (group.source != source) {
+            continue;
+        }
+
+        bool wanted = std::any_of(group.categories.begin(), group.categories.end(),
+                                  [&](const std::string& requested) {
+            return std::any_of(categories.begin(), categories.end(),
+                               [&](const auto& category) {
+                return subsumes(requested, category_text(category));
+            });
+        });
+
+        if (wanted) {
+            auto name = key.substr(0, key.rfind('@'));
+            if (std::find(matched.begin(), matched.end(), name) == matched.end()) {
+                matched.push_back(std::move(name));
+            }
+        }
+    }
+    return matched;
+}
@@ -2,6 +2,11 @@
 #include "scheduler/ThreadScheduler.h"
 #include "scheduler/CoroutineScheduler.h"
 #include "scheduler/ProcessScheduler.h"
+#include "scheduler/HybridScheduler.h"
+#include "config/CrawlerConfig.h"
+#include "network/HttpClient.h"
+#include "parser/PaperParser.h"
+#include "storage/DedupIndex.h"
 #include <stdexcept>
 
 std::unique_ptr<Scheduler> Scheduler::create(const std::string& mode) {
@@ -11,14 +16,153 @@ std::unique_ptr<Scheduler> Scheduler::create(const std::string& mode) {
         return std::make_unique<CoroutineScheduler>();
     } else if (mode == "process") {
         return std::make_unique<ProcessScheduler>();
+    } else if (mode == "hybrid") {
+        const auto& settings = CrawlerConfig::getInstance().getCrawlerSettings();
+        return std::make_unique<HybridScheduler>(settings.worker_processes,
+                                                 settings.max_connections);
     }
     throw std::invalid_argument("Unknown scheduler mode: " + mode);
 }
 
+std::unique_ptr<Scheduler> Scheduler::create(CrawlerMode mode) {
+    switch (mode) {
+        case CrawlerMode::THREAD: return create("thread");
+        case CrawlerMode::COROUTINE: return create("coroutine");
+        case CrawlerMode::PROCESS: return create("process");
+        case CrawlerMode::HYBRID: return create("hybrid");
+    }
+    throw std::invalid_argument("Unknown scheduler mode");
+}
+
+std::string Scheduler::build_crawl_url(PaperParser& parser, const std::string& source,
+                                       const std::vector<std::string>& categories,
+                                       size_t start_index, size_t max_results) {
+    auto query = parser.build_query(categories, start_index, max_results);
+    return source == "arxiv" ?
+           "https://export.arxiv.org/api/query?" + query :
+           parser.get_source_name() + query;
+}
+
+void Scheduler::execute_crawl(const std::string& source,
+                              const std::vector<std::string>& categories,
+                              std::stop_token stop_token) {
+    auto content = fetch_crawl(source, categories, stop_token);
+    if (content) {
+        // 已经收到的响应即使在停止后也完整解析并交付，避免丢失半批数据
+        deliver_papers(source, std::move(*content));
+    }
+}
+
+std::optional<std::string> Scheduler::fetch_crawl(const std::string& source,
+                                                  const std::vector<std::string>& categories,
+                                                  std::stop_token stop_token) {
+    if (stop_token.stop_requested()) {
+        return std::nullopt;
+    }
+
+    try {
+        // 创建解析器和HTTP客户端
+        auto parser = PaperParser::create(source);
+        auto http_client = std::make_unique<HttpClient>();
+
+        // 构建查询URL
+        auto full_url = build_crawl_url(*parser, source, categories);
+
+        // 发送请求，停止请求会立即中断传输
+        auto content = http_client->get(full_url, stop_token);
+        if (!content && !stop_token.stop_requested()) {
+            notify_error(source, "Failed to fetch data from " + source);
+        }
+        return content;
+    } catch (const std::exception& e) {
+        notify_error(source, "Exception occurred: " + std::string(e.what()));
+        return std::nullopt;
+    }
+}
+
+void Scheduler::deliver_papers(const std::string& source, std::string content) {
+    try {
+        // 解析论文
+        auto parser = PaperParser::create(source);
+        // 超过阈值的大响应按记录边界切分，在解析线程池上并行解析
+        size_t threshold =
+                CrawlerConfig::getInstance().getCrawlerSettings().parallel_parse_threshold_kb * 1024;
+        bool parallel = parse_parallelism() > 1 && threshold > 0 && content.size() >= threshold;
+
+        // 只有视图消费者时零拷贝解析：视图直接引用响应体，响应体由视图共同持有
+        if (view_callback_ && !paper_callback_ && !parallel) {
+            auto response = std::make_shared<const std::string>(std::move(content));
+            auto views = parser->parse_views(response);
+            for (auto& view : views) {
+                if (is_duplicate(view)) {
+                    continue;
+                }
+                if (query_planner_) {
+                    view.keywords = query_planner_->route(view);
+                }
+                notify_view(view);
+            }
+            notify_progress(1, 1, "Completed crawling " + source);
+            return;
+        }
+
+        // 一个响应的论文分配在同一个arena上，回调写完后随arena一次性释放
+        PaperArena arena;
+        auto papers = parser->parse_papers_parallel(
+                content, parse_parallelism(), threshold,
+                [this](std::function<void()> task) { post_parse_task(std::move(task)); }, arena);
+        for (auto& paper : papers) {
+            if (is_duplicate(paper)) {
+                continue;
+            }
+            route_paper(paper);
+            notify_paper(paper);
+        }
+
+        // 更新进度
+        notify_progress(1, 1, "Completed crawling " + source);
+    } catch (const std::exception& e) {
+        notify_error(source, "Exception occurred: " + std::string(e.what()));
+    }
+}
+
+template <typename PaperT>
+bool Scheduler::is_duplicate(const PaperT& paper) {
+    // 去重索引中已有相同或更新版本的论文不再交付，省去路由和写入
+    if (dedup_index_ && dedup_index_->contains(paper)) {
+        duplicates_skipped_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+// Used by the schedulers that deliver whole Papers themselves
+template bool Scheduler::is_duplicate(const Paper& paper);
+template bool Scheduler::is_duplicate(const PaperView& paper);
+
+void Scheduler::route_paper(Paper& paper) const {
+    if (query_planner_) {
+        auto groups = query_planner_->route(paper);
+        paper.keywords.assign(groups.begin(), groups.end());
+    }
+}
+
 void Scheduler::notify_paper(const Paper& paper) {
     if (paper_callback_) {
         paper_callback_(paper);
     }
+    if (view_callback_) {
+        view_callback_(PaperView::of(paper));
+    }
+}
+
+void Scheduler::notify_view(const PaperView& view) {
+    if (view_callback_) {
+        view_callback_(view);
+    }
+    if (paper_callback_) {
+        paper_callback_(view.to_paper());
+    }
 }
 
 void Scheduler::notify_progress(size_t completed, size_t total, const std::string& message) {
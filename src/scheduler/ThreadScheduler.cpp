@@ -1,14 +1,23 @@
 #include "scheduler/ThreadScheduler.h"
-#include "network/HttpClient.h"
-#include "parser/PaperParser.h"
 #include <iostream>
 #include <chrono>
 
 ThreadScheduler::ThreadScheduler(size_t thread_count)
-        : stop_(false), active_tasks_(0) {
-    // 创建工作线程
-    for (size_t i = 0; i < thread_count; ++i) {
-        workers_.emplace_back([this] { worker_thread(); });
+        : active_tasks_(0) {
+    thread_count = std::max<size_t>(thread_count, 1);
+    size_t network_count = CpuAffinity::worker_count(PipelineStage::NETWORK, thread_count);
+    size_t parse_count = CpuAffinity::worker_count(PipelineStage::PARSE, thread_count);
+
+    // 创建网络阶段和解析阶段的工作线程，各阶段配置了CPU集合时线程数等于其CPU数
+    for (size_t i = 0; i < network_count; ++i) {
+        network_workers_.emplace_back([this] {
+            worker_thread(network_queue_, PipelineStage::NETWORK, stop_source_.get_token());
+        });
+    }
+    for (size_t i = 0; i < parse_count; ++i) {
+        parse_workers_.emplace_back([this] {
+            worker_thread(parse_queue_, PipelineStage::PARSE, parse_stop_.get_token());
+        });
     }
 }
 
@@ -18,82 +27,87 @@ ThreadScheduler::~ThreadScheduler() {
 
 void ThreadScheduler::schedule_crawl(const std::string& source,
                                      const std::vector<std::string>& categories) {
-    // 将爬取任务包装成函数对象添加到任务队列
+    // 网络阶段只负责抓取，响应体交给解析阶段
     auto task = [this, source, categories]() {
-        try {
-            // 创建解析器和HTTP客户端
-            auto parser = PaperParser::create(source);
-            auto http_client = std::make_unique<HttpClient>();
-
-            // 构建查询URL
-            auto query = parser->build_query(categories, 0, 100);
-            auto full_url = source == "arxiv" ?
-                            "https://export.arxiv.org/api/query?" + query :
-                            parser->get_source_name() + query;
-
-            // 发送请求
-            auto content = http_client->get(full_url);
-            if (!content) {
-                notify_error(source, "Failed to fetch data from " + source);
-                return;
-            }
-
-            // 解析论文
-            auto papers = parser->parse_papers(*content);
-            for (auto& paper : papers) {
-                notify_paper(paper);
-            }
-
-            // 更新进度
-            notify_progress(1, 1, "Completed crawling " + source);
-        } catch (const std::exception& e) {
-            notify_error(source, "Exception occurred: " + std::string(e.what()));
+        auto content = fetch_crawl(source, categories, stop_source_.get_token());
+        if (!content) {
+            active_tasks_--;
+            return;
         }
+
+        // 即使已请求停止也交给解析阶段：stop()会等网络线程退出后再让解析线程处理完队列
+        enqueue(parse_queue_, [this, source, body = std::move(*content)]() mutable {
+            deliver_papers(source, std::move(body));
+            active_tasks_--;
+        });
     };
 
-    // 将任务加入队列
+    active_tasks_++;
+    enqueue(network_queue_, std::move(task));
+}
+
+void ThreadScheduler::enqueue(StageQueue& queue, std::function<void()> task) {
     {
-        std::lock_guard lock(queue_mutex_);
-        tasks_.push(std::move(task));
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push(std::move(task));
     }
-    condition_.notify_one();
+    queue.condition.notify_one();
 }
 
-void ThreadScheduler::worker_thread() {
+size_t ThreadScheduler::clear(StageQueue& queue) {
+    std::lock_guard lock(queue.mutex);
+    size_t dropped = queue.tasks.size();
+    std::queue<std::function<void()>>().swap(queue.tasks);
+    return dropped;
+}
+
+void ThreadScheduler::worker_thread(StageQueue& queue, PipelineStage stage,
+                                    std::stop_token stop_token) {
+    CpuAffinity::pin_current_thread(stage);
+
     while (true) {
         std::function<void()> task;
 
         {
-            std::unique_lock lock(queue_mutex_);
-            condition_.wait(lock, [this] {
-                return stop_.load() || !tasks_.empty();
+            std::unique_lock lock(queue.mutex);
+            queue.condition.wait(lock, stop_token, [&queue] {
+                return !queue.tasks.empty();
             });
 
-            if (stop_.load() && tasks_.empty()) {
+            // 网络阶段停止后不再领取新任务；解析阶段在停止前会处理完队列
+            if (queue.tasks.empty() ||
+                (stage == PipelineStage::NETWORK && stop_token.stop_requested())) {
                 break;
             }
 
-            task = std::move(tasks_.front());
-            tasks_.pop();
-            active_tasks_++;
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop();
         }
 
         task();
-        active_tasks_--;
     }
 }
 
 void ThreadScheduler::wait_completion() {
-    while (active_tasks_.load() > 0 || !tasks_.empty()) {
+    while (active_tasks_.load() > 0) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 }
 
 void ThreadScheduler::stop() {
-    stop_.store(true);
-    condition_.notify_all();
+    // 请求停止会唤醒等待中的网络线程，并中断正在进行的HTTP传输
+    stop_source_.request_stop();
+    active_tasks_ -= clear(network_queue_);
 
-    for (auto& worker : workers_) {
+    for (auto& worker : network_workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // 网络阶段结束后，解析阶段把已抓取的响应处理完再退出
+    parse_stop_.request_stop();
+    for (auto& worker : parse_workers_) {
         if (worker.joinable()) {
             worker.join();
         }
@@ -101,7 +115,7 @@ void ThreadScheduler::stop() {
 }
 
 bool ThreadScheduler::is_running() const {
-    return !stop_.load() && (active_tasks_.load() > 0 || !tasks_.empty());
+    return !stop_source_.stop_requested() && active_tasks_.load() > 0;
 }
 
 size_t ThreadScheduler::get_completed_count() const {
@@ -115,6 +129,14 @@ size_t ThreadScheduler::get_failed_count() const {
 }
 
 size_t ThreadScheduler::get_queued_count() const {
-    std::lock_guard lock(queue_mutex_);
-    return tasks_.size();
-}
\ No newline at end of file
+    size_t queued = 0;
+    {
+        std::lock_guard lock(network_queue_.mutex);
+        queued += network_queue_.tasks.size();
+    }
+    {
+        std::lock_guard lock(parse_queue_.mutex);
+        queued += parse_queue_.tasks.size();
+    }
+    return queued;
+}
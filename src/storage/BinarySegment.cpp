@@ -0,0 +1,489 @@
+#include "storage/BinarySegment.h"
+#include "storage/PaperRecord.h"
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <utility>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+    uint32_t load_u32(const unsigned char* p) {
+        return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+               static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+    }
+
+    uint64_t load_u64(const unsigned char* p) {
+        return static_cast<uint64_t>(load_u32(p)) | static_cast<uint64_t>(load_u32(p + 4)) << 32;
+    }
+
+    void put_u32(uint32_t value, std::string& out) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    void put_u64(uint64_t value, std::string& out) {
+        put_u32(static_cast<uint32_t>(value), out);
+        put_u32(static_cast<uint32_t>(value >> 32), out);
+    }
+
+    bool write_all(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t count = ::write(fd, data, size);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += count;
+            size -= static_cast<size_t>(count);
+        }
+        return true;
+    }
+
+    // Size of the intact record at `record`, header included, or 0 if it is
+    // torn (longer than `available`) or fails its checksum
+    uint64_t intact_record_size(const unsigned char* record, uint64_t available) {
+        using namespace binary_segment;
+        if (available < kRecordHeaderSize) {
+            return 0;
+        }
+        uint64_t payload = load_u32(record);
+        if (payload > available - kRecordHeaderSize) {
+            return 0;
+        }
+        if (paper_record::crc32c(record + kRecordHeaderSize, payload) != load_u32(record + 4)) {
+            return 0;
+        }
+        return kRecordHeaderSize + payload;
+    }
+}
+
+BinarySegmentWriter::BinarySegmentWriter(FsyncPolicy policy, size_t buffer_bytes,
+                                         std::optional<seekable_zstd::Options> compression)
+        : policy_(policy), buffer_bytes_(buffer_bytes) {
+    if (compression) {
+        compressor_ = std::make_unique<SeekableZstdWriter>(*compression);
+    }
+}
+
+BinarySegmentWriter::~BinarySegmentWriter() {
+    close();
+}
+
+bool BinarySegmentWriter::open(const std::string& path) {
+    if (is_open() && !close()) {
+        return false;
+    }
+
+    offsets_.clear();
+    buffer_.clear();
+    file_size_ = 0;
+    stream_size_ = 0;
+    if (compressor_) {
+        compressor_->reset();
+    }
+
+    // An existing segment keeps its intact records; the footer is rewritten
+    // on close()
+    std::error_code error;
+    auto existing_size = std::filesystem::file_size(path, error);
+    if (!error && existing_size > 0) {
+        BinarySegmentReader existing;
+        if (!existing.open(path)) {
+            std::cerr << "Not a binary segment, refusing to append: " << path << std::endl;
+            return false;
+        }
+        if ((existing.frames() != nullptr) != (compressor_ != nullptr)) {
+            std::cerr << "Binary segment compression differs, refusing to append: " << path << std::endl;
+            return false;
+        }
+        offsets_.reserve(existing.size());
+        for (size_t i = 0; i < existing.size(); ++i) {
+            offsets_.push_back(existing.offset(i));
+        }
+        stream_size_ = existing.records_end();
+        if (compressor_) {
+            resume(existing);
+        } else {
+            file_size_ = stream_size_;
+        }
+        if (!existing.has_footer() && file_size_ < existing_size) {
+            std::cerr << "Truncating incomplete record at the end of " << path << std::endl;
+        }
+    }
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (stream_size_ == 0) {
+        std::string header(binary_segment::kMagic);
+        put_u32(binary_segment::kVersion, header);
+        put_u32(0, header);
+        // A compressed header goes out with the first frame
+        put(header);
+        if (::ftruncate(fd, 0) != 0 || !write_all(fd, buffer_.data(), buffer_.size())) {
+            std::cerr << "Failed to write " << path << ": " << std::strerror(errno) << std::endl;
+            ::close(fd);
+            return false;
+        }
+        file_size_ = buffer_.size();
+        buffer_.clear();
+    } else if (::ftruncate(fd, static_cast<off_t>(file_size_)) != 0 ||
+               ::lseek(fd, static_cast<off_t>(file_size_), SEEK_SET) < 0) {
+        std::cerr << "Failed to reopen " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    return true;
+}
+
+void BinarySegmentWriter::resume(const BinarySegmentReader& existing) {
+    // Complete frames before the end of the intact records stay as they are;
+    // the intact records of the frame after them (which also held a torn
+    // record or the footer) are compressed again
+    const SeekableZstdReader& frames = *existing.frames();
+    size_t keep = frames.frame_at(stream_size_);
+    compressor_->resume(frames.entries(keep));
+    if (keep < frames.frame_count() && stream_size_ > frames.frame_offset(keep)) {
+        compressor_->append(frames.frame(keep).substr(0, stream_size_ - frames.frame_offset(keep)));
+    }
+    file_size_ = compressor_->compressed_size();
+}
+
+void BinarySegmentWriter::put(std::string_view data) {
+    stream_size_ += data.size();
+    if (compressor_) {
+        compressor_->append(data);
+    } else {
+        buffer_.append(data);
+    }
+}
+
+bool BinarySegmentWriter::end_record() {
+    // Frames end between records only
+    if (compressor_ && compressor_->frame_full() && !compressor_->end_frame(buffer_)) {
+        return false;
+    }
+    if (buffer_.size() >= buffer_bytes_) {
+        return write_buffer();
+    }
+    return true;
+}
+
+bool BinarySegmentWriter::append(std::string_view payload) {
+    if (!is_open()) {
+        return false;
+    }
+
+    offsets_.push_back(stream_size_);
+    std::string header;
+    header.reserve(binary_segment::kRecordHeaderSize);
+    put_u32(static_cast<uint32_t>(payload.size()), header);
+    put_u32(paper_record::crc32c(payload.data(), payload.size()), header);
+    put(header);
+    put(payload);
+    return end_record();
+}
+
+bool BinarySegmentWriter::write_buffer() {
+    if (buffer_.empty()) {
+        return true;
+    }
+    if (!write_all(fd_, buffer_.data(), buffer_.size())) {
+        std::cerr << "Binary segment write failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    file_size_ += buffer_.size();
+    buffer_.clear();
+    return true;
+}
+
+bool BinarySegmentWriter::flush() {
+    if (!is_open()) {
+        return true;
+    }
+    if ((compressor_ && !compressor_->end_frame(buffer_)) || !write_buffer()) {
+        return false;
+    }
+    if (policy_ != FsyncPolicy::NONE && ::fdatasync(fd_) != 0) {
+        std::cerr << "Binary segment fdatasync failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool BinarySegmentWriter::close() {
+    if (!is_open()) {
+        return true;
+    }
+
+    // Footer: the offsets, then where they start and a checksum over them.
+    // Compressed, it is a frame of its own followed by the seek table.
+    bool ok = !compressor_ || compressor_->end_frame(buffer_);
+    uint64_t footer_offset = stream_size_;
+    std::string footer;
+    footer.reserve(offsets_.size() * 8 + binary_segment::kTrailerSize);
+    for (uint64_t offset : offsets_) {
+        put_u64(offset, footer);
+    }
+    uint32_t crc = paper_record::crc32c(footer.data(), footer.size());
+    put_u64(footer_offset, footer);
+    put_u64(offsets_.size(), footer);
+    put_u32(crc, footer);
+    put_u32(0, footer);
+    footer.append(binary_segment::kFooterMagic);
+    put(footer);
+
+    ok = ok && (!compressor_ || compressor_->finish(buffer_));
+    ok = ok && write_buffer();
+    if (ok && policy_ != FsyncPolicy::NONE && ::fdatasync(fd_) != 0) {
+        std::cerr << "Binary segment fdatasync failed: " << std::strerror(errno) << std::endl;
+        ok = false;
+    }
+    ::close(fd_);
+    fd_ = -1;
+    offsets_.clear();
+    buffer_.clear();
+    return ok;
+}
+
+BinarySegmentReader::~BinarySegmentReader() {
+    close();
+}
+
+BinarySegmentReader::BinarySegmentReader(BinarySegmentReader&& other) noexcept {
+    *this = std::move(other);
+}
+
+BinarySegmentReader& BinarySegmentReader::operator=(BinarySegmentReader&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        mapped_size_ = std::exchange(other.mapped_size_, 0);
+        frames_ = std::move(other.frames_);
+        stream_size_ = std::exchange(other.stream_size_, 0);
+        index_ = std::exchange(other.index_, nullptr);
+        scanned_ = std::move(other.scanned_);
+        record_count_ = std::exchange(other.record_count_, 0);
+        records_end_ = std::exchange(other.records_end_, 0);
+        sequential_ = std::exchange(other.sequential_, false);
+        for (size_t i = 0; i < 2; ++i) {
+            recent_[i] = std::exchange(other.recent_[i], {});
+        }
+        last_used_ = other.last_used_;
+    }
+    return *this;
+}
+
+bool BinarySegmentReader::open(const std::string& path) {
+    using namespace binary_segment;
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    data_ = static_cast<const unsigned char*>(mapping);
+    mapped_size_ = size;
+
+    // Offsets below refer to the decompressed stream of a compressed segment
+    if (seekable_zstd::is_compressed(data_, size)) {
+        frames_ = std::make_unique<SeekableZstdReader>();
+        if (!frames_->open(data_, size)) {
+            close();
+            return false;
+        }
+        stream_size_ = frames_->size();
+        if (frames_->frame_count() == 0) {
+            return true;  // the writer crashed before its first frame: empty
+        }
+    } else {
+        stream_size_ = size;
+    }
+
+    // Only the footer index is kept: it is what offset() reads later
+    uint64_t available = 0;
+    const unsigned char* header = streamed_at(0, stream_size_, available);
+    if (!header || available < kHeaderSize ||
+        std::memcmp(header, kMagic.data(), kMagic.size()) != 0 || load_u32(header + 8) != kVersion) {
+        close();
+        return false;
+    }
+
+    // A valid footer describes the stream exactly
+    if (stream_size_ >= kHeaderSize + kTrailerSize) {
+        const unsigned char* trailer = streamed_at(stream_size_ - kTrailerSize, stream_size_, available);
+        uint64_t footer_offset = trailer && available == kTrailerSize ? load_u64(trailer) : 0;
+        uint64_t count = trailer ? load_u64(trailer + 8) : 0;
+        if (trailer && std::memcmp(trailer + 24, kFooterMagic.data(), kFooterMagic.size()) == 0 &&
+            footer_offset >= kHeaderSize && footer_offset <= stream_size_ - kTrailerSize &&
+            count == (stream_size_ - kTrailerSize - footer_offset) / 8 &&
+            footer_offset + count * 8 + kTrailerSize == stream_size_) {
+            const unsigned char* index = pinned_at(footer_offset, stream_size_, available);
+            if (index && available == stream_size_ - footer_offset &&
+                paper_record::crc32c(index, count * 8) == load_u32(trailer + 16)) {
+                index_ = index;
+                record_count_ = static_cast<size_t>(count);
+                records_end_ = footer_offset;
+                return true;
+            }
+        }
+    }
+
+    // No footer: the writer did not close the segment. Keep every record up
+    // to the first torn or corrupt one.
+    uint64_t offset = kHeaderSize;
+    while (const unsigned char* record = streamed_at(offset, stream_size_, available)) {
+        uint64_t record_size = intact_record_size(record, available);
+        if (record_size == 0) {
+            break;
+        }
+        scanned_.push_back(offset);
+        offset += record_size;
+    }
+    record_count_ = scanned_.size();
+    records_end_ = offset;
+    return true;
+}
+
+void BinarySegmentReader::close() {
+    frames_.reset();
+    if (data_) {
+        ::munmap(const_cast<unsigned char*>(data_), mapped_size_);
+    }
+    data_ = nullptr;
+    mapped_size_ = 0;
+    stream_size_ = 0;
+    index_ = nullptr;
+    scanned_.clear();
+    record_count_ = 0;
+    records_end_ = 0;
+    sequential_ = false;
+    for (auto& frame : recent_) {
+        frame = {};
+    }
+}
+
+const unsigned char* BinarySegmentReader::at(uint64_t offset, uint64_t end, uint64_t& available) const {
+    return sequential_ ? streamed_at(offset, end, available) : pinned_at(offset, end, available);
+}
+
+const unsigned char* BinarySegmentReader::pinned_at(uint64_t offset, uint64_t end, uint64_t& available) const {
+    if (offset >= end) {
+        return nullptr;
+    }
+    if (!frames_) {
+        available = end - offset;
+        return data_ + offset;
+    }
+    // Records never span frames, so one frame holds a whole record
+    size_t index = frames_->frame_at(offset);
+    auto frame = frames_->frame(index);
+    if (frame.empty()) {
+        return nullptr;
+    }
+    available = std::min(end, frames_->frame_end(index)) - offset;
+    return reinterpret_cast<const unsigned char*>(frame.data()) + (offset - frames_->frame_offset(index));
+}
+
+const unsigned char* BinarySegmentReader::streamed_at(uint64_t offset, uint64_t end, uint64_t& available) const {
+    if (offset >= end) {
+        return nullptr;
+    }
+    if (!frames_) {
+        available = end - offset;
+        return data_ + offset;
+    }
+    size_t index = frames_->frame_at(offset);
+    if (index >= frames_->frame_count()) {
+        return nullptr;
+    }
+    // Two slots, so the previous record's view survives crossing into the
+    // next frame; the slot not read last is the one replaced
+    if (recent_[last_used_].index != index) {
+        last_used_ ^= 1;
+        auto& slot = recent_[last_used_];
+        if (slot.index != index) {
+            slot.index = frames_->read_frame(index, slot.data) ? index : SIZE_MAX;
+        }
+        if (slot.index != index) {
+            return nullptr;
+        }
+    }
+    const auto& frame = recent_[last_used_];
+    available = std::min(end, frames_->frame_end(index)) - offset;
+    return reinterpret_cast<const unsigned char*>(frame.data.data()) + (offset - frames_->frame_offset(index));
+}
+
+uint64_t BinarySegmentReader::offset(size_t index) const {
+    return index_ ? load_u64(index_ + index * 8) : scanned_[index];
+}
+
+std::optional<std::string_view> BinarySegmentReader::record(size_t index) const {
+    if (index >= record_count_) {
+        return std::nullopt;
+    }
+    uint64_t start = offset(index);
+    uint64_t available = 0;
+    const unsigned char* p = start >= binary_segment::kHeaderSize ? at(start, records_end_, available) : nullptr;
+    if (!p || !intact_record_size(p, available)) {
+        return std::nullopt;
+    }
+    auto payload = reinterpret_cast<const char*>(p + binary_segment::kRecordHeaderSize);
+    return std::string_view(payload, load_u32(p));
+}
+
+bool BinarySegmentReader::read(size_t index, Paper& paper) const {
+    auto payload = record(index);
+    return payload && paper_record::decode(*payload, paper);
+}
+
+bool BinarySegmentReader::read(size_t index, PaperView& paper) const {
+    auto payload = record(index);
+    return payload && paper_record::decode(*payload, paper);
+}
+
+std::vector<Paper> BinarySegmentReader::read_all() {
+    std::vector<Paper> papers;
+    papers.reserve(record_count_);
+    advise_sequential();
+    for (size_t i = 0; i < record_count_; ++i) {
+        Paper paper;
+        if (read(i, paper)) {
+            papers.push_back(std::move(paper));
+        }
+    }
+    return papers;
+}
+
+void BinarySegmentReader::advise_sequential() {
+    sequential_ = true;
+    if (data_) {
+        auto* address = const_cast<unsigned char*>(data_);
+        ::madvise(address, mapped_size_, MADV_SEQUENTIAL);
+        ::madvise(address, mapped_size_, MADV_WILLNEED);
+    }
+}
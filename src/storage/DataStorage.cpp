@@ -1,14 +1,195 @@
 #include "storage/DataStorage.h"
+#include "storage/PaperJson.h"
+#include "storage/PaperRecord.h"
 #include <filesystem>
 #include <iostream>
 #include <chrono>
 #include <iomanip>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <bit>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-DataStorage::DataStorage() : current_size_(0) {
+namespace {
+    constexpr const char* kManifestName = "manifest.json";
+
+    // Consecutive threads get consecutive slots, so with ShardBy::THREAD a
+    // pool of N workers spreads evenly over N shards
+    size_t thread_slot() {
+        static std::atomic<size_t> next_slot{0};
+        thread_local size_t slot = next_slot++;
+        return slot;
+    }
+
+    // Extension naming the format: ".jsonl" for "papers.jsonl.zst"
+    std::filesystem::path format_extension(const std::filesystem::path& path) {
+        auto extension = path.extension();
+        return extension == ".zst" ? path.stem().extension() : extension;
+    }
+
+    bool is_data_file(const std::filesystem::path& path) {
+        auto extension = format_extension(path);
+        return extension == ".json" || extension == ".jsonl" || extension == ".bin" ||
+               extension == ".csv" || extension == ".xml";
+    }
+
+    std::string_view text_of(std::string_view text) { return text; }
+    std::string_view text_of(Symbol symbol) { return symbol.str(); }
+
+    // Postings a shard collects before appending them to the index
+    constexpr size_t kIndexBatchPostings = 64 * 1024;
+
+    // Read-only mapping of a whole file; empty if it cannot be mapped
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return;
+            }
+            struct stat info{};
+            if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+                void* mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping != MAP_FAILED) {
+                    data_ = static_cast<const char*>(mapping);
+                    size_ = static_cast<size_t>(info.st_size);
+                }
+            }
+            ::close(fd);
+        }
+        ~MappedFile() {
+            if (data_) {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::string_view data() const { return {data_, size_}; }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    // Calls visit(offset, line) for every line of a jsonl file, compressed
+    // or not, until it returns false; offsets are in the uncompressed stream.
+    // Only complete frames of a .jsonl.zst are read, one at a time, and lines
+    // never span two of them. With a range, only the lines that start in
+    // [begin, end) are visited, or in a .jsonl.zst the frames that do.
+    template <typename Visit>
+    void for_each_jsonl_line(const std::filesystem::path& path, Visit visit,
+                             uint64_t begin = 0, uint64_t end = UINT64_MAX) {
+        MappedFile file(path.string());
+        auto visit_lines = [&visit](std::string_view text, uint64_t base, size_t start, uint64_t stop) {
+            while (start < text.size() && base + start < stop) {
+                size_t end = std::min(text.find('\n', start), text.size());
+                if (end > start && !visit(base + start, text.substr(start, end - start))) {
+                    return false;
+                }
+                start = end + 1;
+            }
+            return true;
+        };
+
+        if (path.extension() != ".zst") {
+            auto text = file.data();
+            // A line that starts before `begin` belongs to the range before
+            size_t start = std::min<uint64_t>(begin, text.size());
+            if (start > 0 && text[start - 1] != '\n') {
+                start = std::min(text.find('\n', start), text.size() - 1) + 1;
+            }
+            visit_lines(text, 0, start, end);
+            return;
+        }
+        SeekableZstdReader reader;
+        if (!reader.open(file.data().data(), file.data().size())) {
+            return;
+        }
+        size_t first = reader.frame_at(begin);
+        if (first < reader.frame_count() && reader.frame_offset(first) < begin) {
+            ++first;
+        }
+        std::string frame;
+        for (size_t i = first; i < reader.frame_count() && reader.frame_offset(i) < end; ++i) {
+            if (reader.read_frame(i, frame) && !visit_lines(frame, reader.frame_offset(i), 0, UINT64_MAX)) {
+                return;
+            }
+        }
+    }
+
+    // False if a jsonl line cannot pass `filter`, judged from its text: the
+    // writers emit compact JSON, so a matching line holds the quoted values.
+    // Values that JSON might escape are left to the parsed paper.
+    bool line_may_match(std::string_view line, const ScanFilter& filter) {
+        auto plain = [](std::string_view value) {
+            return std::all_of(value.begin(), value.end(),
+                               [](char c) { return c >= 0x20 && c < 0x7f && c != '"' && c != '\\'; });
+        };
+        if (!filter.source.empty() && plain(filter.source) &&
+            line.find("\"source\":\"" + filter.source + "\"") == std::string_view::npos) {
+            return false;
+        }
+        if (!filter.category.empty() && plain(filter.category) &&
+            line.find("\"" + filter.category + "\"") == std::string_view::npos) {
+            return false;
+        }
+        return true;
+    }
+
+    // Target size of a load_parallel() range, in file bytes: large enough to
+    // amortise opening the file, small enough to spread a big file over
+    // every thread
+    constexpr uint64_t kLoadRangeBytes = 4 * 1024 * 1024;
+    // Index candidates per range when the secondary index picks the records
+    constexpr size_t kLoadRangeRecords = 8192;
+    // Unordered loads hand papers to emit in batches of this many
+    constexpr size_t kLoadBatchPapers = 512;
+
+    // The line at `offset` of a jsonl stream; empty if there is none
+    std::string_view line_at(std::string_view text, uint64_t offset) {
+        if (offset >= text.size()) {
+            return {};
+        }
+        text.remove_prefix(offset);
+        return text.substr(0, text.find('\n'));
+    }
+}
+
+std::optional<ShardBy> parse_shard_by(const std::string& name) {
+    if (name == "thread") return ShardBy::THREAD;
+    if (name == "id") return ShardBy::PAPER_ID;
+    return std::nullopt;
+}
+
+std::optional<Compression> parse_compression(const std::string& name) {
+    if (name == "none") return Compression::NONE;
+    if (name == "zstd") return Compression::ZSTD;
+    return std::nullopt;
 }
 
+DataStorage::DataStorage() = default;
+
 DataStorage::~DataStorage() {
-    close_current_file();
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard->mutex);
+        close_current_file(*shard);
+    }
+    if (dedup_index_) {
+        dedup_index_->close();
+    }
+    if (secondary_index_) {
+        secondary_index_->close();
+    }
 }
 
 bool DataStorage::initialize(const std::string& output_dir, const std::string& format) {
@@ -17,40 +198,359 @@ bool DataStorage::initialize(const std::string& output_dir, const std::string& f
 
     // Create output directory if it doesn't exist
     std::filesystem::create_directories(output_dir_);
+    load_manifest();
+    if (dedup_enabled_ && !open_dedup_index()) {
+        return false;
+    }
+    secondary_index_.reset();
+    if (secondary_index_enabled_ && (format_ == "jsonl" || format_ == "bin") && !open_secondary_index(false)) {
+        return false;
+    }
+
+    shards_.clear();
+    for (size_t i = 0; i < shard_count_; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->index = i;
+        if (format_ == "jsonl") {
+            shard->jsonl_writer = std::make_unique<JsonlWriter>(fsync_policy_, fsync_interval_,
+                                                                4 * 1024 * 1024, segment_compression());
+        } else if (format_ == "bin") {
+            shard->bin_writer = std::make_unique<BinarySegmentWriter>(fsync_policy_, 1024 * 1024,
+                                                                      segment_compression());
+        } else if (format_ == "parquet") {
+            shard->parquet_writer = std::make_unique<ParquetWriter>(parquet_options_);
+        }
+        shards_.push_back(std::move(shard));
+    }
+
+    bool success = true;
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard->mutex);
+        success = open_new_file(*shard) && success;
+    }
+    return success;
+}
+
+bool DataStorage::open_for_reading(const std::string& data_dir) {
+    if (!std::filesystem::is_directory(data_dir)) {
+        std::cerr << "No data directory " << data_dir << std::endl;
+        return false;
+    }
+    output_dir_ = data_dir;
+    shards_.clear();
+    secondary_index_.reset();
+    if (secondary_index_enabled_ && std::filesystem::is_directory(std::filesystem::path(data_dir) / "index")) {
+        open_secondary_index(true);
+    }
+    return true;
+}
+
+void DataStorage::set_fsync_policy(FsyncPolicy policy, std::chrono::milliseconds interval) {
+    fsync_policy_ = policy;
+    fsync_interval_ = interval;
+}
+
+void DataStorage::set_compression(Compression compression, int level, size_t frame_bytes) {
+    if (compression == Compression::ZSTD && !seekable_zstd::available()) {
+        std::cerr << "Built without zstd (CRAWLER_USE_ZSTD), storing uncompressed" << std::endl;
+        compression = Compression::NONE;
+    }
+    compression_ = compression;
+    compression_options_.level = level;
+    compression_options_.frame_bytes = std::max<size_t>(frame_bytes, 1);
+    compression_options_.stats = &compression_stats_;
+}
+
+void DataStorage::set_dedup(bool enabled, size_t expected_papers) {
+    dedup_enabled_ = enabled;
+    dedup_expected_papers_ = expected_papers;
+}
+
+bool DataStorage::open_dedup_index() {
+    // An id and a DOI per paper
+    DedupIndex::Options options;
+    options.initial_capacity = std::bit_ceil(static_cast<size_t>(
+            2.0 * static_cast<double>(std::max<size_t>(dedup_expected_papers_, 1)) / options.max_load));
+    auto index = std::make_shared<DedupIndex>(options);
+    if (!index->open((std::filesystem::path(output_dir_) / "index").string())) {
+        std::cerr << "Failed to open the dedup index in " << output_dir_ << std::endl;
+        return false;
+    }
+
+    if (index->needs_rebuild()) {
+        index->clear();
+        auto files = data_files();
+        if (!files.empty()) {
+            std::cout << "Rebuilding dedup index from " << files.size() << " data files..." << std::endl;
+        }
+        for (const auto& path : files) {
+            for (const auto& paper : read_papers_file(path)) {
+                index->record(paper);
+            }
+        }
+    }
+    dedup_index_ = std::move(index);
+    return true;
+}
+
+bool DataStorage::open_secondary_index(bool read_only) {
+    auto index = std::make_unique<SecondaryIndex>();
+    if (!index->open((std::filesystem::path(output_dir_) / "index").string(), read_only)) {
+        std::cerr << "Failed to open the secondary index in " << output_dir_ << std::endl;
+        return false;
+    }
+    if (!index->needs_rebuild()) {
+        secondary_index_ = std::move(index);
+        return true;
+    }
+    if (read_only) {
+        return true;  // stale or still being written: scan instead
+    }
+
+    index->clear();
+    secondary_index_ = std::move(index);
+    auto files = data_files();
+    if (!files.empty()) {
+        std::cout << "Rebuilding secondary index from " << files.size() << " data files..." << std::endl;
+    }
+    SecondaryIndex::Batch batch;
+    for (const auto& path : files) {
+        index_data_file(path, batch);
+    }
+    return secondary_index_->write(batch);
+}
+
+void DataStorage::index_data_file(const std::filesystem::path& path, SecondaryIndex::Batch& batch) {
+    auto extension = format_extension(path);
+    if (extension != ".jsonl" && extension != ".bin") {
+        return;  // not indexed: loaders scan it
+    }
+    uint32_t file = secondary_index_->file_id(path.filename().string());
+    auto add = [&](const Paper& paper, uint64_t position) {
+        batch.add(paper, {file, position});
+        if (batch.size() >= kIndexBatchPostings) {
+            secondary_index_->write(batch);
+        }
+    };
+
+    if (extension == ".bin") {
+        BinarySegmentReader reader;
+        if (!reader.open(path.string())) {
+            return;
+        }
+        reader.advise_sequential();
+        Paper paper;
+        for (size_t i = 0; i < reader.size(); ++i) {
+            if (reader.read(i, paper)) {
+                add(paper, i);
+            }
+        }
+        return;
+    }
+    for_each_jsonl_line(path, [&](uint64_t offset, std::string_view line) {
+        try {
+            add(Paper::from_json(nlohmann::json::parse(line)), offset);
+        } catch (const std::exception& e) {
+        }
+        return true;
+    });
+}
 
-    // Generate initial filename
-    current_filename_ = generate_filename();
+void DataStorage::write_index_batch(Shard& shard) {
+    if (secondary_index_ && !shard.index_batch.empty()) {
+        secondary_index_->write(shard.index_batch);
+    }
+}
 
-    return open_new_file();
+std::optional<seekable_zstd::Options> DataStorage::segment_compression() {
+    if (compression_ == Compression::ZSTD && (format_ == "jsonl" || format_ == "bin")) {
+        return compression_options_;
+    }
+    return std::nullopt;
+}
+
+void DataStorage::set_sharding(size_t shard_count, ShardBy shard_by) {
+    shard_count_ = std::max<size_t>(shard_count, 1);
+    shard_by_ = shard_by;
+}
+
+bool DataStorage::flush() {
+    bool success = true;
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard->mutex);
+        if (shard->jsonl_writer && shard->jsonl_writer->is_open()) {
+            success = shard->jsonl_writer->flush() && success;
+            shard->size = shard->jsonl_writer->size();  // compressed: grows on flush
+            write_index_batch(*shard);
+        } else if (shard->bin_writer && shard->bin_writer->is_open()) {
+            success = shard->bin_writer->flush() && success;
+            shard->size = shard->bin_writer->size();
+            write_index_batch(*shard);
+        } else if (shard->parquet_writer) {
+            // Row groups are written as they fill; the footer only on close
+        } else if (shard->file.is_open()) {
+            shard->file.flush();
+            success = shard->file.good() && success;
+        }
+        if (is_file_open(*shard)) {
+            update_manifest(*shard, false);
+        }
+    }
+    return success;
+}
+
+bool DataStorage::is_file_open(const Shard& shard) const {
+    if (shard.jsonl_writer) {
+        return shard.jsonl_writer->is_open();
+    }
+    if (shard.bin_writer) {
+        return shard.bin_writer->is_open();
+    }
+    if (shard.parquet_writer) {
+        return shard.parquet_writer->is_open();
+    }
+    return shard.file.is_open();
+}
+
+DataStorage::Shard& DataStorage::shard_for(std::string_view paper_id) {
+    size_t key = shard_by_ == ShardBy::PAPER_ID ? std::hash<std::string_view>{}(paper_id) : thread_slot();
+    return *shards_[key % shards_.size()];
 }
 
 bool DataStorage::save_paper(const Paper& paper) {
-    if (!current_file_.is_open()) {
-        if (!open_new_file()) return false;
+    return write_record(paper);
+}
+
+bool DataStorage::save_paper(const PaperView& paper) {
+    return write_record(paper);
+}
+
+template <typename PaperT>
+bool DataStorage::write_record(const PaperT& paper) {
+    if (shards_.empty()) {
+        return false;  // not initialized
+    }
+
+    // Most duplicates are dropped here, without taking the shard lock
+    if (dedup_index_ && dedup_index_->contains(paper)) {
+        duplicates_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Shard& shard = shard_for(paper.id);
+    std::lock_guard lock(shard.mutex);
+
+    // Checked again under the lock: a thread saving the same paper may have
+    // written it since. With one shard or paper-id sharding every save of an
+    // id takes this lock, so an id is written once.
+    if (dedup_index_ && dedup_index_->contains(paper)) {
+        duplicates_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (!append_record(shard, paper)) {
+        return false;
+    }
+
+    // Recorded only once the paper is in the shard, so a failed write is
+    // retried by the next crawl. A paper saved at once into two shards (thread
+    // sharding, or one DOI under two ids) gets past both checks; record()
+    // then finds the other copy and it is counted.
+    if (dedup_index_) {
+        switch (dedup_index_->record(paper)) {
+            case DedupResult::NEWER_VERSION:
+                version_upgrades_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case DedupResult::DUPLICATE:
+                duplicates_written_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case DedupResult::NEW:
+                break;
+        }
+    }
+    return true;
+}
+
+template <typename PaperT>
+bool DataStorage::append_record(Shard& shard, const PaperT& paper) {
+    if (!is_file_open(shard)) {
+        if (!open_new_file(shard)) return false;
     }
 
     // Check if we need to rotate file
-    if (current_size_ > max_file_size_ * 1024 * 1024) {
-        if (!rotate_file_if_needed()) return false;
+    if (!rotate_if_needed(shard)) {
+        return false;
     }
 
     try {
+        // Format the whole record first: one write per paper, and its size
+        // comes for free
+        auto& record = shard.record_buffer;
+        record.clear();
+
+        // Queued for the writer thread, which batches the disk writes
+        if (format_ == "jsonl") {
+            paper_json::write(paper, record);
+            uint64_t position = shard.jsonl_writer->stream_size();
+            if (!shard.jsonl_writer->append(record)) {
+                return false;
+            }
+            if (secondary_index_) {
+                shard.index_batch.add(paper, {shard.file_id, position});
+                if (shard.index_batch.size() >= kIndexBatchPostings) {
+                    write_index_batch(shard);
+                }
+            }
+            // Compressed size is only known as frames are written
+            shard.size = compression_ == Compression::ZSTD ? shard.jsonl_writer->size()
+                                                           : shard.size + record.size() + 1;
+            shard.papers++;
+            return true;
+        }
+
+        if (format_ == "bin") {
+            paper_record::encode(paper, record);
+            uint64_t position = shard.bin_writer->records();
+            if (!shard.bin_writer->append(record)) {
+                return false;
+            }
+            if (secondary_index_) {
+                shard.index_batch.add(paper, {shard.file_id, position});
+                if (shard.index_batch.size() >= kIndexBatchPostings) {
+                    write_index_batch(shard);
+                }
+            }
+            shard.size = shard.bin_writer->size();
+            shard.papers++;
+            return true;
+        }
+
+        if (format_ == "parquet") {
+            if (!shard.parquet_writer->append(paper)) {
+                return false;
+            }
+            shard.size = shard.parquet_writer->size();
+            shard.papers++;
+            return true;
+        }
+
         bool success = false;
         if (format_ == "json") {
-            success = write_json(paper);
+            success = write_json(shard, paper);
         } else if (format_ == "csv") {
-            success = write_csv(paper);
+            success = write_csv(shard, paper);
         } else if (format_ == "xml") {
-            success = write_xml(paper);
+            success = write_xml(shard, paper);
         }
 
         if (success) {
-            current_size_ += paper.to_json().dump().size();
-            current_file_ << std::endl; // Add newline after each paper
-            current_file_.flush();
+            record.push_back('\n');
+            shard.file.write(record.data(), static_cast<std::streamsize>(record.size()));
+            shard.size += record.size();
+            shard.papers++;
         }
 
-        return success;
+        return success && shard.file.good();
     } catch (const std::exception& e) {
         return false;
     }
@@ -66,20 +566,325 @@ bool DataStorage::save_papers(const std::vector<Paper>& papers) {
     return all_success;
 }
 
-std::vector<Paper> DataStorage::load_papers(const std::string& source) {
-    std::vector<Paper> papers;
+DataStorage::ScanPlan DataStorage::plan_scan(const ScanFilter& filter) {
+    // Records and postings the writers still buffer become readable
+    if (!shards_.empty()) {
+        flush();
+    }
 
-    try {
-        for (const auto& entry : std::filesystem::directory_iterator(output_dir_)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                auto file_papers = read_json_file(entry.path().string());
-                for (auto& paper : file_papers) {
-                    if (source.empty() || paper.source == source) {
-                        papers.push_back(std::move(paper));
-                    }
+    ScanPlan plan;
+    plan.filter = filter;
+    plan.filter.resolve_symbols();
+    plan.files = data_files();
+    if (!secondary_index_) {
+        plan.file_ids.resize(plan.files.size());
+        return plan;
+    }
+    for (const auto& path : plan.files) {
+        plan.file_ids.push_back(secondary_index_->find_file(path.filename().string()));
+    }
+
+    // Every list the filter names, intersected
+    auto narrow = [&plan](std::vector<RecordLocation> list) {
+        if (!plan.locations) {
+            plan.locations = std::move(list);
+            return;
+        }
+        std::vector<RecordLocation> both;
+        std::set_intersection(plan.locations->begin(), plan.locations->end(), list.begin(), list.end(),
+                              std::back_inserter(both));
+        plan.locations = std::move(both);
+    };
+    if (!filter.source.empty()) {
+        narrow(secondary_index_->lookup(IndexKind::SOURCE, filter.source));
+    }
+    if (!filter.category.empty()) {
+        narrow(secondary_index_->lookup(IndexKind::CATEGORY, filter.category));
+    }
+    if (filter.published_from && filter.published_to) {
+        narrow(secondary_index_->lookup_published(*filter.published_from, *filter.published_to));
+    }
+    if (plan.locations) {
+        // A paper that lists a category twice is posted twice
+        plan.locations->erase(std::unique(plan.locations->begin(), plan.locations->end()), plan.locations->end());
+    }
+    return plan;
+}
+
+bool DataStorage::scan_file(const ScanPlan& plan, size_t file, const PaperScan::Emit& emit,
+                            uint64_t begin, uint64_t end) const {
+    const auto& path = plan.files[file];
+    const ScanFilter& filter = plan.filter;
+    auto accept = [&](auto& paper) {
+        if (!filter.matches(paper)) {
+            return true;
+        }
+        filter.project(paper);
+        if constexpr (std::is_same_v<std::decay_t<decltype(paper)>, PaperView>) {
+            return emit(paper.to_paper());
+        } else {
+            return emit(std::move(paper));
+        }
+    };
+    auto accept_line = [&](std::string_view line) {
+        if (line.empty() || !line_may_match(line, filter)) {
+            return true;
+        }
+        try {
+            Paper paper = Paper::from_json(nlohmann::json::parse(line));
+            return accept(paper);
+        } catch (const std::exception& e) {
+            return true;  // torn or corrupt line
+        }
+    };
+    auto extension = format_extension(path);
+
+    if (plan.locations && plan.file_ids[file]) {
+        uint32_t id = *plan.file_ids[file];
+        auto first = std::lower_bound(plan.locations->begin(), plan.locations->end(), RecordLocation{id, begin});
+        auto last = end == UINT64_MAX ? std::lower_bound(first, plan.locations->end(), RecordLocation{id + 1, 0})
+                                      : std::lower_bound(first, plan.locations->end(), RecordLocation{id, end});
+        if (first == last) {
+            return true;
+        }
+
+        if (extension == ".bin") {
+            BinarySegmentReader reader;
+            if (!reader.open(path.string())) {
+                return true;
+            }
+            PaperView view;
+            for (auto it = first; it != last; ++it) {
+                if (it->position < reader.size() && reader.read(it->position, view) && !accept(view)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // jsonl: postings point at line starts; a compressed file only
+        // inflates the frames holding them. Postings past the end (a record
+        // still queued when the file was mapped) find no line.
+        MappedFile mapped(path.string());
+        std::optional<SeekableZstdReader> frames;
+        std::string frame;
+        size_t frame_index = SIZE_MAX;
+        if (path.extension() == ".zst") {
+            frames.emplace();
+            if (!frames->open(mapped.data().data(), mapped.data().size())) {
+                return true;
+            }
+        }
+        for (auto it = first; it != last; ++it) {
+            std::string_view line;
+            if (frames) {
+                // Locations are sorted: each frame is inflated once
+                size_t index = frames->frame_at(it->position);
+                if (index != frame_index && index < frames->frame_count()) {
+                    frame_index = frames->read_frame(index, frame) ? index : SIZE_MAX;
+                }
+                if (index == frame_index) {
+                    line = line_at(frame, it->position - frames->frame_offset(index));
+                }
+            } else {
+                line = line_at(mapped.data(), it->position);
+            }
+            if (!accept_line(line)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (extension == ".bin") {
+        BinarySegmentReader reader;
+        if (!reader.open(path.string())) {
+            std::cerr << "Not a readable binary segment: " << path << std::endl;
+            return true;
+        }
+        reader.advise_sequential();
+        // Tested as a view: papers that do not match are never copied
+        PaperView view;
+        for (uint64_t i = begin; i < std::min<uint64_t>(end, reader.size()); ++i) {
+            if (reader.read(i, view) && !accept(view)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (extension == ".jsonl") {
+        bool more = true;
+        for_each_jsonl_line(path, [&](uint64_t, std::string_view line) { return more = accept_line(line); },
+                            begin, end);
+        return more;
+    }
+    // Other formats are read whole, by the range that starts the file
+    if (begin > 0) {
+        return true;
+    }
+    for (auto& paper : read_papers_file(path)) {
+        if (!accept(paper)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<DataStorage::LoadRange> DataStorage::split_load(const ScanPlan& plan) const {
+    std::vector<LoadRange> ranges;
+
+    for (size_t i = 0; i < plan.files.size(); ++i) {
+        const auto& path = plan.files[i];
+
+        // Index candidates: chunks of them, at their positions
+        if (plan.locations && plan.file_ids[i]) {
+            uint32_t id = *plan.file_ids[i];
+            auto first = std::lower_bound(plan.locations->begin(), plan.locations->end(), RecordLocation{id, 0});
+            auto last = std::lower_bound(first, plan.locations->end(), RecordLocation{id + 1, 0});
+            for (auto it = first; it != last;) {
+                auto next = last - it > static_cast<std::ptrdiff_t>(kLoadRangeRecords) ? it + kLoadRangeRecords : last;
+                ranges.push_back({i, it->position, next == last ? UINT64_MAX : next->position});
+                it = next;
+            }
+            continue;
+        }
+
+        // Whole files: equal shares of the positions they span, records of a
+        // bin segment or bytes of a jsonl stream; other formats in one piece
+        std::error_code error;
+        uint64_t bytes = std::filesystem::file_size(path, error);
+        uint64_t extent = 0;
+        auto extension = format_extension(path);
+        if (!error && bytes > kLoadRangeBytes && extension == ".bin") {
+            BinarySegmentReader reader;
+            if (reader.open(path.string())) {
+                extent = reader.size();
+            }
+        } else if (!error && bytes > kLoadRangeBytes && extension == ".jsonl") {
+            if (path.extension() == ".zst") {
+                MappedFile mapped(path.string());
+                SeekableZstdReader reader;
+                if (reader.open(mapped.data().data(), mapped.data().size())) {
+                    extent = reader.size();
                 }
+            } else {
+                extent = bytes;
             }
         }
+        uint64_t count = std::clamp<uint64_t>(extent ? (bytes + kLoadRangeBytes - 1) / kLoadRangeBytes : 1, 1,
+                                              std::max<uint64_t>(extent, 1));
+        for (uint64_t k = 0; k < count; ++k) {
+            ranges.push_back({i, extent * k / count, k + 1 == count ? UINT64_MAX : extent * (k + 1) / count});
+        }
+    }
+
+    return ranges;
+}
+
+bool DataStorage::load_parallel(const ScanFilter& filter, const PaperScan::Emit& emit, bool ordered) {
+    auto plan = plan_scan(filter);
+    auto ranges = split_load(plan);
+    size_t threads = load_threads_ ? load_threads_ : std::thread::hardware_concurrency();
+    threads = std::clamp<size_t>(threads, 1, std::max<size_t>(ranges.size(), 1));
+
+    // emit runs under `mutex`. An ordered load holds a parsed range back
+    // until the ranges before it are emitted, and starts none more than
+    // `window` ranges past the first one still due, which bounds what waits.
+    std::mutex mutex;
+    std::condition_variable window_moved;
+    std::map<size_t, std::vector<Paper>> parsed;
+    size_t next_range = 0;
+    size_t next_due = 0;
+    const size_t window = 2 * threads;
+    std::atomic<bool> stopped{false};
+    bool ok = true;
+
+    // Under `mutex`
+    auto deliver = [&](std::vector<Paper>& papers) {
+        try {
+            for (auto& paper : papers) {
+                if (stopped || !emit(std::move(paper))) {
+                    stopped = true;
+                    break;
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Load stopped: " << e.what() << std::endl;
+            stopped = true;
+            ok = false;
+        }
+        papers.clear();
+    };
+
+    auto worker = [&] {
+        std::vector<Paper> papers;
+        while (true) {
+            size_t index;
+            {
+                std::unique_lock lock(mutex);
+                window_moved.wait(lock, [&] {
+                    return stopped || !ordered || next_range >= ranges.size() || next_range < next_due + window;
+                });
+                if (stopped || next_range >= ranges.size()) {
+                    return;
+                }
+                index = next_range++;
+            }
+
+            const auto& range = ranges[index];
+            bool loaded = true;
+            try {
+                scan_file(plan, range.file, [&](Paper&& paper) {
+                    papers.push_back(std::move(paper));
+                    if (!ordered && papers.size() >= kLoadBatchPapers) {
+                        std::lock_guard lock(mutex);
+                        deliver(papers);
+                    }
+                    return !stopped;
+                }, range.begin, range.end);
+            } catch (const std::exception& e) {
+                std::cerr << "Failed to load " << plan.files[range.file] << ": " << e.what() << std::endl;
+                loaded = false;
+            }
+
+            std::lock_guard lock(mutex);
+            ok = ok && loaded;
+            if (!ordered) {
+                deliver(papers);
+                continue;
+            }
+            parsed.emplace(index, std::move(papers));
+            papers = {};
+            for (auto it = parsed.begin(); it != parsed.end() && it->first == next_due; it = parsed.erase(it)) {
+                deliver(it->second);
+                ++next_due;
+            }
+            window_moved.notify_all();
+        }
+    };
+
+    // The calling thread is one of the workers
+    std::vector<std::jthread> pool;
+    for (size_t i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    pool.clear();
+
+    return ok;
+}
+
+std::vector<Paper> DataStorage::collect(const ScanFilter& filter) {
+    std::vector<Paper> papers;
+
+    try {
+        bool complete = load_parallel(filter, [&papers](Paper&& paper) {
+            papers.push_back(std::move(paper));
+            return true;
+        }, true);
+        if (!complete) {
+            std::cerr << "Some data files could not be read; loaded " << papers.size() << " papers" << std::endl;
+        }
     } catch (const std::exception& e) {
         // Handle file reading errors
     }
@@ -87,129 +892,389 @@ std::vector<Paper> DataStorage::load_papers(const std::string& source) {
     return papers;
 }
 
+PaperScan DataStorage::scan(const ScanFilter& filter) {
+    auto plan = std::make_shared<const ScanPlan>(plan_scan(filter));
+    return PaperScan([this, plan](const PaperScan::Emit& emit) {
+        for (size_t i = 0; i < plan->files.size(); ++i) {
+            if (!scan_file(*plan, i, emit)) {
+                return;
+            }
+        }
+    });
+}
+
+std::vector<Paper> DataStorage::load_papers(const std::string& source) {
+    ScanFilter filter;
+    filter.source = source;
+    return collect(filter);
+}
+
 std::vector<Paper> DataStorage::load_papers_by_category(const std::string& category) {
-    auto all_papers = load_papers();
-    std::vector<Paper> filtered_papers;
+    ScanFilter filter;
+    filter.category = category;
+    return collect(filter);
+}
 
-    for (const auto& paper : all_papers) {
-        if (std::find(paper.categories.begin(), paper.categories.end(), category)
-            != paper.categories.end()) {
-            filtered_papers.push_back(paper);
-        }
+std::vector<Paper> DataStorage::load_papers_published(std::chrono::system_clock::time_point from,
+                                                      std::chrono::system_clock::time_point to) {
+    ScanFilter filter;
+    filter.published_from = from;
+    filter.published_to = to;
+    return collect(filter);
+}
+
+PaperTable DataStorage::load_table(const std::string& source) {
+    PaperTable table;
+
+    try {
+        ScanFilter filter;
+        filter.source = source;
+        // Rows are appended as ranges are emitted, one paper at a time
+        load_parallel(filter, [&table](Paper&& paper) {
+            table.append(paper);
+            return true;
+        }, true);
+    } catch (const std::exception& e) {
+        // Handle file reading errors
     }
 
-    return filtered_papers;
+    return table;
 }
 
 bool DataStorage::rotate_file_if_needed() {
-    if (current_size_ < max_file_size_ * 1024 * 1024) {
+    bool success = true;
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard->mutex);
+        success = rotate_if_needed(*shard) && success;
+    }
+    return success;
+}
+
+bool DataStorage::rotate_if_needed(Shard& shard) {
+    if (shard.size < max_file_size_ * 1024 * 1024) {
         return true;
     }
 
-    if (!close_current_file()) {
+    if (!close_current_file(shard)) {
         return false;
     }
-
-    current_filename_ = generate_filename();
-    return open_new_file();
+    return open_new_file(shard);
 }
 
 std::string DataStorage::get_current_filename() const {
-    return current_filename_;
+    if (shards_.empty()) {
+        return "";
+    }
+    std::lock_guard lock(shards_.front()->mutex);
+    return shards_.front()->filename;
 }
 
-std::string DataStorage::generate_filename() const {
+std::string DataStorage::generate_filename(Shard& shard) const {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm tm = *std::gmtime(&time_t);
+    std::tm tm{};
+    gmtime_r(&time_t, &tm);  // shards name files concurrently
 
     char buffer[64];
     std::strftime(buffer, sizeof(buffer), "%Y%m%d_%H%M%S", &tm);
 
-    return output_dir_ + "/papers_" + std::string(buffer) + "." + format_;
+    std::string name = output_dir_ + "/papers_" + std::string(buffer);
+    if (shards_.size() > 1) {
+        name += "_s" + std::to_string(shard.index);
+    }
+    // Rotations within the same second must not reopen the previous file
+    if (shard.files_opened > 0) {
+        name += "_" + std::to_string(shard.files_opened);
+    }
+    name += "." + format_;
+    if (compression_ == Compression::ZSTD && (format_ == "jsonl" || format_ == "bin")) {
+        name += ".zst";
+    }
+    return name;
 }
 
-bool DataStorage::open_new_file() {
+bool DataStorage::open_new_file(Shard& shard) {
+    shard.filename = generate_filename(shard);
+    shard.files_opened++;
+    shard.first_record = true;
+    shard.papers = 0;
+
+    if (secondary_index_) {
+        // A file reopened for appending that the index has not seen yet
+        // (written without it) gets its existing records indexed first
+        auto name = std::filesystem::path(shard.filename).filename().string();
+        if (!secondary_index_->find_file(name) && std::filesystem::exists(shard.filename)) {
+            index_data_file(shard.filename, shard.index_batch);
+        }
+        shard.file_id = secondary_index_->file_id(name);
+    }
+
+    if (shard.jsonl_writer) {
+        if (!shard.jsonl_writer->open(shard.filename)) {
+            return false;
+        }
+        // Appending to an existing file counts towards its rotation size
+        shard.size = shard.jsonl_writer->size();
+        update_manifest(shard, false);
+        return true;
+    }
+    if (shard.bin_writer) {
+        if (!shard.bin_writer->open(shard.filename)) {
+            return false;
+        }
+        shard.size = shard.bin_writer->size();
+        shard.papers = shard.bin_writer->records();
+        update_manifest(shard, false);
+        return true;
+    }
+    if (shard.parquet_writer) {
+        // Parquet files cannot be appended to: a reopened name is rewritten
+        if (!shard.parquet_writer->open(shard.filename)) {
+            return false;
+        }
+        shard.size = shard.parquet_writer->size();
+        update_manifest(shard, false);
+        return true;
+    }
+
     try {
-        current_file_.open(current_filename_, std::ios::out | std::ios::app);
-        if (!current_file_.is_open()) {
+        shard.file.open(shard.filename, std::ios::out | std::ios::app);
+        if (!shard.file.is_open()) {
             return false;
         }
 
         // Write file header based on format
         if (format_ == "json") {
-            current_file_ << "[" << std::endl;
+            shard.file << "[" << std::endl;
         } else if (format_ == "csv") {
-            current_file_ << "id,title,authors,doi,source,categories,published_date" << std::endl;
+            shard.file << "id,title,authors,doi,source,categories,published_date" << std::endl;
         } else if (format_ == "xml") {
-            current_file_ << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << std::endl;
-            current_file_ << "<papers>" << std::endl;
+            shard.file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << std::endl;
+            shard.file << "<papers>" << std::endl;
         }
 
-        current_size_ = 0;
+        shard.size = 0;
+        update_manifest(shard, false);
         return true;
     } catch (const std::exception& e) {
         return false;
     }
 }
 
-bool DataStorage::close_current_file() {
-    if (!current_file_.is_open()) {
+bool DataStorage::close_current_file(Shard& shard) {
+    // Closing adds the last frame, footer or seek table
+    std::error_code error;
+    if (shard.jsonl_writer && shard.jsonl_writer->is_open()) {
+        bool success = shard.jsonl_writer->close();
+        shard.size = std::filesystem::file_size(shard.filename, error);
+        write_index_batch(shard);
+        update_manifest(shard, true);
+        return success;
+    }
+    if (shard.bin_writer && shard.bin_writer->is_open()) {
+        bool success = shard.bin_writer->close();
+        shard.size = std::filesystem::file_size(shard.filename, error);
+        write_index_batch(shard);
+        update_manifest(shard, true);
+        return success;
+    }
+    if (shard.parquet_writer && shard.parquet_writer->is_open()) {
+        bool success = shard.parquet_writer->close();
+        shard.size = std::filesystem::file_size(shard.filename, error);
+        update_manifest(shard, true);
+        return success;
+    }
+    if (!shard.file.is_open()) {
         return true;
     }
 
     try {
         // Write file footer based on format
         if (format_ == "json") {
-            current_file_ << "]" << std::endl;
+            shard.file << "]" << std::endl;
         } else if (format_ == "xml") {
-            current_file_ << "</papers>" << std::endl;
+            shard.file << "</papers>" << std::endl;
         }
 
-        current_file_.close();
+        shard.file.close();
+        update_manifest(shard, true);
         return true;
     } catch (const std::exception& e) {
         return false;
     }
 }
 
-bool DataStorage::write_json(const Paper& paper) {
-    static bool first_paper = true;
+void DataStorage::load_manifest() {
+    std::lock_guard lock(manifest_mutex_);
+    manifest_.clear();
 
-    if (!first_paper) {
-        current_file_ << "," << std::endl;
+    auto path = std::filesystem::path(output_dir_) / kManifestName;
+    std::ifstream file(path);
+    if (file.is_open()) {
+        try {
+            auto json = nlohmann::json::parse(file);
+            for (const auto& item : json.at("files")) {
+                ManifestEntry entry;
+                entry.file = item.at("file").get<std::string>();
+                entry.shard = item.value("shard", size_t{0});
+                entry.papers = item.value("papers", size_t{0});
+                entry.bytes = item.value("bytes", uint64_t{0});
+                entry.complete = item.value("complete", false);
+                manifest_.push_back(std::move(entry));
+            }
+            return;
+        } catch (const std::exception& e) {
+            std::cerr << "Ignoring unreadable " << path << ": " << e.what() << std::endl;
+            manifest_.clear();
+        }
+    }
+
+    // First manifest for this directory: adopt the files already there
+    for (const auto& entry : std::filesystem::directory_iterator(output_dir_)) {
+        if (entry.is_regular_file() && is_data_file(entry.path())) {
+            ManifestEntry adopted;
+            adopted.file = entry.path().filename().string();
+            adopted.bytes = entry.file_size();
+            adopted.complete = true;
+            manifest_.push_back(std::move(adopted));
+        }
     }
+}
+
+void DataStorage::update_manifest(const Shard& shard, bool complete) {
+    std::lock_guard lock(manifest_mutex_);
+    auto name = std::filesystem::path(shard.filename).filename().string();
 
-    current_file_ << paper.to_json().dump(4);
-    first_paper = false;
+    auto it = std::find_if(manifest_.begin(), manifest_.end(),
+                           [&](const ManifestEntry& entry) { return entry.file == name; });
+    if (it == manifest_.end()) {
+        it = manifest_.insert(manifest_.end(), ManifestEntry{name});
+    }
+    it->shard = shard.index;
+    it->papers = shard.papers;
+    it->bytes = shard.size;
+    it->complete = complete;
+
+    write_manifest();
+}
+
+bool DataStorage::write_manifest() const {
+    auto files = nlohmann::json::array();
+    for (const auto& entry : manifest_) {
+        files.push_back({
+                {"file", entry.file},
+                {"shard", entry.shard},
+                {"papers", entry.papers},
+                {"bytes", entry.bytes},
+                {"complete", entry.complete}
+        });
+    }
+    nlohmann::json manifest = {
+            {"format", format_},
+            {"shards", shards_.size()},
+            {"files", files}
+    };
+
+    // Readers never see a half-written manifest
+    auto path = std::filesystem::path(output_dir_) / kManifestName;
+    auto temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        file << manifest.dump(2) << std::endl;
+        if (!file.good()) {
+            std::cerr << "Failed to write " << temp_path << std::endl;
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    return !error;
+}
+
+std::vector<std::filesystem::path> DataStorage::data_files() const {
+    std::vector<std::filesystem::path> files;
+    auto manifest_path = std::filesystem::path(output_dir_) / kManifestName;
+
+    // Without a manifest (written by older versions, or before initialize()),
+    // every data file in the directory belongs to the dataset
+    std::ifstream file(manifest_path);
+    if (!file.is_open()) {
+        for (const auto& entry : std::filesystem::directory_iterator(output_dir_)) {
+            if (entry.is_regular_file() && is_data_file(entry.path())) {
+                files.push_back(entry.path());
+            }
+        }
+        return files;
+    }
+
+    try {
+        auto manifest = nlohmann::json::parse(file);
+        for (const auto& item : manifest.at("files")) {
+            files.push_back(std::filesystem::path(output_dir_) / item.at("file").get<std::string>());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to read " << manifest_path << ": " << e.what() << std::endl;
+    }
+    return files;
+}
+
+template <typename PaperT>
+bool DataStorage::write_json(Shard& shard, const PaperT& paper) {
+    if (!shard.first_record) {
+        shard.record_buffer.append(",\n");
+    }
+
+    paper_json::write(paper, shard.record_buffer);
+    shard.first_record = false;
 
     return true;
 }
 
-bool DataStorage::write_csv(const Paper& paper) {
+template <typename PaperT>
+bool DataStorage::write_csv(Shard& shard, const PaperT& paper) {
     // Simple CSV writing - in real implementation, you'd want proper CSV escaping
-    current_file_ << "\"" << paper.id << "\","
-                  << "\"" << paper.title << "\","
-                  << "\"" << paper.authors.size() << "\","
-                  << "\"" << paper.doi << "\","
-                  << "\"" << paper.source << "\","
-                  << "\"" << paper.categories.size() << "\","
-                  << "\"" << std::chrono::system_clock::to_time_t(paper.published_date) << "\""
-                  << std::endl;
+    auto& out = shard.record_buffer;
+    auto field = [&](std::string_view value, bool last = false) {
+        out.append("\"").append(value).append(last ? "\"" : "\",");
+    };
+    field(paper.id);
+    field(paper.title);
+    field(std::to_string(paper.authors.size()));
+    field(paper.doi);
+    field(text_of(paper.source));
+    field(std::to_string(paper.categories.size()));
+    field(std::to_string(std::chrono::system_clock::to_time_t(paper.published_date)), true);
 
     return true;
 }
 
-bool DataStorage::write_xml(const Paper& paper) {
-    current_file_ << "  <paper>" << std::endl;
-    current_file_ << "    <id>" << paper.id << "</id>" << std::endl;
-    current_file_ << "    <title>" << paper.title << "</title>" << std::endl;
-    current_file_ << "    <source>" << paper.source << "</source>" << std::endl;
-    current_file_ << "  </paper>" << std::endl;
+template <typename PaperT>
+bool DataStorage::write_xml(Shard& shard, const PaperT& paper) {
+    auto& out = shard.record_buffer;
+    out.append("  <paper>\n");
+    out.append("    <id>").append(paper.id).append("</id>\n");
+    out.append("    <title>").append(paper.title).append("</title>\n");
+    out.append("    <source>").append(text_of(paper.source)).append("</source>\n");
+    out.append("  </paper>");
 
     return true;
 }
 
+std::vector<Paper> DataStorage::read_papers_file(const std::filesystem::path& path) const {
+    auto extension = format_extension(path);
+    if (extension == ".json") {
+        return read_json_file(path.string());
+    }
+    if (extension == ".jsonl") {
+        return read_jsonl_file(path.string());
+    }
+    if (extension == ".bin") {
+        return read_bin_file(path.string());
+    }
+    return {};
+}
+
 std::vector<Paper> DataStorage::read_json_file(const std::string& filename) const {
     std::vector<Paper> papers;
 
@@ -232,4 +1297,50 @@ std::vector<Paper> DataStorage::read_json_file(const std::string& filename) cons
     return papers;
 }
 
+std::vector<Paper> DataStorage::read_jsonl_file(const std::string& filename) const {
+    std::vector<Paper> papers;
+
+    // A line that does not parse (e.g. torn by a crash and not yet repaired
+    // by the writer) is skipped rather than failing the whole file
+    for_each_jsonl_line(filename, [&papers](uint64_t, std::string_view line) {
+        try {
+            papers.push_back(Paper::from_json(nlohmann::json::parse(line)));
+        } catch (const std::exception& e) {
+        }
+        return true;
+    });
+
+    return papers;
+}
+
+std::vector<Paper> DataStorage::read_bin_file(const std::string& filename) const {
+    // Records that fail their checksum are skipped; a segment whose writer
+    // is still running (or crashed) is read up to its last intact record
+    BinarySegmentReader reader;
+    if (!reader.open(filename)) {
+        std::cerr << "Not a readable binary segment: " << filename << std::endl;
+        return {};
+    }
+    return reader.read_all();
+}
+
+DataStorage::StorageStats DataStorage::get_stats() const {
+    StorageStats stats;
+    {
+        std::lock_guard lock(manifest_mutex_);
+        for (const auto& entry : manifest_) {
+            stats.total_papers += entry.papers;
+            stats.disk_bytes += entry.bytes;
+        }
+    }
+    stats.uncompressed_bytes = compression_stats_.input_bytes;
+    stats.compressed_bytes = compression_stats_.output_bytes;
+    stats.compression_cpu = std::chrono::nanoseconds(compression_stats_.cpu_ns.load());
+    stats.duplicates_dropped = duplicates_dropped_.load();
+    stats.version_upgrades = version_upgrades_.load();
+    stats.duplicates_written = duplicates_written_.load();
+    stats.last_updated = std::chrono::system_clock::now();
+    return stats;
+}
+
 // Other format readers would be implemented similarly...
\ No newline at end of file
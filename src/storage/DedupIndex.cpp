@@ -0,0 +1,587 @@
+#include "storage/DedupIndex.h"
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <optional>
+#include <vector>
+#include <thread>
+#include <bit>
+#include <cerrno>
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+    constexpr std::string_view kMagic = "PAPERDUP";
+    constexpr uint32_t kFormatVersion = 1;
+    constexpr uint32_t kCleanFlag = 1;
+    constexpr size_t kHeaderSize = 64;
+    constexpr size_t kSlotSize = 16;
+    constexpr int kBloomHashes = 7;
+
+    // Header fields, at their byte offsets
+    constexpr size_t kFlagsOffset = 12;
+    constexpr size_t kCapacityOffset = 16;
+    constexpr size_t kKeysOffset = 24;
+
+    using AtomicWord = std::atomic_ref<uint64_t>;
+
+    // FNV-1a, then the murmur3 finalizer for well-spread low bits. `tag`
+    // keeps id and DOI keys apart; DOIs are case-insensitive.
+    uint64_t hash_key(char tag, std::string_view text, bool fold_case) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        auto feed = [&hash](unsigned char c) {
+            hash ^= c;
+            hash *= 0x100000001b3ull;
+        };
+        feed(static_cast<unsigned char>(tag));
+        for (char c : text) {
+            feed(static_cast<unsigned char>(fold_case && c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c));
+        }
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+        return hash ? hash : 1;  // 0 marks an empty slot
+    }
+
+    // "2401.01234v2" -> ("2401.01234", 2); ids without a version suffix
+    // after a digit are returned whole
+    std::pair<std::string_view, std::optional<int>> split_version(std::string_view id) {
+        size_t digits = 0;
+        while (digits < id.size() && std::isdigit(static_cast<unsigned char>(id[id.size() - 1 - digits]))) {
+            ++digits;
+        }
+        size_t v = id.size() - digits - 1;
+        if (digits == 0 || digits > 6 || digits >= id.size() || id[v] != 'v' || v == 0 ||
+            !std::isdigit(static_cast<unsigned char>(id[v - 1]))) {
+            return {id, std::nullopt};
+        }
+        int version = 0;
+        for (char c : id.substr(v + 1)) {
+            version = version * 10 + (c - '0');
+        }
+        return {id.substr(0, v), version};
+    }
+
+    // Order-preserving and never 0, which marks a version still being stored
+    uint64_t encode_version(int version) {
+        return static_cast<uint64_t>(static_cast<int64_t>(version) - INT32_MIN) + 1;
+    }
+
+    uint64_t load_u64(const unsigned char* p) {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    void store_u64(unsigned char* p, uint64_t value) {
+        std::memcpy(p, &value, sizeof(value));
+    }
+
+    DedupResult combine(DedupResult a, DedupResult b) {
+        if (a == DedupResult::NEWER_VERSION || b == DedupResult::NEWER_VERSION) {
+            return DedupResult::NEWER_VERSION;
+        }
+        if (a == DedupResult::DUPLICATE || b == DedupResult::DUPLICATE) {
+            return DedupResult::DUPLICATE;
+        }
+        return DedupResult::NEW;
+    }
+
+    // The version of a freshly claimed slot follows right after its key
+    uint64_t load_version(uint64_t* value) {
+        AtomicWord version(*value);
+        uint64_t stored = version.load(std::memory_order_acquire);
+        while (stored == 0) {
+            std::this_thread::yield();
+            stored = version.load(std::memory_order_acquire);
+        }
+        return stored;
+    }
+}
+
+struct DedupIndex::Table {
+    std::string path;
+    int fd = -1;
+    unsigned char* mapping = nullptr;
+    size_t mapped_size = 0;
+    uint64_t* slots = nullptr;  // key, version, key, version, ...
+    uint64_t mask = 0;          // capacity - 1
+    std::atomic<size_t> keys{0};
+    std::atomic<size_t> inserters{0};  // record_key() calls inserting here
+    std::atomic<bool> sealed{false};    // a newer table is being added
+    std::unique_ptr<std::atomic<uint64_t>[]> bloom;
+    uint64_t bloom_mask = 0;    // bits - 1
+
+    ~Table() {
+        if (mapping) {
+            ::munmap(mapping, mapped_size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    uint64_t capacity() const { return mask + 1; }
+
+    bool map(int file, size_t size) {
+        void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        fd = file;
+        mapping = static_cast<unsigned char*>(address);
+        mapped_size = size;
+        slots = reinterpret_cast<uint64_t*>(mapping + kHeaderSize);
+        // Probes land anywhere in the table
+        ::madvise(mapping, mapped_size, MADV_RANDOM);
+        return true;
+    }
+
+    void init_bloom(size_t bits_per_key, double max_load) {
+        auto bits = std::bit_ceil(std::max<uint64_t>(
+                64, static_cast<uint64_t>(static_cast<double>(capacity()) * max_load) * bits_per_key));
+        bloom = std::make_unique<std::atomic<uint64_t>[]>(bits / 64);
+        bloom_mask = bits - 1;
+    }
+
+    // Double hashing over the key, mixed again so the bits do not follow
+    // the slot index
+    template <typename F>
+    void for_each_bloom_bit(uint64_t key, F&& visit) const {
+        uint64_t h = key * 0x9E3779B97F4A7C15ull;
+        uint64_t step = (h >> 32) | 1;
+        for (int i = 0; i < kBloomHashes; ++i, h += step) {
+            if (!visit((h & bloom_mask) >> 6, uint64_t{1} << (h & 63))) {
+                return;
+            }
+        }
+    }
+
+    void bloom_add(uint64_t key) {
+        for_each_bloom_bit(key, [this](uint64_t word, uint64_t bit) {
+            if (!(bloom[word].load(std::memory_order_relaxed) & bit)) {
+                bloom[word].fetch_or(bit, std::memory_order_release);
+            }
+            return true;
+        });
+    }
+
+    bool bloom_may_contain(uint64_t key) const {
+        bool present = true;
+        for_each_bloom_bit(key, [&](uint64_t word, uint64_t bit) {
+            present = (bloom[word].load(std::memory_order_acquire) & bit) != 0;
+            return present;
+        });
+        return present;
+    }
+
+    // Slot of `key`, or nullptr if it is not in this table
+    uint64_t* find(uint64_t key) const {
+        if (!bloom_may_contain(key)) {
+            return nullptr;
+        }
+        for (uint64_t i = key & mask, n = 0; n <= mask; i = (i + 1) & mask, ++n) {
+            uint64_t stored = AtomicWord(slots[2 * i]).load(std::memory_order_acquire);
+            if (stored == key) {
+                return &slots[2 * i + 1];
+            }
+            if (stored == 0) {
+                return nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    void set_header(uint32_t flags) {
+        store_u64(mapping + kKeysOffset, keys.load());
+        std::memcpy(mapping + kFlagsOffset, &flags, sizeof(flags));
+    }
+
+    bool sync(bool whole) {
+        return ::msync(mapping, whole ? mapped_size : kHeaderSize, MS_SYNC) == 0;
+    }
+};
+
+DedupIndex::DedupIndex() : DedupIndex(Options{}) {
+}
+
+DedupIndex::DedupIndex(Options options) : options_(options) {
+    options_.initial_capacity = std::bit_ceil(std::max<size_t>(options_.initial_capacity, 64));
+    options_.max_load = std::clamp(options_.max_load, 0.1, 0.95);
+}
+
+DedupIndex::~DedupIndex() {
+    close();
+}
+
+std::string DedupIndex::table_path(size_t number) const {
+    return (std::filesystem::path(dir_) / ("dedup." + std::to_string(number) + ".idx")).string();
+}
+
+bool DedupIndex::open(const std::string& dir) {
+    if (is_open() && !close()) {
+        return false;
+    }
+    dir_ = dir;
+    std::error_code error;
+    std::filesystem::create_directories(dir_, error);
+
+    // Existing tables, oldest first
+    std::vector<std::pair<size_t, std::filesystem::path>> files;
+    for (const auto& entry : std::filesystem::directory_iterator(dir_, error)) {
+        auto name = entry.path().filename().string();
+        if (name.starts_with("dedup.") && name.ends_with(".idx")) {
+            try {
+                files.emplace_back(std::stoul(name.substr(6, name.size() - 10)), entry.path());
+            } catch (const std::exception&) {
+                continue;
+            }
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    needs_rebuild_ = files.empty();
+    next_number_ = files.empty() ? 0 : files.back().first + 1;
+    size_t count = 0;
+    for (const auto& [number, path] : files) {
+        auto table = std::make_unique<Table>();
+        table->path = path.string();
+        int fd = ::open(table->path.c_str(), O_RDWR | O_CLOEXEC);
+        struct stat info{};
+        bool ok = fd >= 0 && ::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= kHeaderSize;
+        if (ok && !table->map(fd, static_cast<size_t>(info.st_size))) {
+            ok = false;
+        }
+        if (ok) {
+            uint64_t capacity = load_u64(table->mapping + kCapacityOffset);
+            uint32_t version;
+            std::memcpy(&version, table->mapping + 8, sizeof(version));
+            ok = std::memcmp(table->mapping, kMagic.data(), kMagic.size()) == 0 && version == kFormatVersion &&
+                 std::has_single_bit(capacity) && kHeaderSize + capacity * kSlotSize == table->mapped_size;
+            table->mask = ok ? capacity - 1 : 0;
+        } else if (fd >= 0 && !table->mapping) {
+            ::close(fd);
+        }
+        if (!ok || count == kMaxTables) {
+            std::cerr << "Discarding unreadable dedup table " << path << std::endl;
+            table.reset();
+            std::filesystem::remove(path, error);
+            needs_rebuild_ = true;
+            continue;
+        }
+
+        uint32_t flags;
+        std::memcpy(&flags, table->mapping + kFlagsOffset, sizeof(flags));
+        needs_rebuild_ = needs_rebuild_ || !(flags & kCleanFlag);
+
+        // The Bloom filter lives in memory only: rebuilt from the keys
+        table->init_bloom(options_.bloom_bits_per_key, options_.max_load);
+        ::madvise(table->mapping, table->mapped_size, MADV_SEQUENTIAL);
+        size_t keys = 0;
+        for (uint64_t i = 0; i <= table->mask; ++i) {
+            if (uint64_t key = table->slots[2 * i]) {
+                table->bloom_add(key);
+                ++keys;
+            }
+        }
+        ::madvise(table->mapping, table->mapped_size, MADV_RANDOM);
+        table->keys = keys;
+
+        tables_[count].store(table.get(), std::memory_order_relaxed);
+        owned_[count] = std::move(table);
+        ++count;
+    }
+    table_count_.store(count, std::memory_order_release);
+
+    if (count == 0 ? !add_table(0) : count > 1 && !merge_tables()) {
+        close();
+        return false;
+    }
+
+    // Until close() marks them again, a crash leaves the tables unclean
+    for (size_t i = 0; i < table_count(); ++i) {
+        owned_[i]->set_header(0);
+        owned_[i]->sync(false);
+    }
+    return true;
+}
+
+bool DedupIndex::close() {
+    size_t count = table_count_.exchange(0, std::memory_order_acq_rel);
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i) {
+        // Keys first, then the flag that vouches for them
+        Table& table = *owned_[i];
+        table.set_header(0);
+        ok = table.sync(true) && ok;
+        table.set_header(kCleanFlag);
+        ok = table.sync(false) && ok;
+        tables_[i].store(nullptr, std::memory_order_relaxed);
+        owned_[i].reset();
+    }
+    if (!ok) {
+        std::cerr << "Failed to sync dedup index in " << dir_ << ": " << std::strerror(errno) << std::endl;
+    }
+    return ok;
+}
+
+bool DedupIndex::clear() {
+    size_t count = table_count_.exchange(0, std::memory_order_acq_rel);
+    std::error_code error;
+    for (size_t i = 0; i < count; ++i) {
+        std::filesystem::remove(owned_[i]->path, error);
+        tables_[i].store(nullptr, std::memory_order_relaxed);
+        owned_[i].reset();
+    }
+    needs_rebuild_ = false;
+    return add_table(0);
+}
+
+bool DedupIndex::add_table(size_t full_tables) {
+    std::lock_guard lock(grow_mutex_);
+    size_t count = table_count_.load(std::memory_order_acquire);
+    if (count != full_tables) {
+        return true;  // another thread added one
+    }
+    if (count == kMaxTables) {
+        std::cerr << "Dedup index is full" << std::endl;
+        return false;
+    }
+    // Let inserts into the current newest table finish
+    Table* previous = count ? owned_[count - 1].get() : nullptr;
+    if (previous) {
+        previous->sealed.store(true, std::memory_order_seq_cst);
+        while (previous->inserters.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    uint64_t capacity = count == 0 ? options_.initial_capacity : owned_[count - 1]->capacity() * 2;
+    auto table = std::make_unique<Table>();
+    table->path = table_path(next_number_);
+    table->mask = capacity - 1;
+
+    // Sparse: pages are only allocated as slots are used
+    size_t size = kHeaderSize + capacity * kSlotSize;
+    int fd = ::open(table->path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(size)) != 0 || !table->map(fd, size)) {
+        std::cerr << "Failed to create " << table->path << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0 && !table->mapping) {
+            ::close(fd);
+        }
+        if (previous) {
+            previous->sealed.store(false, std::memory_order_release);
+        }
+        return false;
+    }
+    std::memcpy(table->mapping, kMagic.data(), kMagic.size());
+    std::memcpy(table->mapping + 8, &kFormatVersion, sizeof(kFormatVersion));
+    store_u64(table->mapping + kCapacityOffset, capacity);
+    table->set_header(0);
+    table->init_bloom(options_.bloom_bits_per_key, options_.max_load);
+    next_number_++;
+
+    tables_[count].store(table.get(), std::memory_order_release);
+    owned_[count] = std::move(table);
+    table_count_.store(count + 1, std::memory_order_release);
+    return true;
+}
+
+bool DedupIndex::merge_tables() {
+    // One table with room for every key at half the load limit
+    size_t count = table_count();
+    uint64_t keys = size();
+    uint64_t capacity = options_.initial_capacity;
+    while (static_cast<double>(capacity) * options_.max_load < 2.0 * static_cast<double>(keys)) {
+        capacity *= 2;
+    }
+
+    std::array<std::unique_ptr<Table>, kMaxTables> old;
+    for (size_t i = 0; i < count; ++i) {
+        old[i] = std::move(owned_[i]);
+        tables_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    table_count_.store(0, std::memory_order_release);
+
+    Options saved = options_;
+    options_.initial_capacity = capacity;
+    bool ok = add_table(0);
+    options_ = saved;
+    if (!ok) {
+        return false;
+    }
+
+    // Later tables hold later versions, but keep the highest regardless
+    Table& merged = *owned_[0];
+    for (size_t t = 0; t < count; ++t) {
+        const Table& table = *old[t];
+        for (uint64_t i = 0; i <= table.mask; ++i) {
+            uint64_t key = table.slots[2 * i];
+            uint64_t version = table.slots[2 * i + 1];
+            if (key == 0) {
+                continue;
+            }
+            uint64_t slot = key & merged.mask;
+            while (merged.slots[2 * slot] != 0 && merged.slots[2 * slot] != key) {
+                slot = (slot + 1) & merged.mask;
+            }
+            if (merged.slots[2 * slot] == 0) {
+                merged.slots[2 * slot] = key;
+                merged.bloom_add(key);
+                ++merged.keys;
+            }
+            merged.slots[2 * slot + 1] = std::max(merged.slots[2 * slot + 1], version);
+        }
+    }
+
+    // The merged table is durable before the old ones go
+    merged.set_header(0);
+    if (!merged.sync(true)) {
+        return false;
+    }
+    std::error_code error;
+    for (size_t i = 0; i < count; ++i) {
+        std::string path = old[i]->path;
+        old[i].reset();
+        std::filesystem::remove(path, error);
+    }
+    return true;
+}
+
+DedupIndex::Table* DedupIndex::find(uint64_t key, uint64_t*& value) const {
+    // Newest first: that is where recent keys are
+    for (size_t i = table_count_.load(std::memory_order_acquire); i > 0; --i) {
+        Table* table = tables_[i - 1].load(std::memory_order_acquire);
+        if ((value = table->find(key))) {
+            return table;
+        }
+    }
+    return nullptr;
+}
+
+DedupResult DedupIndex::record_key(uint64_t key, uint64_t version) {
+    auto raise = [version](uint64_t* value) {
+        AtomicWord stored_version(*value);
+        uint64_t stored = load_version(value);
+        while (stored < version) {
+            if (stored_version.compare_exchange_weak(stored, version, std::memory_order_acq_rel)) {
+                return DedupResult::NEWER_VERSION;
+            }
+        }
+        return DedupResult::DUPLICATE;
+    };
+
+    uint64_t* value = nullptr;
+    if (find(key, value)) {
+        return raise(value);
+    }
+
+    while (true) {
+        size_t count = table_count_.load(std::memory_order_acquire);
+        if (count == 0) {
+            return DedupResult::NEW;  // closed
+        }
+        Table& table = *tables_[count - 1].load(std::memory_order_acquire);
+
+        // Register with the newest table; add_table() seals it and waits for
+        // registered inserts, so no key lands in an older table unseen
+        table.inserters.fetch_add(1, std::memory_order_seq_cst);
+        if (table.sealed.load(std::memory_order_seq_cst)) {
+            table.inserters.fetch_sub(1, std::memory_order_release);
+            while (table_count_.load(std::memory_order_acquire) == count &&
+                   table.sealed.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+
+        // Older tables are quiescent now; look again in case the key went
+        // into one after the first lookup
+        std::optional<DedupResult> result;
+        if (find(key, value)) {
+            result = raise(value);
+        } else {
+            // Visible to lookups before the key is
+            table.bloom_add(key);
+            for (uint64_t i = key & table.mask, n = 0; n <= table.mask && !result;
+                 i = (i + 1) & table.mask, ++n) {
+                AtomicWord slot_key(table.slots[2 * i]);
+                uint64_t stored = slot_key.load(std::memory_order_acquire);
+                if (stored == 0) {
+                    if (slot_key.compare_exchange_strong(stored, key, std::memory_order_acq_rel)) {
+                        AtomicWord(table.slots[2 * i + 1]).store(version, std::memory_order_release);
+                        table.keys.fetch_add(1, std::memory_order_relaxed);
+                        result = DedupResult::NEW;
+                        break;
+                    }
+                    // Lost the slot; `stored` is now the key that won it
+                }
+                if (stored == key) {
+                    result = raise(&table.slots[2 * i + 1]);
+                }
+            }
+        }
+        table.inserters.fetch_sub(1, std::memory_order_release);
+
+        if (result) {
+            if (*result == DedupResult::NEW &&
+                static_cast<double>(table.keys.load(std::memory_order_relaxed)) >
+                    static_cast<double>(table.capacity()) * options_.max_load) {
+                add_table(count);
+            }
+            return *result;
+        }
+        // Completely full: wait for (or add) the next table
+        if (!add_table(count)) {
+            return DedupResult::NEW;
+        }
+    }
+}
+
+DedupResult DedupIndex::record(std::string_view id, std::string_view doi, int version) {
+    auto [base_id, id_version] = split_version(id);
+    uint64_t encoded = encode_version(id_version.value_or(version));
+
+    DedupResult result = DedupResult::NEW;
+    if (!base_id.empty()) {
+        result = record_key(hash_key('i', base_id, false), encoded);
+    }
+    if (!doi.empty()) {
+        result = combine(result, record_key(hash_key('d', doi, true), encoded));
+    }
+    return result;
+}
+
+bool DedupIndex::contains(std::string_view id, std::string_view doi, int version) const {
+    auto [base_id, id_version] = split_version(id);
+    uint64_t encoded = encode_version(id_version.value_or(version));
+
+    bool seen = false;
+    for (uint64_t key : {base_id.empty() ? 0 : hash_key('i', base_id, false),
+                         doi.empty() ? 0 : hash_key('d', doi, true)}) {
+        uint64_t* value = nullptr;
+        if (key == 0 || !find(key, value)) {
+            continue;
+        }
+        if (load_version(value) < encoded) {
+            return false;  // an upgrade
+        }
+        seen = true;
+    }
+    return seen;
+}
+
+size_t DedupIndex::size() const {
+    size_t keys = 0;
+    for (size_t i = 0; i < table_count_.load(std::memory_order_acquire); ++i) {
+        keys += tables_[i].load(std::memory_order_acquire)->keys.load(std::memory_order_relaxed);
+    }
+    return keys;
+}
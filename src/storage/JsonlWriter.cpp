@@ -0,0 +1,355 @@
+#include "storage/JsonlWriter.h"
+#include "scheduler/CpuAffinity.h"
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+    // Cuts a record left incomplete by a crash, i.e. everything after the
+    // last newline. Returns the resulting file size, or nullopt on I/O errors.
+    std::optional<uint64_t> trim_torn_record(int fd, const std::string& path) {
+        off_t size = ::lseek(fd, 0, SEEK_END);
+        if (size < 0) {
+            return std::nullopt;
+        }
+
+        std::vector<char> block(64 * 1024);
+        off_t end = size;
+        while (end > 0) {
+            off_t start = end > static_cast<off_t>(block.size()) ? end - static_cast<off_t>(block.size()) : 0;
+            ssize_t count = ::pread(fd, block.data(), static_cast<size_t>(end - start), start);
+            if (count != end - start) {
+                return std::nullopt;
+            }
+            for (off_t i = end - start; i > 0; --i) {
+                if (block[i - 1] == '\n') {
+                    off_t keep = start + i;
+                    if (keep == size) {
+                        return static_cast<uint64_t>(size);
+                    }
+                    std::cerr << "Truncating incomplete record at the end of " << path << std::endl;
+                    if (::ftruncate(fd, keep) != 0) {
+                        return std::nullopt;
+                    }
+                    return static_cast<uint64_t>(keep);
+                }
+            }
+            end = start;
+        }
+
+        // No complete record at all
+        if (size > 0) {
+            std::cerr << "Truncating incomplete record at the end of " << path << std::endl;
+            if (::ftruncate(fd, 0) != 0) {
+                return std::nullopt;
+            }
+        }
+        return 0;
+    }
+
+    // Compressed counterpart of trim_torn_record(): keeps the complete
+    // frames, drops a torn one and the seek table, and hands the frames to
+    // `compressor` so the file can be continued.
+    std::optional<uint64_t> trim_torn_frame(int fd, const std::string& path, SeekableZstdWriter& compressor,
+                                            uint64_t& stream_size) {
+        compressor.reset();
+        stream_size = 0;
+        struct stat info{};
+        if (::fstat(fd, &info) != 0) {
+            return std::nullopt;
+        }
+        auto size = static_cast<size_t>(info.st_size);
+        if (size == 0) {
+            return 0;
+        }
+
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            return std::nullopt;
+        }
+        // Fewer than 4 bytes is a torn first frame
+        if (size >= 4 && !seekable_zstd::is_compressed(mapping, size)) {
+            ::munmap(mapping, size);
+            std::cerr << "Not a zstd file, refusing to append: " << path << std::endl;
+            errno = EINVAL;
+            return std::nullopt;
+        }
+        SeekableZstdReader reader;
+        bool ok = reader.open(mapping, size);
+        uint64_t keep = reader.frames_end();
+        compressor.resume(reader.entries(reader.frame_count()));
+        bool torn = !reader.has_seek_table();
+        stream_size = reader.size();
+        ::munmap(mapping, size);
+        if (!ok) {
+            errno = ENOTSUP;
+            return std::nullopt;
+        }
+
+        if (keep < size) {
+            if (torn) {
+                std::cerr << "Truncating incomplete frame at the end of " << path << std::endl;
+            }
+            if (::ftruncate(fd, static_cast<off_t>(keep)) != 0) {
+                return std::nullopt;
+            }
+        }
+        return keep;
+    }
+}
+
+std::optional<FsyncPolicy> parse_fsync_policy(const std::string& name) {
+    if (name == "none") return FsyncPolicy::NONE;
+    if (name == "batch") return FsyncPolicy::BATCH;
+    if (name == "interval") return FsyncPolicy::INTERVAL;
+    return std::nullopt;
+}
+
+JsonlWriter::JsonlWriter(FsyncPolicy policy, std::chrono::milliseconds fsync_interval,
+                         size_t segment_bytes, std::optional<seekable_zstd::Options> compression)
+        : policy_(policy), fsync_interval_(fsync_interval), segment_bytes_(segment_bytes) {
+    if (compression) {
+        compressor_ = std::make_unique<SeekableZstdWriter>(*compression);
+    }
+}
+
+JsonlWriter::~JsonlWriter() {
+    close();
+}
+
+bool JsonlWriter::open(const std::string& path) {
+    if (is_open() && !close()) {
+        return false;
+    }
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    uint64_t stream_size = 0;
+    auto size = compressor_ ? trim_torn_frame(fd, path, *compressor_, stream_size) : trim_torn_record(fd, path);
+    if (!size) {
+        std::cerr << "Failed to check " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        fd_ = fd;
+        base_size_ = *size;
+        base_stream_size_ = compressor_ ? stream_size : *size;
+        active_.clear();
+        appended_bytes_ = 0;
+        committed_bytes_ = 0;
+        written_bytes_ = 0;
+        flush_requested_ = false;
+        failed_ = false;
+    }
+    thread_ = std::jthread([this](std::stop_token stop_token) { writer_loop(stop_token); });
+    return true;
+}
+
+bool JsonlWriter::close() {
+    if (!is_open()) {
+        return true;
+    }
+
+    // The writer drains the active segment before it exits
+    thread_.request_stop();
+    thread_.join();
+
+    bool ok = !failed_;
+    if (ok && policy_ != FsyncPolicy::NONE) {
+        ok = sync();
+    }
+    ::close(fd_);
+    fd_ = -1;
+    return ok;
+}
+
+bool JsonlWriter::append(std::string_view record) {
+    std::unique_lock lock(mutex_);
+    // Back-pressure: wait for the writer to take the full segment
+    batch_done_.wait(lock, [this] { return failed_ || active_.size() < segment_bytes_; });
+    if (failed_ || fd_ < 0) {
+        return false;
+    }
+
+    // The writer only sleeps while the segment is empty
+    bool wake_writer = active_.empty();
+    active_.append(record);
+    active_.push_back('\n');
+    appended_bytes_ += record.size() + 1;
+    lock.unlock();
+
+    if (wake_writer) {
+        work_ready_.notify_one();
+    }
+    return true;
+}
+
+bool JsonlWriter::flush() {
+    std::unique_lock lock(mutex_);
+    uint64_t target = appended_bytes_;
+    // Lines in an unfinished frame are not on disk yet
+    if (compressor_ && committed_bytes_ < target) {
+        flush_requested_ = true;
+        lock.unlock();
+        work_ready_.notify_one();
+        lock.lock();
+    }
+    batch_done_.wait(lock, [&] { return failed_ || committed_bytes_ >= target; });
+    if (failed_) {
+        return false;
+    }
+    lock.unlock();
+
+    return policy_ == FsyncPolicy::NONE || sync();
+}
+
+uint64_t JsonlWriter::size() const {
+    std::lock_guard lock(mutex_);
+    return base_size_ + (compressor_ ? written_bytes_ : appended_bytes_);
+}
+
+uint64_t JsonlWriter::stream_size() const {
+    std::lock_guard lock(mutex_);
+    return base_stream_size_ + appended_bytes_;
+}
+
+void JsonlWriter::writer_loop(std::stop_token stop_token) {
+    CpuAffinity::pin_current_thread(PipelineStage::STORAGE);
+
+    std::string batch;
+    std::string compressed;
+    auto last_sync = std::chrono::steady_clock::now();
+    bool unsynced = false;
+
+    std::unique_lock lock(mutex_);
+    while (true) {
+        auto has_work = [this] { return !active_.empty() || flush_requested_; };
+        if (policy_ == FsyncPolicy::INTERVAL && unsynced) {
+            work_ready_.wait_until(lock, stop_token, last_sync + fsync_interval_, has_work);
+        } else {
+            work_ready_.wait(lock, stop_token, has_work);
+        }
+
+        if (active_.empty() && !flush_requested_) {
+            if (stop_token.stop_requested()) {
+                break;
+            }
+            // Interval elapsed with nothing new to write
+            if (unsynced && std::chrono::steady_clock::now() >= last_sync + fsync_interval_) {
+                lock.unlock();
+                bool ok = sync();
+                last_sync = std::chrono::steady_clock::now();
+                unsynced = false;
+                lock.lock();
+                failed_ = failed_ || !ok;
+            }
+            continue;
+        }
+
+        // Swap segments: producers keep appending while this batch is written
+        batch.swap(active_);
+        bool end_frame = std::exchange(flush_requested_, false);
+        uint64_t batch_end = appended_bytes_;
+        lock.unlock();
+        batch_done_.notify_all();
+
+        bool ok;
+        uint64_t written = 0;
+        if (compressor_) {
+            compressed.clear();
+            ok = compress(batch, end_frame, false, compressed) && commit(compressed);
+            written = compressed.size();
+        } else {
+            ok = commit(batch);
+            written = batch.size();
+        }
+        batch.clear();
+        if (ok && policy_ == FsyncPolicy::BATCH) {
+            ok = sync();
+        } else if (ok && policy_ == FsyncPolicy::INTERVAL) {
+            unsynced = true;
+            if (std::chrono::steady_clock::now() >= last_sync + fsync_interval_) {
+                ok = sync();
+                last_sync = std::chrono::steady_clock::now();
+                unsynced = false;
+            }
+        }
+
+        lock.lock();
+        failed_ = failed_ || !ok;
+        // Lines still waiting in the compressor's frame are not committed
+        committed_bytes_ = batch_end - (compressor_ ? compressor_->pending() : 0);
+        written_bytes_ += written;
+        batch_done_.notify_all();
+    }
+
+    // Last frame and the seek table
+    if (compressor_ && !failed_) {
+        lock.unlock();
+        compressed.clear();
+        bool ok = compress({}, true, true, compressed) && commit(compressed);
+        lock.lock();
+        failed_ = !ok;
+        committed_bytes_ = appended_bytes_;
+        written_bytes_ += compressed.size();
+        batch_done_.notify_all();
+    }
+}
+
+bool JsonlWriter::compress(const std::string& batch, bool end_frame, bool finish, std::string& out) {
+    std::string_view rest = batch;
+    while (!rest.empty()) {
+        // Fill the frame up to the first line end past its room
+        size_t cut = rest.size();
+        size_t room = compressor_->frame_room();
+        if (room < rest.size()) {
+            size_t newline = rest.find('\n', room > 0 ? room - 1 : 0);
+            cut = newline == std::string_view::npos ? rest.size() : newline + 1;
+        }
+        compressor_->append(rest.substr(0, cut));
+        rest.remove_prefix(cut);
+        if (compressor_->frame_full() && !compressor_->end_frame(out)) {
+            return false;
+        }
+    }
+    if (finish) {
+        return compressor_->finish(out);
+    }
+    return !end_frame || compressor_->end_frame(out);
+}
+
+bool JsonlWriter::commit(const std::string& batch) {
+    // One write() per batch; the loop only handles short writes and signals
+    size_t written = 0;
+    while (written < batch.size()) {
+        ssize_t count = ::write(fd_, batch.data() + written, batch.size() - written);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "JSONL write failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        written += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+bool JsonlWriter::sync() {
+    if (::fdatasync(fd_) != 0) {
+        std::cerr << "JSONL fdatasync failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,282 @@
+#include "storage/PaperJson.h"
+#include <charconv>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    constexpr std::string_view kReplacementCharacter = "\xEF\xBF\xBD";
+
+    // Offset of the next byte that cannot be copied verbatim: '"', '\\', a
+    // control character or the lead byte of a non-ASCII sequence (which is
+    // validated on the slow path). As signed bytes, controls and non-ASCII
+    // are exactly the values below 0x20.
+    size_t find_escape(const char* p, size_t n) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i limit = _mm256_set1_epi8(0x20);
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash));
+            hit = _mm256_or_si256(hit, _mm256_cmpgt_epi8(limit, v));
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+            if (mask != 0) {
+                return i + __builtin_ctz(mask);
+            }
+        }
+#elif defined(__SSE2__)
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i limit = _mm_set1_epi8(0x20);
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash));
+            hit = _mm_or_si128(hit, _mm_cmplt_epi8(v, limit));
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+            if (mask != 0) {
+                return i + __builtin_ctz(mask);
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            auto c = static_cast<unsigned char>(p[i]);
+            if (c == '"' || c == '\\' || c < 0x20 || c >= 0x80) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    // The UTF-8 sequence at `p`: its length if well-formed; otherwise the
+    // length of its maximal subpart (the lead byte and the continuation
+    // bytes that could still have completed it), which is replaced by one
+    // U+FFFD as Unicode recommends and nlohmann's replace handler does
+    struct Utf8Sequence {
+        size_t length;
+        bool valid;
+    };
+
+    Utf8Sequence utf8_sequence(const unsigned char* p, size_t n) {
+        unsigned char lead = p[0];
+        size_t length;
+        // Range of the second byte: excludes overlong forms, surrogates and
+        // code points beyond U+10FFFF
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            if (lead == 0xE0) low = 0xA0;
+            if (lead == 0xED) high = 0x9F;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            if (lead == 0xF0) low = 0x90;
+            if (lead == 0xF4) high = 0x8F;
+        } else {
+            return {1, false};
+        }
+
+        for (size_t i = 1; i < length; ++i) {
+            if (i >= n || p[i] < low || p[i] > high) {
+                return {i, false};
+            }
+            low = 0x80;
+            high = 0xBF;
+        }
+        return {length, true};
+    }
+
+    void write_escaped_byte(unsigned char c, std::string& out) {
+        switch (c) {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\b': out.append("\\b"); break;
+            case '\f': out.append("\\f"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default: {
+                constexpr char kHex[] = "0123456789abcdef";
+                char escaped[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+                out.append(escaped, sizeof(escaped));
+            }
+        }
+    }
+
+    std::string_view text_of(std::string_view text) { return text; }
+    std::string_view text_of(Symbol symbol) { return symbol.str(); }
+
+    // Separators and indentation; keys are written in the order given, which
+    // callers keep alphabetical to match nlohmann's (sorted) output
+    class Emitter {
+    public:
+        Emitter(std::string& out, paper_json::Style style)
+                : out_(out), pretty_(style == paper_json::Style::Pretty) {}
+
+        void open(char bracket) {
+            out_.push_back(bracket);
+            ++depth_;
+            first_ = true;
+        }
+
+        void close(char bracket) {
+            --depth_;
+            if (pretty_ && !first_) {
+                newline();
+            }
+            out_.push_back(bracket);
+            first_ = false;
+        }
+
+        // Before every array element
+        void element() {
+            if (!first_) {
+                out_.push_back(',');
+            }
+            if (pretty_) {
+                newline();
+            }
+            first_ = false;
+        }
+
+        void key(std::string_view name) {
+            element();
+            out_.push_back('"');
+            out_.append(name);
+            out_.append(pretty_ ? "\": " : "\":");
+        }
+
+        void string(std::string_view text) { paper_json::write_string(text, out_); }
+
+        void date(std::chrono::system_clock::time_point time) {
+            char text[iso_date::kFormattedLength];
+            auto seconds = std::chrono::floor<std::chrono::seconds>(time).time_since_epoch().count();
+            iso_date::format_epoch_seconds(seconds, text);
+            out_.push_back('"');
+            out_.append(text, sizeof(text));
+            out_.push_back('"');
+        }
+
+        void number(int value) {
+            char text[16];
+            auto result = std::to_chars(text, text + sizeof(text), value);
+            out_.append(text, result.ptr);
+        }
+
+        template <typename Strings>
+        void string_array(const Strings& values) {
+            open('[');
+            for (const auto& value : values) {
+                element();
+                string(text_of(value));
+            }
+            close(']');
+        }
+
+    private:
+        void newline() {
+            out_.push_back('\n');
+            out_.append(depth_ * 4, ' ');
+        }
+
+        std::string& out_;
+        bool pretty_;
+        size_t depth_ = 0;
+        bool first_ = true;
+    };
+
+    template <typename PaperT>
+    size_t write_paper(const PaperT& paper, std::string& out, paper_json::Style style) {
+        size_t start = out.size();
+        Emitter json(out, style);
+
+        json.open('{');
+        json.key("abstract");
+        json.string(paper.abstract);
+        json.key("authors");
+        json.open('[');
+        for (const auto& author : paper.authors) {
+            json.element();
+            json.open('{');
+            json.key("affiliation");
+            json.string(text_of(author.affiliation));
+            json.key("name");
+            json.string(author.name);
+            json.key("orcid");
+            json.string(author.orcid);
+            json.close('}');
+        }
+        json.close(']');
+        json.key("categories");
+        json.string_array(paper.categories);
+        json.key("comment");
+        json.string(paper.comment);
+        json.key("doi");
+        json.string(paper.doi);
+        json.key("id");
+        json.string(paper.id);
+        json.key("journal_ref");
+        json.string(paper.journal_ref);
+        json.key("keywords");
+        json.string_array(paper.keywords);
+        json.key("pdf_url");
+        json.string(paper.pdf_url);
+        json.key("published_date");
+        json.date(paper.published_date);
+        json.key("source");
+        json.string(text_of(paper.source));
+        json.key("title");
+        json.string(paper.title);
+        json.key("updated_date");
+        json.date(paper.updated_date);
+        json.key("version");
+        json.number(paper.version);
+        json.close('}');
+
+        return out.size() - start;
+    }
+}
+
+namespace paper_json {
+
+    size_t write(const Paper& paper, std::string& out, Style style) {
+        return write_paper(paper, out, style);
+    }
+
+    size_t write(const PaperView& paper, std::string& out, Style style) {
+        return write_paper(paper, out, style);
+    }
+
+    void write_string(std::string_view text, std::string& out) {
+        out.push_back('"');
+        const char* p = text.data();
+        size_t n = text.size();
+        size_t i = 0;
+        while (i < n) {
+            size_t run = find_escape(p + i, n - i);
+            out.append(p + i, run);
+            i += run;
+            if (i == n) {
+                break;
+            }
+
+            auto c = static_cast<unsigned char>(p[i]);
+            if (c < 0x80) {
+                write_escaped_byte(c, out);
+                ++i;
+            } else {
+                auto sequence = utf8_sequence(reinterpret_cast<const unsigned char*>(p + i), n - i);
+                if (sequence.valid) {
+                    out.append(p + i, sequence.length);
+                } else {
+                    out.append(kReplacementCharacter);
+                }
+                i += sequence.length;
+            }
+        }
+        out.push_back('"');
+    }
+}
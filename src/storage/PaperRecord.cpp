@@ -0,0 +1,262 @@
+#include "storage/PaperRecord.h"
+#include <array>
+#include <cstring>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace {
+    std::string_view text_of(std::string_view text) { return text; }
+    std::string_view text_of(Symbol symbol) { return symbol.str(); }
+
+    void put_varint(uint64_t value, std::string& out) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    void put_string(std::string_view text, std::string& out) {
+        put_varint(text.size(), out);
+        out.append(text);
+    }
+
+    void put_time(std::chrono::system_clock::time_point time, std::string& out) {
+        auto seconds = std::chrono::floor<std::chrono::seconds>(time).time_since_epoch().count();
+        auto bits = static_cast<uint64_t>(seconds);
+        for (int i = 0; i < 8; ++i) {
+            out.push_back(static_cast<char>(bits >> (8 * i)));
+        }
+    }
+
+    template <typename PaperT>
+    size_t encode_paper(const PaperT& paper, std::string& out) {
+        size_t start = out.size();
+        out.push_back(static_cast<char>(paper_record::kVersion));
+
+        put_string(paper.id, out);
+        put_string(paper.title, out);
+        put_string(paper.abstract, out);
+        put_string(paper.doi, out);
+        put_string(paper.pdf_url, out);
+        put_string(text_of(paper.source), out);
+        put_string(paper.journal_ref, out);
+        put_string(paper.comment, out);
+        put_time(paper.published_date, out);
+        put_time(paper.updated_date, out);
+
+        auto version = static_cast<int64_t>(paper.version);
+        put_varint((static_cast<uint64_t>(version) << 1) ^ static_cast<uint64_t>(version >> 63), out);
+
+        put_varint(paper.authors.size(), out);
+        for (const auto& author : paper.authors) {
+            put_string(author.name, out);
+            put_string(text_of(author.affiliation), out);
+            put_string(author.orcid, out);
+        }
+        put_varint(paper.categories.size(), out);
+        for (const auto& category : paper.categories) {
+            put_string(text_of(category), out);
+        }
+        put_varint(paper.keywords.size(), out);
+        for (const auto& keyword : paper.keywords) {
+            put_string(keyword, out);
+        }
+
+        return out.size() - start;
+    }
+
+    // Bounds-checked cursor over one record; any overrun clears ok()
+    class Cursor {
+    public:
+        explicit Cursor(std::string_view record) : p_(record.data()), end_(record.data() + record.size()) {}
+
+        bool ok() const { return ok_; }
+        bool at_end() const { return p_ == end_; }
+
+        uint8_t byte() {
+            if (p_ == end_) {
+                ok_ = false;
+                return 0;
+            }
+            return static_cast<uint8_t>(*p_++);
+        }
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                uint8_t b = byte();
+                value |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80)) {
+                    return value;
+                }
+            }
+            ok_ = false;
+            return 0;
+        }
+
+        std::string_view string() {
+            uint64_t size = varint();
+            if (size > static_cast<uint64_t>(end_ - p_)) {
+                ok_ = false;
+                return {};
+            }
+            std::string_view text(p_, size);
+            p_ += size;
+            return text;
+        }
+
+        std::chrono::system_clock::time_point time() {
+            if (end_ - p_ < 8) {
+                ok_ = false;
+                return {};
+            }
+            uint64_t bits = 0;
+            for (int i = 0; i < 8; ++i) {
+                bits |= static_cast<uint64_t>(static_cast<uint8_t>(p_[i])) << (8 * i);
+            }
+            p_ += 8;
+
+            // Corrupt input must not overflow the clock's finer duration
+            constexpr auto kLimit = std::chrono::duration_cast<std::chrono::seconds>(
+                    std::chrono::system_clock::duration::max()).count();
+            auto seconds = static_cast<int64_t>(bits);
+            if (seconds > kLimit || seconds < -kLimit) {
+                ok_ = false;
+                return {};
+            }
+            return std::chrono::system_clock::time_point(std::chrono::seconds(seconds));
+        }
+
+        int version() {
+            uint64_t zigzag = varint();
+            return static_cast<int>(static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1));
+        }
+
+        // Element count that cannot exceed the remaining bytes, so a corrupt
+        // count never triggers a huge reserve()
+        size_t count(size_t min_element_size) {
+            uint64_t n = varint();
+            if (n > static_cast<uint64_t>(end_ - p_) / min_element_size) {
+                ok_ = false;
+                return 0;
+            }
+            return static_cast<size_t>(n);
+        }
+
+    private:
+        const char* p_;
+        const char* end_;
+        bool ok_ = true;
+    };
+
+    // Symbols for Paper, plain views for PaperView
+    void assign_text(Symbol& field, std::string_view text) { field = Symbol::intern(text); }
+    void assign_text(std::string_view& field, std::string_view text) { field = text; }
+    template <typename String>
+    void assign_text(String& field, std::string_view text) { field.assign(text.data(), text.size()); }
+
+    template <typename PaperT>
+    bool decode_paper(std::string_view record, PaperT& paper) {
+        Cursor in(record);
+        if (in.byte() != paper_record::kVersion) {
+            return false;
+        }
+
+        assign_text(paper.id, in.string());
+        assign_text(paper.title, in.string());
+        assign_text(paper.abstract, in.string());
+        assign_text(paper.doi, in.string());
+        assign_text(paper.pdf_url, in.string());
+        assign_text(paper.source, in.string());
+        assign_text(paper.journal_ref, in.string());
+        assign_text(paper.comment, in.string());
+        paper.published_date = in.time();
+        paper.updated_date = in.time();
+        paper.version = in.version();
+
+        size_t authors = in.count(3);
+        paper.authors.clear();
+        paper.authors.reserve(authors);
+        for (size_t i = 0; i < authors && in.ok(); ++i) {
+            auto& author = paper.authors.emplace_back();
+            assign_text(author.name, in.string());
+            assign_text(author.affiliation, in.string());
+            assign_text(author.orcid, in.string());
+        }
+
+        size_t categories = in.count(1);
+        paper.categories.clear();
+        paper.categories.reserve(categories);
+        for (size_t i = 0; i < categories && in.ok(); ++i) {
+            assign_text(paper.categories.emplace_back(), in.string());
+        }
+
+        size_t keywords = in.count(1);
+        paper.keywords.clear();
+        paper.keywords.reserve(keywords);
+        for (size_t i = 0; i < keywords && in.ok(); ++i) {
+            assign_text(paper.keywords.emplace_back(), in.string());
+        }
+
+        return in.ok() && in.at_end();
+    }
+
+#if !defined(__SSE4_2__)
+    constexpr std::array<uint32_t, 256> make_crc32c_table() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    constexpr auto kCrc32cTable = make_crc32c_table();
+#endif
+}
+
+namespace paper_record {
+
+    size_t encode(const Paper& paper, std::string& out) {
+        return encode_paper(paper, out);
+    }
+
+    size_t encode(const PaperView& paper, std::string& out) {
+        return encode_paper(paper, out);
+    }
+
+    bool decode(std::string_view record, Paper& paper) {
+        return decode_paper(record, paper);
+    }
+
+    bool decode(std::string_view record, PaperView& paper) {
+        return decode_paper(record, paper);
+    }
+
+    uint32_t crc32c(const void* data, size_t size, uint32_t crc) {
+        auto p = static_cast<const unsigned char*>(data);
+        crc = ~crc;
+#if defined(__SSE4_2__)
+        uint64_t wide = crc;
+        for (; size >= 8; size -= 8, p += 8) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            wide = _mm_crc32_u64(wide, word);
+        }
+        crc = static_cast<uint32_t>(wide);
+        for (; size > 0; --size, ++p) {
+            crc = _mm_crc32_u8(crc, *p);
+        }
+#else
+        for (; size > 0; --size, ++p) {
+            crc = kCrc32cTable[(crc ^ *p) & 0xFF] ^ (crc >> 8);
+        }
+#endif
+        return ~crc;
+    }
+}
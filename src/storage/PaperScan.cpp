@@ -0,0 +1,113 @@
+#include "storage/PaperScan.h"
+#include <iostream>
+
+void ScanFilter::project(Paper& paper) const {
+    auto drop = [](auto& field) {
+        field.clear();
+        field.shrink_to_fit();
+    };
+    if (!has_field(fields, PaperField::TITLE)) drop(paper.title);
+    if (!has_field(fields, PaperField::ABSTRACT)) drop(paper.abstract);
+    if (!has_field(fields, PaperField::AUTHORS)) drop(paper.authors);
+    if (!has_field(fields, PaperField::DOI)) drop(paper.doi);
+    if (!has_field(fields, PaperField::PDF_URL)) drop(paper.pdf_url);
+    if (!has_field(fields, PaperField::JOURNAL_REF)) drop(paper.journal_ref);
+    if (!has_field(fields, PaperField::COMMENT)) drop(paper.comment);
+    if (!has_field(fields, PaperField::KEYWORDS)) drop(paper.keywords);
+}
+
+void ScanFilter::project(PaperView& paper) const {
+    // Nothing is copied for dropped fields when the view becomes a Paper
+    if (!has_field(fields, PaperField::TITLE)) paper.title = {};
+    if (!has_field(fields, PaperField::ABSTRACT)) paper.abstract = {};
+    if (!has_field(fields, PaperField::AUTHORS)) paper.authors.clear();
+    if (!has_field(fields, PaperField::DOI)) paper.doi = {};
+    if (!has_field(fields, PaperField::PDF_URL)) paper.pdf_url = {};
+    if (!has_field(fields, PaperField::JOURNAL_REF)) paper.journal_ref = {};
+    if (!has_field(fields, PaperField::COMMENT)) paper.comment = {};
+    if (!has_field(fields, PaperField::KEYWORDS)) paper.keywords.clear();
+}
+
+PaperScan::PaperScan(Producer producer, size_t batch_papers, size_t read_ahead_batches)
+        : state_(std::make_unique<State>()) {
+    state_->thread = std::jthread(
+            [state = state_.get(), producer = std::move(producer), batch_papers = std::max<size_t>(batch_papers, 1),
+             read_ahead_batches = std::max<size_t>(read_ahead_batches, 1)](std::stop_token stop_token) {
+                state->produce(stop_token, producer, batch_papers, read_ahead_batches);
+            });
+}
+
+void PaperScan::State::produce(std::stop_token stop_token, const Producer& producer, size_t batch_papers,
+                               size_t read_ahead_batches) {
+    std::vector<Paper> batch;
+    auto push = [&] {
+        std::unique_lock lock(mutex);
+        if (!batch_taken.wait(lock, stop_token, [&] { return batches.size() < read_ahead_batches; })) {
+            return false;  // stop requested
+        }
+        batches.push_back(std::move(batch));
+        lock.unlock();
+        batch_ready.notify_one();
+        batch = {};
+        batch.reserve(batch_papers);
+        return true;
+    };
+
+    batch.reserve(batch_papers);
+    try {
+        producer([&](Paper&& paper) {
+            batch.push_back(std::move(paper));
+            if (batch.size() < batch_papers) {
+                return !stop_token.stop_requested();
+            }
+            return push();
+        });
+        if (!batch.empty()) {
+            push();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Scan stopped: " << e.what() << std::endl;
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        done = true;
+    }
+    batch_ready.notify_one();
+}
+
+bool PaperScan::State::take_batch() {
+    std::unique_lock lock(mutex);
+    batch_ready.wait(lock, [&] { return done || !batches.empty(); });
+    if (batches.empty()) {
+        current.clear();
+        return false;
+    }
+    current = std::move(batches.front());
+    batches.pop_front();
+    lock.unlock();
+    batch_taken.notify_one();
+    return true;
+}
+
+PaperScan::iterator::iterator(State* state) : state_(state) {
+    next_batch();
+}
+
+void PaperScan::iterator::next_batch() {
+    index_ = 0;
+    // Empty batches are never pushed, but skip them all the same
+    while (state_->take_batch()) {
+        if (!state_->current.empty()) {
+            return;
+        }
+    }
+    state_ = nullptr;
+}
+
+PaperScan::iterator& PaperScan::iterator::operator++() {
+    if (++index_ == state_->current.size()) {
+        next_batch();
+    }
+    return *this;
+}
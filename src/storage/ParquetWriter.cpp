@@ -0,0 +1,728 @@
+#include "storage/ParquetWriter.h"
+#include <iostream>
+#include <unordered_map>
+#include <algorithm>
+#include <bit>
+#if defined(CRAWLER_USE_ZSTD)
+#include <zstd.h>
+#endif
+
+// Parquet's metadata is Thrift (compact protocol); the constants below are
+// the ones from parquet.thrift that this writer needs.
+namespace {
+    constexpr std::string_view kMagic = "PAR1";
+
+    enum ThriftType : uint8_t {
+        T_BOOL_TRUE = 1, T_BOOL_FALSE = 2, T_I16 = 4, T_I32 = 5, T_I64 = 6,
+        T_BINARY = 8, T_LIST = 9, T_STRUCT = 12
+    };
+
+    enum PhysicalType : int32_t { INT32 = 1, INT64 = 2, BYTE_ARRAY = 6 };
+    enum Repetition : int32_t { REQUIRED = 0, REPEATED = 2 };
+    enum ConvertedType : int32_t { UTF8 = 0, LIST = 3, TIMESTAMP_MILLIS = 9 };
+    enum Encoding : int32_t { PLAIN = 0, RLE = 3, RLE_DICTIONARY = 8 };
+    enum PageType : int32_t { DATA_PAGE = 0, DICTIONARY_PAGE = 2 };
+    enum CodecId : int32_t { CODEC_UNCOMPRESSED = 0, CODEC_ZSTD = 6 };
+
+    // Thrift compact protocol. Field ids are delta-encoded within a struct,
+    // so nested structs save and restore the last id.
+    class Thrift {
+    public:
+        explicit Thrift(std::string& out) : out_(out) {}
+
+        void i16(int16_t id, int16_t value) {
+            field(id, T_I16);
+            varint(zigzag(value));
+        }
+
+        void i32(int16_t id, int32_t value) {
+            field(id, T_I32);
+            varint(zigzag(value));
+        }
+
+        void i64(int16_t id, int64_t value) {
+            field(id, T_I64);
+            varint(zigzag(value));
+        }
+
+        void boolean(int16_t id, bool value) { field(id, value ? T_BOOL_TRUE : T_BOOL_FALSE); }
+
+        void binary(int16_t id, std::string_view value) {
+            field(id, T_BINARY);
+            raw_binary(value);
+        }
+
+        void begin_struct(int16_t id) {
+            field(id, T_STRUCT);
+            begin_element_struct();
+        }
+
+        // A struct that is a list element has no field header
+        void begin_element_struct() {
+            stack_.push_back(last_id_);
+            last_id_ = 0;
+        }
+
+        void end_struct() {
+            out_.push_back(0);
+            last_id_ = stack_.back();
+            stack_.pop_back();
+        }
+
+        void begin_list(int16_t id, ThriftType element_type, size_t size) {
+            field(id, T_LIST);
+            if (size < 15) {
+                out_.push_back(static_cast<char>(size << 4 | element_type));
+            } else {
+                out_.push_back(static_cast<char>(0xF0 | element_type));
+                varint(size);
+            }
+        }
+
+        void element_i32(int32_t value) { varint(zigzag(value)); }
+        void element_binary(std::string_view value) { raw_binary(value); }
+
+        // Ends the outermost struct
+        void stop() { out_.push_back(0); }
+
+    private:
+        static uint64_t zigzag(int64_t value) {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        void field(int16_t id, uint8_t type) {
+            int delta = id - last_id_;
+            if (delta > 0 && delta <= 15) {
+                out_.push_back(static_cast<char>(delta << 4 | type));
+            } else {
+                out_.push_back(static_cast<char>(type));
+                varint(zigzag(id));
+            }
+            last_id_ = id;
+        }
+
+        void varint(uint64_t value) {
+            while (value >= 0x80) {
+                out_.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out_.push_back(static_cast<char>(value));
+        }
+
+        void raw_binary(std::string_view value) {
+            varint(value.size());
+            out_.append(value);
+        }
+
+        std::string& out_;
+        int16_t last_id_ = 0;
+        std::vector<int16_t> stack_;
+    };
+
+    void put_u32(uint32_t value, std::string& out) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    void put_u64(uint64_t value, std::string& out) {
+        put_u32(static_cast<uint32_t>(value), out);
+        put_u32(static_cast<uint32_t>(value >> 32), out);
+    }
+
+    void put_varint(uint64_t value, std::string& out) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    // RLE / bit-packing hybrid: runs of 8 or more equal values become RLE
+    // runs, everything else is bit-packed in groups of 8
+    void encode_hybrid(const std::vector<uint32_t>& values, int bit_width, std::string& out) {
+        auto bit_pack = [&](size_t begin, size_t end) {
+            if (begin == end) return;
+            size_t groups = (end - begin + 7) / 8;
+            put_varint(groups << 1 | 1, out);
+            uint64_t bits = 0;
+            int used = 0;
+            for (size_t i = begin; i < begin + groups * 8; ++i) {
+                bits |= static_cast<uint64_t>(i < end ? values[i] : 0) << used;
+                used += bit_width;
+                while (used >= 8) {
+                    out.push_back(static_cast<char>(bits));
+                    bits >>= 8;
+                    used -= 8;
+                }
+            }
+        };
+
+        size_t byte_width = (static_cast<size_t>(bit_width) + 7) / 8;
+        size_t packed_from = 0;
+        size_t i = 0;
+        while (i < values.size()) {
+            size_t run_end = i;
+            while (run_end < values.size() && values[run_end] == values[i]) ++run_end;
+
+            // Complete the pending bit-packed groups from the run first
+            size_t run_start = i + (8 - (i - packed_from) % 8) % 8;
+            if (run_end >= run_start + 8) {
+                bit_pack(packed_from, run_start);
+                put_varint((run_end - run_start) << 1, out);
+                for (size_t b = 0; b < byte_width; ++b) {
+                    out.push_back(static_cast<char>(values[i] >> (8 * b)));
+                }
+                packed_from = run_end;
+            }
+            i = run_end;
+        }
+        bit_pack(packed_from, values.size());
+    }
+
+    // Levels in a v1 data page are prefixed by their byte length
+    void encode_levels(const std::vector<uint32_t>& levels, std::string& out) {
+        std::string encoded;
+        encode_hybrid(levels, 1, encoded);
+        put_u32(static_cast<uint32_t>(encoded.size()), out);
+        out.append(encoded);
+    }
+
+    bool compress(ParquetCodec codec, const std::string& input, std::string& output) {
+#if defined(CRAWLER_USE_ZSTD)
+        if (codec == ParquetCodec::ZSTD) {
+            output.resize(ZSTD_compressBound(input.size()));
+            size_t size = ZSTD_compress(output.data(), output.size(), input.data(), input.size(), 3);
+            if (ZSTD_isError(size)) {
+                std::cerr << "Parquet zstd compression failed: " << ZSTD_getErrorName(size) << std::endl;
+                return false;
+            }
+            output.resize(size);
+            return true;
+        }
+#endif
+        (void)codec;
+        output = input;
+        return true;
+    }
+
+    int32_t codec_id(ParquetCodec codec) {
+#if defined(CRAWLER_USE_ZSTD)
+        if (codec == ParquetCodec::ZSTD) return CODEC_ZSTD;
+#endif
+        (void)codec;
+        return CODEC_UNCOMPRESSED;
+    }
+
+    std::string_view text_of(std::string_view text) { return text; }
+    std::string_view text_of(Symbol symbol) { return symbol.str(); }
+
+    int64_t epoch_millis(std::chrono::system_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    }
+
+    // Lets the dictionary be probed with string_views
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+    };
+
+    // Leaf columns, in schema order
+    enum ColumnIndex {
+        kId, kTitle, kAbstract, kAuthorName, kAuthorAffiliation, kAuthorOrcid, kDoi, kPdfUrl,
+        kSource, kCategories, kPublishedDate, kUpdatedDate, kJournalRef, kComment, kVersion,
+        kKeywords, kColumnCount
+    };
+}
+
+std::optional<ParquetCodec> parse_parquet_codec(const std::string& name) {
+    if (name == "none") return ParquetCodec::UNCOMPRESSED;
+    if (name == "zstd") return ParquetCodec::ZSTD;
+    return std::nullopt;
+}
+
+// One leaf column's values for the current row group
+struct ParquetWriter::Column {
+    std::string name;                // top-level field, for codec overrides
+    std::vector<std::string> path;   // path_in_schema
+    PhysicalType type;
+    bool repeated;                   // inside a list: max repetition/definition level 1
+    bool dictionary;
+    bool statistics;
+    ParquetCodec codec = ParquetCodec::UNCOMPRESSED;
+
+    std::vector<uint32_t> repetition_levels;
+    std::vector<uint32_t> definition_levels;
+    size_t num_values = 0;           // level count (values plus empty lists)
+    std::string plain;               // PLAIN values, unless dictionary
+    std::vector<uint32_t> indices;   // dictionary ids
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> dictionary_ids;
+    std::string dictionary_page;     // PLAIN dictionary values
+
+    std::string min_value, max_value;
+    int64_t min_int = 0, max_int = 0;
+    bool has_values = false;
+
+    Column(std::string name, std::vector<std::string> path, PhysicalType type,
+           bool repeated, bool dictionary, bool statistics)
+            : name(std::move(name)), path(std::move(path)), type(type), repeated(repeated),
+              dictionary(dictionary), statistics(statistics) {}
+
+    size_t buffered_bytes() const {
+        return plain.size() + dictionary_page.size() + indices.size() * 4 +
+               (repetition_levels.size() + definition_levels.size()) / 4;
+    }
+
+    // Position within a list: first element, following element, or an
+    // empty list (no value)
+    void level(bool first, bool present) {
+        if (repeated) {
+            repetition_levels.push_back(first ? 0 : 1);
+            definition_levels.push_back(present ? 1 : 0);
+        }
+        ++num_values;
+    }
+
+    void add_string(std::string_view value) {
+        if (dictionary) {
+            auto it = dictionary_ids.find(value);
+            if (it == dictionary_ids.end()) {
+                it = dictionary_ids.emplace(value, static_cast<uint32_t>(dictionary_ids.size())).first;
+                put_u32(static_cast<uint32_t>(value.size()), dictionary_page);
+                dictionary_page.append(value);
+            }
+            indices.push_back(it->second);
+        } else {
+            put_u32(static_cast<uint32_t>(value.size()), plain);
+            plain.append(value);
+        }
+
+        if (statistics) {
+            if (!has_values || value < min_value) min_value = value;
+            if (!has_values || value > max_value) max_value = value;
+        }
+        has_values = true;
+    }
+
+    void add_int(int64_t value) {
+        if (type == INT32) {
+            put_u32(static_cast<uint32_t>(value), plain);
+        } else {
+            put_u64(static_cast<uint64_t>(value), plain);
+        }
+        if (!has_values || value < min_int) min_int = value;
+        if (!has_values || value > max_int) max_int = value;
+        has_values = true;
+    }
+
+    std::string encoded_stat(bool max) const {
+        if (type == BYTE_ARRAY) {
+            return max ? max_value : min_value;
+        }
+        std::string bytes;
+        int64_t value = max ? max_int : min_int;
+        if (type == INT32) {
+            put_u32(static_cast<uint32_t>(value), bytes);
+        } else {
+            put_u64(static_cast<uint64_t>(value), bytes);
+        }
+        return bytes;
+    }
+
+    void reset() {
+        repetition_levels.clear();
+        definition_levels.clear();
+        num_values = 0;
+        plain.clear();
+        indices.clear();
+        dictionary_ids.clear();
+        dictionary_page.clear();
+        min_value.clear();
+        max_value.clear();
+        has_values = false;
+    }
+};
+
+ParquetWriter::ParquetWriter() : ParquetWriter(Options{}) {
+}
+
+ParquetWriter::ParquetWriter(Options options) : options_(std::move(options)) {
+    auto add = [this](std::string name, std::vector<std::string> path, PhysicalType type,
+                      bool repeated, bool dictionary, bool statistics) {
+        columns_.push_back(std::make_unique<Column>(std::move(name), std::move(path), type,
+                                                    repeated, dictionary, statistics));
+    };
+    // Free text gets no statistics: min/max of abstracts help no reader
+    add("id", {"id"}, BYTE_ARRAY, false, false, true);
+    add("title", {"title"}, BYTE_ARRAY, false, false, false);
+    add("abstract", {"abstract"}, BYTE_ARRAY, false, false, false);
+    add("authors", {"authors", "list", "element", "name"}, BYTE_ARRAY, true, false, false);
+    add("authors", {"authors", "list", "element", "affiliation"}, BYTE_ARRAY, true, true, false);
+    add("authors", {"authors", "list", "element", "orcid"}, BYTE_ARRAY, true, false, false);
+    add("doi", {"doi"}, BYTE_ARRAY, false, false, true);
+    add("pdf_url", {"pdf_url"}, BYTE_ARRAY, false, false, false);
+    add("source", {"source"}, BYTE_ARRAY, false, true, true);
+    add("categories", {"categories", "list", "element"}, BYTE_ARRAY, true, true, true);
+    add("published_date", {"published_date"}, INT64, false, false, true);
+    add("updated_date", {"updated_date"}, INT64, false, false, true);
+    add("journal_ref", {"journal_ref"}, BYTE_ARRAY, false, false, false);
+    add("comment", {"comment"}, BYTE_ARRAY, false, false, false);
+    add("version", {"version"}, INT32, false, false, true);
+    add("keywords", {"keywords", "list", "element"}, BYTE_ARRAY, true, true, true);
+
+    for (auto& column : columns_) {
+        auto it = options_.column_codecs.find(column->name);
+        column->codec = it != options_.column_codecs.end() ? it->second : options_.codec;
+    }
+}
+
+ParquetWriter::~ParquetWriter() {
+    close();
+}
+
+bool ParquetWriter::open(const std::string& path) {
+    if (is_open() && !close()) {
+        return false;
+    }
+
+#if !defined(CRAWLER_USE_ZSTD)
+    bool wants_zstd = options_.codec == ParquetCodec::ZSTD;
+    for (const auto& [name, codec] : options_.column_codecs) {
+        wants_zstd = wants_zstd || codec == ParquetCodec::ZSTD;
+    }
+    if (wants_zstd) {
+        std::cerr << "Built without zstd (CRAWLER_USE_ZSTD), writing uncompressed Parquet" << std::endl;
+    }
+#endif
+
+    file_.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+    file_.write(kMagic.data(), kMagic.size());
+    file_offset_ = kMagic.size();
+    group_rows_ = 0;
+    total_rows_ = 0;
+    row_groups_.clear();
+    row_group_count_ = 0;
+    for (auto& column : columns_) {
+        column->reset();
+    }
+    return file_.good();
+}
+
+bool ParquetWriter::append(const Paper& paper) {
+    return append_row(paper);
+}
+
+bool ParquetWriter::append(const PaperView& paper) {
+    return append_row(paper);
+}
+
+template <typename PaperT>
+bool ParquetWriter::append_row(const PaperT& paper) {
+    if (!is_open()) {
+        return false;
+    }
+
+    auto string = [this](ColumnIndex index, std::string_view value) {
+        columns_[index]->level(true, true);
+        columns_[index]->add_string(value);
+    };
+    auto list = [this](ColumnIndex index, const auto& values) {
+        Column& column = *columns_[index];
+        if (values.empty()) {
+            column.level(true, false);
+        }
+        bool first = true;
+        for (const auto& value : values) {
+            column.level(first, true);
+            column.add_string(text_of(value));
+            first = false;
+        }
+    };
+
+    string(kId, paper.id);
+    string(kTitle, paper.title);
+    string(kAbstract, paper.abstract);
+    if (paper.authors.empty()) {
+        for (auto index : {kAuthorName, kAuthorAffiliation, kAuthorOrcid}) {
+            columns_[index]->level(true, false);
+        }
+    }
+    bool first = true;
+    for (const auto& author : paper.authors) {
+        columns_[kAuthorName]->level(first, true);
+        columns_[kAuthorName]->add_string(author.name);
+        columns_[kAuthorAffiliation]->level(first, true);
+        columns_[kAuthorAffiliation]->add_string(text_of(author.affiliation));
+        columns_[kAuthorOrcid]->level(first, true);
+        columns_[kAuthorOrcid]->add_string(author.orcid);
+        first = false;
+    }
+    string(kDoi, paper.doi);
+    string(kPdfUrl, paper.pdf_url);
+    string(kSource, text_of(paper.source));
+    list(kCategories, paper.categories);
+    columns_[kPublishedDate]->level(true, true);
+    columns_[kPublishedDate]->add_int(epoch_millis(paper.published_date));
+    columns_[kUpdatedDate]->level(true, true);
+    columns_[kUpdatedDate]->add_int(epoch_millis(paper.updated_date));
+    string(kJournalRef, paper.journal_ref);
+    string(kComment, paper.comment);
+    columns_[kVersion]->level(true, true);
+    columns_[kVersion]->add_int(paper.version);
+    list(kKeywords, paper.keywords);
+
+    ++group_rows_;
+    ++total_rows_;
+
+    size_t buffered = 0;
+    for (const auto& column : columns_) {
+        buffered += column->buffered_bytes();
+    }
+    if (group_rows_ >= options_.row_group_rows || buffered >= options_.row_group_bytes) {
+        return flush_row_group();
+    }
+    return true;
+}
+
+uint64_t ParquetWriter::size() const {
+    uint64_t size = file_offset_;
+    for (const auto& column : columns_) {
+        size += column->buffered_bytes();
+    }
+    return size;
+}
+
+bool ParquetWriter::flush_row_group() {
+    if (group_rows_ == 0) {
+        return true;
+    }
+
+    uint64_t group_offset = file_offset_;
+    int64_t group_uncompressed = 0;
+    int64_t group_compressed = 0;
+
+    std::string chunks;
+    Thrift chunk_list(chunks);
+    std::string page_header;
+    std::string body;
+    std::string compressed;
+
+    // Writes one page: header, then the (compressed) body
+    auto write_page = [&](Column& column, PageType type, int32_t num_values,
+                          Encoding encoding) -> std::pair<int64_t, int64_t> {
+        if (!compress(column.codec, body, compressed)) {
+            return {-1, -1};
+        }
+        page_header.clear();
+        Thrift header(page_header);
+        header.i32(1, type);
+        header.i32(2, static_cast<int32_t>(body.size()));
+        header.i32(3, static_cast<int32_t>(compressed.size()));
+        if (type == DATA_PAGE) {
+            header.begin_struct(5);
+            header.i32(1, num_values);
+            header.i32(2, encoding);
+            header.i32(3, RLE);
+            header.i32(4, RLE);
+            header.end_struct();
+        } else {
+            header.begin_struct(7);
+            header.i32(1, num_values);
+            header.i32(2, encoding);
+            header.end_struct();
+        }
+        header.stop();
+
+        file_.write(page_header.data(), static_cast<std::streamsize>(page_header.size()));
+        file_.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+        file_offset_ += page_header.size() + compressed.size();
+        return {static_cast<int64_t>(page_header.size() + body.size()),
+                static_cast<int64_t>(page_header.size() + compressed.size())};
+    };
+
+    for (auto& column_ptr : columns_) {
+        Column& column = *column_ptr;
+        uint64_t chunk_offset = file_offset_;
+        int64_t uncompressed = 0;
+        int64_t compressed_size = 0;
+
+        std::optional<uint64_t> dictionary_offset;
+        if (column.dictionary) {
+            dictionary_offset = file_offset_;
+            body = column.dictionary_page;
+            auto [u, c] = write_page(column, DICTIONARY_PAGE,
+                                     static_cast<int32_t>(column.dictionary_ids.size()), PLAIN);
+            if (u < 0) return false;
+            uncompressed += u;
+            compressed_size += c;
+        }
+
+        uint64_t data_offset = file_offset_;
+        body.clear();
+        if (column.repeated) {
+            encode_levels(column.repetition_levels, body);
+            encode_levels(column.definition_levels, body);
+        }
+        if (column.dictionary) {
+            size_t max_id = std::max<size_t>(column.dictionary_ids.size(), 2) - 1;
+            int bit_width = static_cast<int>(std::bit_width(max_id));
+            body.push_back(static_cast<char>(bit_width));
+            encode_hybrid(column.indices, bit_width, body);
+        } else {
+            body.append(column.plain);
+        }
+        auto [u, c] = write_page(column, DATA_PAGE, static_cast<int32_t>(column.num_values),
+                                 column.dictionary ? RLE_DICTIONARY : PLAIN);
+        if (u < 0) return false;
+        uncompressed += u;
+        compressed_size += c;
+
+        // ColumnChunk
+        chunk_list.begin_element_struct();
+        chunk_list.i64(2, static_cast<int64_t>(chunk_offset));
+        chunk_list.begin_struct(3);
+        chunk_list.i32(1, column.type);
+        if (column.dictionary) {
+            chunk_list.begin_list(2, T_I32, 3);
+            chunk_list.element_i32(PLAIN);
+            chunk_list.element_i32(RLE);
+            chunk_list.element_i32(RLE_DICTIONARY);
+        } else {
+            chunk_list.begin_list(2, T_I32, 2);
+            chunk_list.element_i32(PLAIN);
+            chunk_list.element_i32(RLE);
+        }
+        chunk_list.begin_list(3, T_BINARY, column.path.size());
+        for (const auto& part : column.path) {
+            chunk_list.element_binary(part);
+        }
+        chunk_list.i32(4, codec_id(column.codec));
+        chunk_list.i64(5, static_cast<int64_t>(column.num_values));
+        chunk_list.i64(6, uncompressed);
+        chunk_list.i64(7, compressed_size);
+        chunk_list.i64(9, static_cast<int64_t>(data_offset));
+        if (dictionary_offset) {
+            chunk_list.i64(11, static_cast<int64_t>(*dictionary_offset));
+        }
+        chunk_list.begin_struct(12);
+        chunk_list.i64(3, 0);  // null_count
+        if (column.statistics && column.has_values) {
+            chunk_list.binary(5, column.encoded_stat(true));
+            chunk_list.binary(6, column.encoded_stat(false));
+        }
+        chunk_list.end_struct();
+        chunk_list.end_struct();
+        chunk_list.end_struct();
+
+        group_uncompressed += uncompressed;
+        group_compressed += compressed_size;
+        column.reset();
+    }
+
+    // RowGroup
+    Thrift group(row_groups_);
+    group.begin_element_struct();
+    group.begin_list(1, T_STRUCT, columns_.size());
+    row_groups_.append(chunks);
+    group.i64(2, group_uncompressed);
+    group.i64(3, static_cast<int64_t>(group_rows_));
+    group.i64(5, static_cast<int64_t>(group_offset));
+    group.i64(6, group_compressed);
+    group.i16(7, static_cast<int16_t>(row_group_count_));
+    group.end_struct();
+
+    ++row_group_count_;
+    group_rows_ = 0;
+    return file_.good();
+}
+
+bool ParquetWriter::close() {
+    if (!is_open()) {
+        return true;
+    }
+
+    bool ok = flush_row_group();
+
+    std::string footer;
+    Thrift meta(footer);
+    meta.i32(1, 1);
+
+    // Schema, depth-first; the root's children are the top-level fields
+    struct Node {
+        std::string_view name;
+        int32_t type;            // -1 for groups
+        int32_t repetition;
+        int32_t children;
+        int32_t converted_type;  // -1 for none
+        int16_t logical_type;    // LogicalType union member, 0 for none
+    };
+    auto string = [](std::string_view name, int32_t repetition = REQUIRED) {
+        return Node{name, BYTE_ARRAY, repetition, 0, UTF8, 1};
+    };
+    auto list = [](std::string_view name) { return Node{name, -1, REQUIRED, 1, LIST, 3}; };
+    constexpr Node kRepeatedList{"list", -1, REPEATED, 1, -1, 0};
+    const Node schema[] = {
+            {"schema", -1, -1, 14, -1, 0},
+            string("id"), string("title"), string("abstract"),
+            list("authors"), kRepeatedList, {"element", -1, REQUIRED, 3, -1, 0},
+            string("name"), string("affiliation"), string("orcid"),
+            string("doi"), string("pdf_url"), string("source"),
+            list("categories"), kRepeatedList, string("element"),
+            {"published_date", INT64, REQUIRED, 0, TIMESTAMP_MILLIS, 8},
+            {"updated_date", INT64, REQUIRED, 0, TIMESTAMP_MILLIS, 8},
+            string("journal_ref"), string("comment"),
+            {"version", INT32, REQUIRED, 0, -1, 0},
+            list("keywords"), kRepeatedList, string("element"),
+    };
+
+    meta.begin_list(2, T_STRUCT, std::size(schema));
+    for (const auto& node : schema) {
+        meta.begin_element_struct();
+        if (node.type >= 0) meta.i32(1, node.type);
+        if (node.repetition >= 0) meta.i32(3, node.repetition);
+        meta.binary(4, node.name);
+        if (node.type < 0) meta.i32(5, node.children);
+        if (node.converted_type >= 0) meta.i32(6, node.converted_type);
+        if (node.logical_type != 0) {
+            meta.begin_struct(10);
+            meta.begin_struct(node.logical_type);
+            if (node.logical_type == 8) {
+                // TimestampType: UTC-adjusted, milliseconds
+                meta.boolean(1, true);
+                meta.begin_struct(2);
+                meta.begin_struct(1);
+                meta.end_struct();
+                meta.end_struct();
+            }
+            meta.end_struct();
+            meta.end_struct();
+        }
+        meta.end_struct();
+    }
+
+    meta.i64(3, static_cast<int64_t>(total_rows_));
+    meta.begin_list(4, T_STRUCT, row_group_count_);
+    footer.append(row_groups_);
+    meta.binary(6, "crawlPaper ParquetWriter");
+
+    // Type-defined order for every leaf, so readers trust min/max
+    meta.begin_list(7, T_STRUCT, columns_.size());
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        meta.begin_element_struct();
+        meta.begin_struct(1);
+        meta.end_struct();
+        meta.end_struct();
+    }
+    meta.stop();
+
+    put_u32(static_cast<uint32_t>(footer.size()), footer);
+    footer.append(kMagic);
+    file_.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+    file_.close();
+    ok = ok && !file_.fail();
+    return ok;
+}
@@ -0,0 +1,283 @@
+#include "storage/SecondaryIndex.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cerrno>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+
+namespace {
+    constexpr uint32_t kFormatVersion = 1;
+    constexpr int kPositionBits = 40;
+    constexpr uint64_t kPositionMask = (uint64_t{1} << kPositionBits) - 1;
+    constexpr const char* kFilesName = "files.txt";
+    constexpr const char* kStateName = "secondary.json";
+
+    void put_u64(uint64_t value, std::string& out) {
+        for (int i = 0; i < 8; ++i) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    uint64_t load_u64(const unsigned char* p) {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(p[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    bool write_all(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t count = ::write(fd, data, size);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += count;
+            size -= static_cast<size_t>(count);
+        }
+        return true;
+    }
+
+    const char* kind_dir(IndexKind kind) {
+        switch (kind) {
+            case IndexKind::SOURCE: return "source";
+            case IndexKind::CATEGORY: return "category";
+            case IndexKind::MONTH: return "month";
+        }
+        return "";
+    }
+}
+
+void SecondaryIndex::Batch::add(IndexKind kind, std::string_view value, RecordLocation location) {
+    if (location.position > kPositionMask) {
+        return;  // beyond 1 TiB into a file: left to a full scan
+    }
+    put_u64(static_cast<uint64_t>(location.file) << kPositionBits | location.position,
+            lists_[list_path(kind, value)]);
+    size_++;
+}
+
+void SecondaryIndex::Batch::clear() {
+    lists_.clear();
+    size_ = 0;
+}
+
+SecondaryIndex::~SecondaryIndex() {
+    close();
+}
+
+std::string SecondaryIndex::month_of(std::chrono::system_clock::time_point time) {
+    auto time_t = std::chrono::system_clock::to_time_t(time);
+    std::tm tm{};
+    gmtime_r(&time_t, &tm);
+    char buffer[16];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m", &tm);
+    return buffer;
+}
+
+std::string SecondaryIndex::list_path(IndexKind kind, std::string_view value) {
+    static constexpr char kHex[] = "0123456789ABCDEF";
+    std::string path = kind_dir(kind);
+    path.push_back('/');
+    // "%" alone cannot come out of the escaping below
+    if (value.empty()) {
+        path.push_back('%');
+    }
+    for (char c : value) {
+        auto byte = static_cast<unsigned char>(c);
+        if (std::isalnum(byte) || c == '_' || c == '-' || (c == '.' && path.back() != '/')) {
+            path.push_back(c);
+        } else {
+            path.push_back('%');
+            path.push_back(kHex[byte >> 4]);
+            path.push_back(kHex[byte & 15]);
+        }
+    }
+    path += ".post";
+    return path;
+}
+
+bool SecondaryIndex::open(const std::string& dir, bool read_only) {
+    if (open_ && !close()) {
+        return false;
+    }
+    dir_ = dir;
+    read_only_ = read_only;
+    files_.clear();
+
+    std::error_code error;
+    if (!read_only_) {
+        std::filesystem::create_directories(dir_, error);
+        if (error) {
+            std::cerr << "Failed to create " << dir_ << ": " << error.message() << std::endl;
+            return false;
+        }
+    }
+
+    needs_rebuild_ = true;
+    std::ifstream state(std::filesystem::path(dir_) / kStateName);
+    if (state.is_open()) {
+        try {
+            auto json = nlohmann::json::parse(state);
+            needs_rebuild_ = json.value("version", 0u) != kFormatVersion || !json.value("clean", false);
+        } catch (const std::exception& e) {
+            std::cerr << "Ignoring unreadable " << kStateName << " in " << dir_ << ": " << e.what() << std::endl;
+        }
+    }
+
+    std::ifstream files(std::filesystem::path(dir_) / kFilesName);
+    std::string name;
+    while (std::getline(files, name)) {
+        files_.emplace(name, static_cast<uint32_t>(files_.size()));
+    }
+
+    // Until close(), a crash leaves the index marked unclean
+    if (!read_only_ && !write_state(false)) {
+        return false;
+    }
+    open_ = true;
+    return true;
+}
+
+bool SecondaryIndex::close() {
+    if (!open_) {
+        return true;
+    }
+    open_ = false;
+    return read_only_ || write_state(true);
+}
+
+bool SecondaryIndex::clear() {
+    if (read_only_) {
+        return false;
+    }
+    std::lock_guard lock(mutex_);
+    std::error_code error;
+    for (auto kind : {IndexKind::SOURCE, IndexKind::CATEGORY, IndexKind::MONTH}) {
+        std::filesystem::remove_all(std::filesystem::path(dir_) / kind_dir(kind), error);
+    }
+    std::filesystem::remove(std::filesystem::path(dir_) / kFilesName, error);
+    files_.clear();
+    needs_rebuild_ = false;
+    return true;
+}
+
+uint32_t SecondaryIndex::file_id(const std::string& name) {
+    std::lock_guard lock(mutex_);
+    auto [it, added] = files_.emplace(name, static_cast<uint32_t>(files_.size()));
+    if (added && !read_only_) {
+        std::ofstream files(std::filesystem::path(dir_) / kFilesName, std::ios::app);
+        files << name << '\n';
+        if (!files.good()) {
+            std::cerr << "Failed to record " << name << " in " << dir_ << std::endl;
+        }
+    }
+    return it->second;
+}
+
+std::optional<uint32_t> SecondaryIndex::find_file(const std::string& name) const {
+    std::lock_guard lock(mutex_);
+    auto it = files_.find(name);
+    if (it == files_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool SecondaryIndex::write(Batch& batch) {
+    if (read_only_) {
+        return false;
+    }
+    std::lock_guard lock(mutex_);
+    bool ok = true;
+    for (const auto& [list, postings] : batch.lists_) {
+        auto path = std::filesystem::path(dir_) / list;
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0 && errno == ENOENT) {
+            std::error_code error;
+            std::filesystem::create_directories(path.parent_path(), error);
+            fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        }
+        if (fd < 0 || !write_all(fd, postings.data(), postings.size())) {
+            std::cerr << "Failed to write " << path << ": " << std::strerror(errno) << std::endl;
+            ok = false;
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    batch.clear();
+    return ok;
+}
+
+void SecondaryIndex::read_list(const std::string& path, std::vector<RecordLocation>& out) const {
+    std::ifstream file(std::filesystem::path(dir_) / path, std::ios::binary);
+    if (!file.is_open()) {
+        return;
+    }
+    std::string data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    // A torn last posting (crash mid-append) is ignored
+    auto bytes = reinterpret_cast<const unsigned char*>(data.data());
+    for (size_t i = 0; i + 8 <= data.size(); i += 8) {
+        uint64_t value = load_u64(bytes + i);
+        out.push_back({static_cast<uint32_t>(value >> kPositionBits), value & kPositionMask});
+    }
+}
+
+std::vector<RecordLocation> SecondaryIndex::lookup(IndexKind kind, std::string_view value) const {
+    std::vector<RecordLocation> locations;
+    read_list(list_path(kind, value), locations);
+    // Shards interleave their appends
+    std::sort(locations.begin(), locations.end());
+    return locations;
+}
+
+std::vector<RecordLocation> SecondaryIndex::lookup_published(std::chrono::system_clock::time_point from,
+                                                             std::chrono::system_clock::time_point to) const {
+    std::vector<RecordLocation> locations;
+    if (from > to) {
+        return locations;
+    }
+    auto month = month_of(from);
+    auto last = month_of(to);
+    // "YYYY-MM" strings order like the months they name
+    while (month <= last) {
+        read_list(list_path(IndexKind::MONTH, month), locations);
+        int year = std::stoi(month.substr(0, 4));
+        int next = std::stoi(month.substr(5, 2)) + 1;
+        if (next > 12) {
+            next = 1;
+            ++year;
+        }
+        char buffer[32];  // room for any int year, which silences -Wformat-truncation
+        std::snprintf(buffer, sizeof(buffer), "%04d-%02d", year, next);
+        month = buffer;
+    }
+    std::sort(locations.begin(), locations.end());
+    return locations;
+}
+
+bool SecondaryIndex::write_state(bool clean) const {
+    auto path = std::filesystem::path(dir_) / kStateName;
+    auto temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        file << nlohmann::json{{"version", kFormatVersion}, {"clean", clean}}.dump() << std::endl;
+        if (!file.good()) {
+            std::cerr << "Failed to write " << temp_path << std::endl;
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    return !error;
+}
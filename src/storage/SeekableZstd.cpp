@@ -0,0 +1,274 @@
+#include "storage/SeekableZstd.h"
+#include <iostream>
+#include <cstring>
+#include <ctime>
+#if defined(CRAWLER_USE_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace {
+    uint32_t load_u32(const unsigned char* p) {
+        return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+               static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+    }
+
+    void put_u32(uint32_t value, std::string& out) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+#if defined(CRAWLER_USE_ZSTD)
+    // Compression runs on the calling thread, so its CPU clock measures it
+    int64_t thread_cpu_ns() {
+        timespec now{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return static_cast<int64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+    }
+#endif
+}
+
+namespace seekable_zstd {
+
+    bool available() {
+#if defined(CRAWLER_USE_ZSTD)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool is_compressed(const void* data, size_t size) {
+        return size >= 4 && load_u32(static_cast<const unsigned char*>(data)) == kFrameMagic;
+    }
+}
+
+SeekableZstdWriter::SeekableZstdWriter(seekable_zstd::Options options) : options_(options) {
+#if defined(CRAWLER_USE_ZSTD)
+    auto* context = ZSTD_createCCtx();
+    ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, options_.level);
+    // Frame checksums: corruption is detected on decompression
+    ZSTD_CCtx_setParameter(context, ZSTD_c_checksumFlag, 1);
+    context_ = context;
+#endif
+}
+
+SeekableZstdWriter::~SeekableZstdWriter() {
+#if defined(CRAWLER_USE_ZSTD)
+    ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(context_));
+#endif
+}
+
+void SeekableZstdWriter::reset() {
+    pending_.clear();
+    frames_.clear();
+    compressed_size_ = 0;
+}
+
+void SeekableZstdWriter::resume(std::vector<seekable_zstd::FrameEntry> frames) {
+    reset();
+    frames_ = std::move(frames);
+    for (const auto& frame : frames_) {
+        compressed_size_ += frame.compressed_size;
+    }
+}
+
+bool SeekableZstdWriter::end_frame(std::string& out) {
+    if (pending_.empty()) {
+        return true;
+    }
+#if defined(CRAWLER_USE_ZSTD)
+    int64_t cpu_start = thread_cpu_ns();
+    size_t start = out.size();
+    out.resize(start + ZSTD_compressBound(pending_.size()));
+    size_t size = ZSTD_compress2(static_cast<ZSTD_CCtx*>(context_), out.data() + start,
+                                 out.size() - start, pending_.data(), pending_.size());
+    if (ZSTD_isError(size)) {
+        std::cerr << "zstd compression failed: " << ZSTD_getErrorName(size) << std::endl;
+        out.resize(start);
+        return false;
+    }
+    out.resize(start + size);
+
+    frames_.push_back({static_cast<uint32_t>(size), static_cast<uint32_t>(pending_.size())});
+    compressed_size_ += size;
+    if (options_.stats) {
+        options_.stats->input_bytes += pending_.size();
+        options_.stats->output_bytes += size;
+        options_.stats->cpu_ns += thread_cpu_ns() - cpu_start;
+    }
+    pending_.clear();
+    return true;
+#else
+    (void)out;
+    return false;
+#endif
+}
+
+bool SeekableZstdWriter::finish(std::string& out) {
+    if (!end_frame(out)) {
+        return false;
+    }
+
+    // Skippable frame: magic, size, one entry per frame, then the footer
+    // (frame count, descriptor without checksums, seekable magic)
+    size_t start = out.size();
+    put_u32(seekable_zstd::kSkippableMagic, out);
+    put_u32(static_cast<uint32_t>(frames_.size() * 8 + seekable_zstd::kSeekTableFooterSize), out);
+    for (const auto& frame : frames_) {
+        put_u32(frame.compressed_size, out);
+        put_u32(frame.decompressed_size, out);
+    }
+    put_u32(static_cast<uint32_t>(frames_.size()), out);
+    out.push_back(0);
+    put_u32(seekable_zstd::kSeekTableMagic, out);
+
+    if (options_.stats) {
+        options_.stats->output_bytes += out.size() - start;
+    }
+    return true;
+}
+
+SeekableZstdReader::~SeekableZstdReader() = default;
+
+bool SeekableZstdReader::open(const void* data, size_t size) {
+    data_ = static_cast<const unsigned char*>(data);
+    frames_.reset();
+    frame_count_ = 0;
+    has_seek_table_ = false;
+    if (!seekable_zstd::available()) {
+        std::cerr << "Built without zstd (CRAWLER_USE_ZSTD), cannot read compressed storage" << std::endl;
+        return false;
+    }
+
+    std::vector<seekable_zstd::FrameEntry> entries;
+
+    // Seek table at the very end
+    using namespace seekable_zstd;
+    if (size >= 8 + kSeekTableFooterSize &&
+        load_u32(data_ + size - 4) == kSeekTableMagic &&
+        (data_[size - 5] & 0x80) == 0) {
+        uint64_t count = load_u32(data_ + size - kSeekTableFooterSize);
+        uint64_t table_size = 8 + count * 8 + kSeekTableFooterSize;
+        if (table_size <= size) {
+            const unsigned char* table = data_ + size - table_size;
+            if (load_u32(table) == kSkippableMagic && load_u32(table + 4) == table_size - 8) {
+                uint64_t compressed_total = 0;
+                for (uint64_t i = 0; i < count; ++i) {
+                    seekable_zstd::FrameEntry entry{load_u32(table + 8 + i * 8), load_u32(table + 12 + i * 8)};
+                    compressed_total += entry.compressed_size;
+                    entries.push_back(entry);
+                }
+                has_seek_table_ = compressed_total == size - table_size;
+            }
+        }
+    }
+
+    // No usable seek table: walk the frame headers
+    if (!has_seek_table_) {
+        entries.clear();
+#if defined(CRAWLER_USE_ZSTD)
+        uint64_t offset = 0;
+        while (offset < size && load_u32(data_ + offset) == kFrameMagic) {
+            size_t compressed = ZSTD_findFrameCompressedSize(data_ + offset, size - offset);
+            if (ZSTD_isError(compressed)) {
+                break;  // torn frame
+            }
+            auto decompressed = ZSTD_getFrameContentSize(data_ + offset, compressed);
+            if (decompressed == ZSTD_CONTENTSIZE_UNKNOWN || decompressed == ZSTD_CONTENTSIZE_ERROR) {
+                break;
+            }
+            entries.push_back({static_cast<uint32_t>(compressed), static_cast<uint32_t>(decompressed)});
+            offset += compressed;
+        }
+#endif
+    }
+
+    frames_ = std::make_unique<Frame[]>(entries.size());
+    frame_count_ = entries.size();
+    uint64_t compressed_offset = 0;
+    uint64_t decompressed_offset = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        frames_[i].entry = entries[i];
+        frames_[i].compressed_offset = compressed_offset;
+        frames_[i].decompressed_offset = decompressed_offset;
+        compressed_offset += entries[i].compressed_size;
+        decompressed_offset += entries[i].decompressed_size;
+    }
+    return true;
+}
+
+uint64_t SeekableZstdReader::size() const {
+    return frame_count_ ? frame_end(frame_count_ - 1) : 0;
+}
+
+uint64_t SeekableZstdReader::frames_end() const {
+    if (frame_count_ == 0) {
+        return 0;
+    }
+    const auto& last = frames_[frame_count_ - 1];
+    return last.compressed_offset + last.entry.compressed_size;
+}
+
+size_t SeekableZstdReader::frame_at(uint64_t offset) const {
+    // Binary search over the decompressed start offsets
+    size_t low = 0;
+    size_t high = frame_count_;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (frame_end(middle) <= offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+std::vector<seekable_zstd::FrameEntry> SeekableZstdReader::entries(size_t count) const {
+    std::vector<seekable_zstd::FrameEntry> result;
+    for (size_t i = 0; i < count && i < frame_count_; ++i) {
+        result.push_back(frames_[i].entry);
+    }
+    return result;
+}
+
+std::string_view SeekableZstdReader::frame(size_t index) const {
+    if (index >= frame_count_) {
+        return {};
+    }
+    const Frame& frame = frames_[index];
+    std::call_once(frame.decompressed, [&] {
+#if defined(CRAWLER_USE_ZSTD)
+        frame.data = std::make_unique<char[]>(frame.entry.decompressed_size);
+        size_t size = ZSTD_decompress(frame.data.get(), frame.entry.decompressed_size,
+                                      data_ + frame.compressed_offset, frame.entry.compressed_size);
+        frame.valid = !ZSTD_isError(size) && size == frame.entry.decompressed_size;
+        if (!frame.valid) {
+            std::cerr << "Corrupt zstd frame " << index << std::endl;
+            frame.data.reset();
+        }
+#endif
+    });
+    return frame.valid ? std::string_view(frame.data.get(), frame.entry.decompressed_size) : std::string_view{};
+}
+
+bool SeekableZstdReader::read_frame(size_t index, std::string& out) const {
+    out.clear();
+    if (index >= frame_count_) {
+        return false;
+    }
+#if defined(CRAWLER_USE_ZSTD)
+    const Frame& frame = frames_[index];
+    out.resize(frame.entry.decompressed_size);
+    size_t size = ZSTD_decompress(out.data(), out.size(), data_ + frame.compressed_offset, frame.entry.compressed_size);
+    if (ZSTD_isError(size) || size != out.size()) {
+        std::cerr << "Corrupt zstd frame " << index << std::endl;
+        out.clear();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
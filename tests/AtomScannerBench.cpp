@@ -0,0 +1,136 @@
+// arXiv Atom parsing: the streaming AtomScanner against the pugixml DOM +
+// XPath parser it replaced, on a generated feed of realistic entries.
+// The pugixml baseline is built when third_party/pugixml is present
+// (CRAWLER_BENCH_PUGIXML).
+#include <benchmark/benchmark.h>
+#include <string>
+#include "parser/ArxivParser.h"
+#include "parser/AtomScanner.h"
+#include "parser/TextScanners.h"
+#include "IsoDate.h"
+#include "TestPapers.h"
+
+#ifdef CRAWLER_BENCH_PUGIXML
+#include <pugixml.hpp>
+#endif
+
+namespace {
+
+    void finish(benchmark::State& state, const std::string& text) {
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+    }
+
+#ifdef CRAWLER_BENCH_PUGIXML
+    // The pre-scanner parser: DOM, then XPath per entry (as ArxivParser did
+    // before the Atom scanner, with categories from <category term>)
+    Paper parse_pugixml_entry(const pugi::xml_node& entry) {
+        static const Symbol kSource = Symbol::intern("arxiv");
+
+        Paper paper;
+        paper.source = kSource;
+        paper.id = text_scan::arxiv_id(entry.child("id").text().as_string());
+        paper.title = entry.child("title").text().as_string();
+        paper.abstract = entry.child("summary").text().as_string();
+
+        pugi::xpath_node_set authors = entry.select_nodes("author");
+        for (pugi::xpath_node author_node : authors) {
+            paper.authors.emplace_back(author_node.node().child("name").text().as_string(),
+                                       author_node.node().child("arxiv:affiliation").text().as_string(), "");
+        }
+
+        pugi::xpath_node_set links = entry.select_nodes("link[@title='doi']");
+        for (pugi::xpath_node link : links) {
+            paper.doi = text_scan::find_doi(link.node().attribute("href").as_string());
+            if (!paper.doi.empty()) break;
+        }
+
+        for (pugi::xml_node category : entry.children("category")) {
+            paper.categories.push_back(Symbol::intern(category.attribute("term").as_string()));
+        }
+
+        paper.published_date = iso_date::parse(entry.child("published").text().as_string());
+        paper.updated_date = iso_date::parse(entry.child("updated").text().as_string());
+        paper.journal_ref = entry.child("arxiv:journal_ref").text().as_string();
+        paper.comment = entry.child("arxiv:comment").text().as_string();
+        paper.pdf_url = "https://arxiv.org/pdf/" + std::string(paper.id) + ".pdf";
+        return paper;
+    }
+#endif
+}
+
+// Scanning alone: fields extracted into a reused AtomEntry
+static void BM_AtomScannerEntries(benchmark::State& state) {
+    const auto& text = test_papers::arxiv_feed(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        AtomScanner scanner(text);
+        AtomEntry entry;
+        size_t entries = 0;
+        while (scanner.next(entry)) {
+            ++entries;
+        }
+        benchmark::DoNotOptimize(entries);
+    }
+    finish(state, text);
+}
+BENCHMARK(BM_AtomScannerEntries)->Arg(100)->Arg(2000);
+
+// Scanning into views, decoded text only in the arena
+static void BM_AtomScannerViews(benchmark::State& state) {
+    const auto& text = test_papers::arxiv_feed(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        AtomScanner scanner(text);
+        AtomEntryView entry;
+        TextArena arena;
+        size_t entries = 0;
+        while (scanner.next(entry, arena)) {
+            ++entries;
+        }
+        benchmark::DoNotOptimize(entries);
+    }
+    finish(state, text);
+}
+BENCHMARK(BM_AtomScannerViews)->Arg(100)->Arg(2000);
+
+// The full parser: scan and build Papers
+static void BM_ArxivParserPapers(benchmark::State& state) {
+    const auto& text = test_papers::arxiv_feed(static_cast<size_t>(state.range(0)));
+    ArxivParser parser;
+    for (auto _ : state) {
+        auto papers = parser.parse_papers(text);
+        benchmark::DoNotOptimize(papers.data());
+    }
+    finish(state, text);
+}
+BENCHMARK(BM_ArxivParserPapers)->Arg(100)->Arg(2000);
+
+#ifdef CRAWLER_BENCH_PUGIXML
+static void BM_PugixmlDomXPathPapers(benchmark::State& state) {
+    const auto& text = test_papers::arxiv_feed(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<Paper> papers;
+        pugi::xml_document doc;
+        if (doc.load_string(text.c_str())) {
+            pugi::xpath_node_set entries = doc.select_nodes("//entry");
+            for (pugi::xpath_node node : entries) {
+                papers.push_back(parse_pugixml_entry(node.node()));
+            }
+        }
+        benchmark::DoNotOptimize(papers.data());
+    }
+    finish(state, text);
+}
+BENCHMARK(BM_PugixmlDomXPathPapers)->Arg(100)->Arg(2000);
+
+// DOM construction alone, the part no XPath tuning could remove
+static void BM_PugixmlLoadOnly(benchmark::State& state) {
+    const auto& text = test_papers::arxiv_feed(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        pugi::xml_document doc;
+        auto result = doc.load_string(text.c_str());
+        benchmark::DoNotOptimize(result);
+    }
+    finish(state, text);
+}
+BENCHMARK(BM_PugixmlLoadOnly)->Arg(100)->Arg(2000);
+#endif
@@ -0,0 +1,112 @@
+// Load throughput of "bin" segments against jsonl, reported as bytes/s of
+// file read. Run with --benchmark_min_time=2 for stable numbers; the files
+// are in the page cache, so this measures decoding, not the disk.
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include "storage/BinarySegment.h"
+#include "storage/PaperJson.h"
+#include "storage/PaperRecord.h"
+#include "TestPapers.h"
+
+namespace {
+    constexpr size_t kPapers = 20000;
+
+    struct Corpus {
+        test_papers::TempDir dir;
+        std::string bin_path = dir.file("papers.bin");
+        std::string jsonl_path = dir.file("papers.jsonl");
+        size_t bin_bytes = 0;
+        size_t jsonl_bytes = 0;
+
+        Corpus() {
+            BinarySegmentWriter writer;
+            writer.open(bin_path);
+            std::ofstream jsonl(jsonl_path, std::ios::binary);
+            std::string record;
+            for (size_t i = 0; i < kPapers; ++i) {
+                Paper paper = test_papers::make_paper(i);
+                record.clear();
+                paper_record::encode(paper, record);
+                writer.append(record);
+
+                record.clear();
+                paper_json::write(paper, record);
+                record.push_back('\n');
+                jsonl << record;
+            }
+            writer.close();
+            jsonl.close();
+            bin_bytes = std::filesystem::file_size(bin_path);
+            jsonl_bytes = std::filesystem::file_size(jsonl_path);
+        }
+    };
+
+    const Corpus& corpus() {
+        static Corpus instance;
+        return instance;
+    }
+}
+
+static void BM_JsonlLoadPapers(benchmark::State& state) {
+    const auto& data = corpus();
+    for (auto _ : state) {
+        std::ifstream file(data.jsonl_path, std::ios::binary);
+        std::vector<Paper> papers;
+        std::string line;
+        while (std::getline(file, line)) {
+            papers.push_back(Paper::from_json(nlohmann::json::parse(line)));
+        }
+        benchmark::DoNotOptimize(papers.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.jsonl_bytes));
+}
+BENCHMARK(BM_JsonlLoadPapers)->Unit(benchmark::kMillisecond);
+
+static void BM_BinReadAll(benchmark::State& state) {
+    const auto& data = corpus();
+    for (auto _ : state) {
+        BinarySegmentReader reader;
+        reader.open(data.bin_path);
+        auto papers = reader.read_all();
+        benchmark::DoNotOptimize(papers.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.bin_bytes));
+}
+BENCHMARK(BM_BinReadAll)->Unit(benchmark::kMillisecond);
+
+static void BM_BinPaperViewScan(benchmark::State& state) {
+    const auto& data = corpus();
+    for (auto _ : state) {
+        BinarySegmentReader reader;
+        reader.open(data.bin_path);
+        reader.advise_sequential();
+        size_t title_bytes = 0;
+        PaperView view;
+        for (size_t i = 0; i < reader.size(); ++i) {
+            if (reader.read(i, view)) {
+                title_bytes += view.title.size();
+            }
+        }
+        benchmark::DoNotOptimize(title_bytes);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.bin_bytes));
+}
+BENCHMARK(BM_BinPaperViewScan)->Unit(benchmark::kMillisecond);
+
+// Checksums alone: the floor under every bin read
+static void BM_BinRecordCrc(benchmark::State& state) {
+    const auto& data = corpus();
+    BinarySegmentReader reader;
+    reader.open(data.bin_path);
+    for (auto _ : state) {
+        size_t payload_bytes = 0;
+        for (size_t i = 0; i < reader.size(); ++i) {
+            if (auto payload = reader.record(i)) {
+                payload_bytes += payload->size();
+            }
+        }
+        benchmark::DoNotOptimize(payload_bytes);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.bin_bytes));
+}
+BENCHMARK(BM_BinRecordCrc)->Unit(benchmark::kMillisecond);
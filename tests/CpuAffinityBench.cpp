@@ -0,0 +1,126 @@
+// The parse -> storage pipeline with and without CPU/NUMA pinning. Parse
+// threads turn arXiv responses into Papers and hand them to one storage
+// thread that encodes them as bin records, as ThreadScheduler and the
+// storage writer do. Only the placement differs between the two runs.
+//
+// CRAWLER_BENCH_PARSE_CPUS and CRAWLER_BENCH_STORAGE_CPUS take the same
+// specs as [crawler] affinity ("0-7", "node:1"). By default the machine's
+// CPUs are split in half; on a multi-socket host use one node per stage to
+// see the cross-node cost that pinning avoids.
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "parser/ArxivParser.h"
+#include "scheduler/CpuAffinity.h"
+#include "storage/PaperRecord.h"
+#include "TestPapers.h"
+
+namespace {
+    constexpr size_t kResponsesPerThread = 40;
+    constexpr size_t kEntriesPerResponse = 200;
+
+    CpuPlacement placement_from_env(const char* name, bool upper_half) {
+        if (const char* spec = std::getenv(name)) {
+            if (auto placement = CpuPlacement::parse(spec)) {
+                return *placement;
+            }
+        }
+        int cpus = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        int half = std::max(1, cpus / 2);
+        CpuPlacement placement;
+        int first = upper_half && cpus > 1 ? half : 0;
+        int last = upper_half || cpus == 1 ? cpus - 1 : half - 1;
+        for (int cpu = first; cpu <= last; ++cpu) {
+            placement.cpus.push_back(cpu);
+        }
+        return placement;
+    }
+
+    struct Handoff {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<std::pmr::vector<Paper>> batches;
+        size_t producers = 0;
+    };
+
+    // Papers encoded by the storage thread
+    size_t run_pipeline(bool pinned) {
+        static const CpuPlacement parse_cpus = placement_from_env("CRAWLER_BENCH_PARSE_CPUS", false);
+        static const CpuPlacement storage_cpus = placement_from_env("CRAWLER_BENCH_STORAGE_CPUS", true);
+        const auto& response = test_papers::arxiv_feed(kEntriesPerResponse);
+
+        Handoff handoff;
+        handoff.producers = parse_cpus.cpus.size();
+        size_t encoded = 0;
+
+        std::thread storage([&] {
+            if (pinned) {
+                CpuAffinity::pin_current_thread(storage_cpus);
+            }
+            std::string record;
+            while (true) {
+                std::unique_lock lock(handoff.mutex);
+                handoff.ready.wait(lock, [&] { return !handoff.batches.empty() || handoff.producers == 0; });
+                if (handoff.batches.empty()) {
+                    return;
+                }
+                auto papers = std::move(handoff.batches.front());
+                handoff.batches.pop_front();
+                lock.unlock();
+
+                for (const auto& paper : papers) {
+                    record.clear();
+                    paper_record::encode(paper, record);
+                    ++encoded;
+                }
+                benchmark::DoNotOptimize(record.data());
+            }
+        });
+
+        std::vector<std::thread> parsers;
+        for (size_t i = 0; i < parse_cpus.cpus.size(); ++i) {
+            parsers.emplace_back([&] {
+                if (pinned) {
+                    CpuAffinity::pin_current_thread(parse_cpus);
+                }
+                ArxivParser parser;
+                for (size_t n = 0; n < kResponsesPerThread; ++n) {
+                    auto papers = parser.parse_papers(response);
+                    std::lock_guard lock(handoff.mutex);
+                    handoff.batches.push_back(std::move(papers));
+                    handoff.ready.notify_one();
+                }
+                std::lock_guard lock(handoff.mutex);
+                --handoff.producers;
+                handoff.ready.notify_one();
+            });
+        }
+
+        for (auto& parser : parsers) {
+            parser.join();
+        }
+        storage.join();
+        return encoded;
+    }
+}
+
+static void BM_ParseStoragePipeline(benchmark::State& state) {
+    bool pinned = state.range(0) != 0;
+    size_t papers = 0;
+    for (auto _ : state) {
+        papers += run_pipeline(pinned);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(papers));
+    state.SetLabel(pinned ? "pinned" : "unpinned");
+}
+BENCHMARK(BM_ParseStoragePipeline)
+        ->ArgName("pinned")
+        ->Arg(0)
+        ->Arg(1)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
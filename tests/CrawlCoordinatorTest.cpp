@@ -0,0 +1,224 @@
+// CrawlCoordinator lease accounting, the serve loop's handling of nodes that
+// stop reading their replies, and real CrawlNodes on localhost with a stub
+// fetch in place of HTTP
+#include <gtest/gtest.h>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "coordinator/CrawlCoordinator.h"
+#include "coordinator/CrawlNode.h"
+#include "TestPapers.h"
+
+using namespace coordinator_protocol;
+
+namespace {
+
+    // A node connection with a receive timeout, so a stalled serve loop
+    // fails the test instead of hanging it
+    class TestNode {
+    public:
+        explicit TestNode(uint16_t port) : fd_(connect_to("127.0.0.1", port)), reader_(fd_) {
+            timeval timeout{5, 0};
+            setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        }
+        ~TestNode() {
+            if (fd_ >= 0) {
+                ::close(fd_);
+            }
+        }
+
+        TestNode(const TestNode&) = delete;
+        TestNode& operator=(const TestNode&) = delete;
+
+        int fd() const { return fd_; }
+
+        std::string request(const std::string& line) {
+            std::string reply;
+            if (!send_line(fd_, line) || !reader_.read_line(reply)) {
+                return "";
+            }
+            return reply;
+        }
+
+        uint64_t claim() {
+            auto reply = request("CLAIM test");
+            if (reply.rfind("LEASE ", 0) != 0) {
+                return 0;
+            }
+            return std::stoull(reply.substr(6));
+        }
+
+    private:
+        int fd_;
+        LineReader reader_;
+    };
+
+    constexpr size_t kPapersPerItem = 3;
+
+    std::unique_ptr<CrawlCoordinator> start_coordinator(size_t items, size_t max_attempts,
+                                                        std::chrono::milliseconds lease_ttl = std::chrono::seconds(60)) {
+        auto coordinator = std::make_unique<CrawlCoordinator>(0, lease_ttl, max_attempts);
+        for (size_t i = 0; i < items; ++i) {
+            WorkItem item;
+            item.source = "arxiv";
+            item.categories = {"hep-th"};
+            item.start_index = i * kPapersPerItem;
+            coordinator->add_item(item);
+        }
+        EXPECT_TRUE(coordinator->start());
+        return coordinator;
+    }
+
+    // An arXiv response with the item's papers, as the API would page them
+    std::optional<std::string> stub_fetch(const WorkItem& item, std::stop_token) {
+        std::string feed = "<feed xmlns=\"http://www.w3.org/2005/Atom\">\n";
+        for (size_t i = item.start_index; i < item.start_index + kPapersPerItem; ++i) {
+            feed += test_papers::arxiv_entry(i);
+        }
+        return feed + "</feed>\n";
+    }
+
+    // Papers delivered by all nodes, by id
+    struct Deliveries {
+        std::mutex mutex;
+        std::map<std::string, size_t> counts;
+
+        void attach(CrawlNode& node) {
+            node.set_paper_callback([this](const Paper& paper) {
+                std::lock_guard lock(mutex);
+                counts[std::string(paper.id)]++;
+            });
+        }
+    };
+}
+
+TEST(CrawlCoordinatorTest, FailCountsAnAttempt) {
+    auto coordinator = start_coordinator(1, 1);
+    TestNode node(coordinator->port());
+
+    uint64_t lease = node.claim();
+    ASSERT_NE(lease, 0u);
+    EXPECT_EQ(node.request("FAIL " + std::to_string(lease) + " fetch error"), "OK");
+
+    auto stats = coordinator->get_stats();
+    EXPECT_EQ(stats.failed, 1u);
+    EXPECT_EQ(stats.pending, 0u);
+    EXPECT_EQ(node.request("CLAIM test"), "DONE");
+}
+
+TEST(CrawlCoordinatorTest, ReleaseReturnsTheItemWithoutAnAttempt) {
+    auto coordinator = start_coordinator(1, 1);
+    TestNode node(coordinator->port());
+
+    for (int round = 0; round < 3; ++round) {
+        uint64_t lease = node.claim();
+        ASSERT_NE(lease, 0u) << "round " << round;
+        EXPECT_EQ(node.request("RELEASE " + std::to_string(lease)), "OK");
+
+        auto stats = coordinator->get_stats();
+        EXPECT_EQ(stats.failed, 0u);
+        EXPECT_EQ(stats.pending, 1u);
+        EXPECT_EQ(stats.leased, 0u);
+    }
+
+    uint64_t lease = node.claim();
+    ASSERT_NE(lease, 0u);
+    EXPECT_EQ(node.request("RELEASE " + std::to_string(lease)), "OK");
+    EXPECT_EQ(node.request("RELEASE " + std::to_string(lease)), "LOST");
+}
+
+TEST(CrawlCoordinatorTest, StalledNodeDoesNotBlockOthers) {
+    auto coordinator = start_coordinator(1, 3);
+
+    // Pipelines requests without ever reading the replies, until both its
+    // receive buffer and the coordinator's send buffer are full
+    TestNode stalled(coordinator->port());
+    int buffer = 4096;
+    setsockopt(stalled.fd(), SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+    fcntl(stalled.fd(), F_SETFL, fcntl(stalled.fd(), F_GETFL) | O_NONBLOCK);
+    std::string requests;
+    for (int i = 0; i < 4096; ++i) {
+        requests += "HEARTBEAT 999999\n";
+    }
+    size_t sent = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (sent < (64u << 20) && std::chrono::steady_clock::now() < deadline) {
+        ssize_t n = ::send(stalled.fd(), requests.data(), requests.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<size_t>(n);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    TestNode node(coordinator->port());
+    uint64_t lease = node.claim();
+    ASSERT_NE(lease, 0u);
+    EXPECT_EQ(node.request("COMPLETE " + std::to_string(lease) + " 10"), "OK");
+    EXPECT_EQ(coordinator->get_stats().completed, 1u);
+}
+
+TEST(CrawlCoordinatorTest, NodesCompleteEveryItemOnce) {
+    constexpr size_t kItems = 40;
+    // Idle workers are told to wait a quarter of the TTL before claiming again
+    auto coordinator = start_coordinator(kItems, 3, std::chrono::seconds(1));
+
+    Deliveries deliveries;
+    std::vector<std::unique_ptr<CrawlNode>> nodes;
+    for (int n = 0; n < 3; ++n) {
+        nodes.push_back(std::make_unique<CrawlNode>("127.0.0.1", coordinator->port(),
+                                                    "node" + std::to_string(n), 2, stub_fetch));
+        deliveries.attach(*nodes.back());
+    }
+    std::vector<std::thread> threads;
+    for (auto& node : nodes) {
+        threads.emplace_back([&node] { node->run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto stats = coordinator->get_stats();
+    EXPECT_EQ(stats.completed, kItems);
+    EXPECT_EQ(stats.failed, 0u);
+    EXPECT_EQ(stats.papers, kItems * kPapersPerItem);
+
+    size_t completed = 0;
+    for (auto& node : nodes) {
+        completed += node->get_completed_count();
+        EXPECT_EQ(node->get_lost_count(), 0u);
+    }
+    EXPECT_EQ(completed, kItems);
+    ASSERT_EQ(deliveries.counts.size(), kItems * kPapersPerItem);
+    for (const auto& [id, count] : deliveries.counts) {
+        EXPECT_EQ(count, 1u) << id;
+    }
+}
+
+TEST(CrawlCoordinatorTest, SilentNodeLosesItsLeaseToAnotherNode) {
+    auto coordinator = start_coordinator(1, 3, std::chrono::milliseconds(300));
+
+    // Claims the only item and then never heartbeats, like a node that hung
+    TestNode silent(coordinator->port());
+    uint64_t lease = silent.claim();
+    ASSERT_NE(lease, 0u);
+
+    Deliveries deliveries;
+    CrawlNode node("127.0.0.1", coordinator->port(), "live", 1, stub_fetch);
+    deliveries.attach(node);
+    node.run();  // waits until the lease expires, then takes the item
+
+    auto stats = coordinator->get_stats();
+    EXPECT_EQ(stats.reassigned, 1u);
+    EXPECT_EQ(stats.completed, 1u);
+    EXPECT_EQ(node.get_completed_count(), 1u);
+    EXPECT_EQ(deliveries.counts.size(), kPapersPerItem);
+
+    // The late holder's results are refused
+    EXPECT_EQ(silent.request("COMPLETE " + std::to_string(lease) + " 3"), "LOST");
+    EXPECT_EQ(coordinator->get_stats().papers, kPapersPerItem);
+}
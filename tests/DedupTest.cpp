@@ -0,0 +1,75 @@
+// DataStorage drops papers the dedup index already holds, also when the same
+// paper is saved from several threads at once
+#include <gtest/gtest.h>
+#include <barrier>
+#include <thread>
+#include <vector>
+#include "storage/DataStorage.h"
+#include "TestPapers.h"
+
+using test_papers::make_paper;
+using test_papers::TempDir;
+
+namespace {
+    constexpr size_t kThreads = 8;
+    constexpr size_t kPapers = 300;
+
+    struct DedupCase {
+        std::string format;
+        size_t shards;
+        ShardBy shard_by;
+    };
+
+    class ConcurrentDedup : public testing::TestWithParam<DedupCase> {};
+}
+
+TEST_P(ConcurrentDedup, SamePaperFromManyThreadsIsWrittenOnce) {
+    const auto& param = GetParam();
+    TempDir dir;
+    {
+        DataStorage storage;
+        storage.set_sharding(param.shards, param.shard_by);
+        storage.set_dedup(true, 1000);
+        ASSERT_TRUE(storage.initialize(dir.path().string(), param.format));
+
+        std::vector<Paper> papers;
+        for (size_t i = 0; i < kPapers; ++i) {
+            papers.push_back(make_paper(i));
+        }
+        // Every thread saves each paper at the same moment
+        std::barrier start(kThreads);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&] {
+                for (const auto& paper : papers) {
+                    start.arrive_and_wait();
+                    EXPECT_TRUE(storage.save_paper(paper));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ASSERT_TRUE(storage.flush());
+
+        auto stats = storage.get_stats();
+        EXPECT_EQ(stats.duplicates_dropped, (kThreads - 1) * kPapers);
+        EXPECT_EQ(stats.duplicates_written, 0u);
+        EXPECT_EQ(storage.load_papers().size(), kPapers);
+    }
+
+    DataStorage reopened;
+    ASSERT_TRUE(reopened.initialize(dir.path().string(), param.format));
+    EXPECT_EQ(reopened.load_papers().size(), kPapers);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        Sharding, ConcurrentDedup,
+        testing::Values(DedupCase{"jsonl", 1, ShardBy::THREAD},
+                        DedupCase{"bin", 1, ShardBy::THREAD},
+                        DedupCase{"jsonl", 4, ShardBy::PAPER_ID},
+                        DedupCase{"bin", 4, ShardBy::PAPER_ID}),
+        [](const testing::TestParamInfo<DedupCase>& info) {
+            return info.param.format + "_" + std::to_string(info.param.shards) +
+                   (info.param.shard_by == ShardBy::PAPER_ID ? "_id" : "_thread");
+        });
@@ -0,0 +1,181 @@
+// html_text::clean_in_place on fixed cases, and differentially against a
+// byte-at-a-time cleaner that applies the same rules without the SSE2/AVX2
+// scan for the next special byte. Random inputs are longer than 33 bytes so
+// the vector loop runs, with the special bytes at every offset.
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "parser/HtmlText.h"
+
+namespace {
+
+    std::string clean(std::string text) {
+        html_text::clean_in_place(text);
+        return text;
+    }
+
+    bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    bool is_alpha(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    // Tags, comments and "<" as text, as documented on clean_in_place
+    size_t tag_end(const std::string& text, size_t pos) {
+        if (pos + 1 >= text.size()) {
+            return std::string::npos;
+        }
+        if (text.compare(pos, 4, "<!--") == 0) {
+            auto end = text.find("-->", pos + 4);
+            return end == std::string::npos ? std::string::npos : end + 3;
+        }
+        char next = text[pos + 1];
+        if (!is_alpha(next) && next != '/' && next != '!' && next != '?') {
+            return std::string::npos;
+        }
+        auto end = text.find('>', pos + 1);
+        return end == std::string::npos ? std::string::npos : end + 1;
+    }
+
+    // One byte at a time, with no run copying
+    std::string scalar_clean(const std::string& text) {
+        std::string out;
+        auto emit_space = [&] {
+            if (!out.empty() && out.back() != ' ') {
+                out.push_back(' ');
+            }
+        };
+        size_t i = 0;
+        while (i < text.size()) {
+            char c = text[i];
+            if (c == '<') {
+                size_t end = tag_end(text, i);
+                if (end == std::string::npos) {
+                    out.push_back('<');
+                    ++i;
+                } else {
+                    i = end;
+                }
+            } else if (c == '&') {
+                uint32_t codepoint = 0;
+                size_t used = html_text::decode_entity(std::string_view(text).substr(i), codepoint);
+                if (used == 0) {
+                    out.push_back('&');
+                    ++i;
+                } else if (codepoint == 0xA0 || (codepoint < 0x80 && is_space(static_cast<char>(codepoint)))) {
+                    emit_space();
+                    i += used;
+                } else {
+                    char buffer[4];
+                    out.append(buffer, html_text::encode_utf8(codepoint, buffer));
+                    i += used;
+                }
+            } else if (is_space(c)) {
+                while (i < text.size() && is_space(text[i])) ++i;
+                emit_space();
+            } else {
+                out.push_back(c);
+                ++i;
+            }
+        }
+        if (!out.empty() && out.back() == ' ') {
+            out.pop_back();
+        }
+        return out;
+    }
+
+    // An ASCII prefix of random length, so what follows lands at every
+    // offset of a vector block, then random fragments
+    std::string random_input(std::mt19937& rng, const std::vector<std::string>& fragments) {
+        std::uniform_int_distribution<size_t> prefix(0, 64);
+        std::uniform_int_distribution<size_t> length(4, 24);
+        std::uniform_int_distribution<size_t> pick(0, fragments.size() - 1);
+
+        std::string text(prefix(rng), 'p');
+        for (size_t i = length(rng); i > 0; --i) {
+            text += fragments[pick(rng)];
+        }
+        while (text.size() <= 33) {
+            text += fragments[pick(rng)];
+        }
+        return text;
+    }
+
+    constexpr int kFuzzIterations = 20000;
+}
+
+TEST(HtmlText, DecodesNamedAndNumericEntities) {
+    EXPECT_EQ(clean("&amp; &lt; &gt; &quot; &apos;"), "& < > \" '");
+    EXPECT_EQ(clean("&alpha;&Omega;&eacute;&euro;&hellip;"), "\xce\xb1\xce\xa9\xc3\xa9\xe2\x82\xac\xe2\x80\xa6");
+    EXPECT_EQ(clean("&#945;&#x3b2;&#X3B3;&#65;"), "\xce\xb1\xce\xb2\xce\xb3" "A");
+    EXPECT_EQ(clean("&#x1F600;"), "\xf0\x9f\x98\x80");
+}
+
+TEST(HtmlText, InvalidNumericReferencesBecomeReplacementCharacter) {
+    const std::string replacement = "\xef\xbf\xbd";
+    EXPECT_EQ(clean("&#0;"), replacement);
+    EXPECT_EQ(clean("&#x0;"), replacement);
+    EXPECT_EQ(clean("&#xD800;"), replacement);
+    EXPECT_EQ(clean("&#xDFFF;"), replacement);
+    EXPECT_EQ(clean("&#55296;"), replacement);
+    EXPECT_EQ(clean("&#x110000;"), replacement);
+    EXPECT_EQ(clean("a&#xDBFF;b"), "a" + replacement + "b");
+}
+
+TEST(HtmlText, NbspAndWhitespaceCollapse) {
+    EXPECT_EQ(clean("a&nbsp;b"), "a b");
+    EXPECT_EQ(clean("a&nbsp;&nbsp; \t&nbsp;b"), "a b");
+    EXPECT_EQ(clean("&nbsp;a&nbsp;"), "a");
+    EXPECT_EQ(clean("a&#32;&#x20; b"), "a b");
+    EXPECT_EQ(clean("  a \t\n\r b  "), "a b");
+    EXPECT_EQ(clean(" \n&nbsp; "), "");
+}
+
+TEST(HtmlText, StripsTagsAndComments) {
+    EXPECT_EQ(clean("a <b>bold</b> c"), "a bold c");
+    EXPECT_EQ(clean("a<br/>b"), "ab");
+    EXPECT_EQ(clean("a<!-- hidden <b> -->b"), "ab");
+    EXPECT_EQ(clean("a <!-- c --> b"), "a b");
+    EXPECT_EQ(clean("<?xml version=\"1.0\"?><p>x</p>"), "x");
+    EXPECT_EQ(clean("a <!-- never closed"), "a <!-- never closed");
+}
+
+TEST(HtmlText, KeepsTextThatIsNotMarkup) {
+    EXPECT_EQ(clean("x < y"), "x < y");
+    EXPECT_EQ(clean("x<3 and y>2"), "x<3 and y>2");
+    EXPECT_EQ(clean("a <"), "a <");
+    EXPECT_EQ(clean("&foo; stays"), "&foo; stays");
+    EXPECT_EQ(clean("AT&T & co"), "AT&T & co");
+    EXPECT_EQ(clean("&#xZZ; &#; &;"), "&#xZZ; &#; &;");
+    EXPECT_EQ(clean("a\x01" "b"), "a\x01" "b");
+}
+
+TEST(HtmlText, MatchesScalarCleanerOnRandomInput) {
+    const std::vector<std::string> fragments = {
+            "<", ">", "&", ";", "#", " ", "  ", "\t", "\n", "\r\n", "\x01", "a", "xyz", "\xc3\xa9",
+            "&amp;", "&lt;", "&nbsp;", "&#x3b1;", "&#946;", "&#0;", "&#xD800;", "&foo;", "&#x20;",
+            "<b>", "</i>", "<br/>", "<!--", "-->", "<!-- c -->", "x < y", "<?", "</"};
+    std::mt19937 rng(20260211);
+    for (int i = 0; i < kFuzzIterations; ++i) {
+        auto text = random_input(rng, fragments);
+        EXPECT_EQ(clean(text), scalar_clean(text)) << "input: " << text;
+    }
+}
+
+TEST(HtmlText, MatchesScalarCleanerAtEveryOffset) {
+    const std::vector<std::string> specials = {
+            "<b>", "&amp;", "&nbsp;", "  ", " \t", "\n", "\x1f", "<!-- c -->", "x < y", "&foo;"};
+    for (const auto& special : specials) {
+        for (size_t at = 0; at <= 70; ++at) {
+            std::string text;
+            for (size_t i = 0; i < 70; ++i) {
+                text.push_back(static_cast<char>('a' + i % 26));
+            }
+            text.insert(at, special);
+            EXPECT_EQ(clean(text), scalar_clean(text)) << "input: " << text;
+        }
+    }
+}
@@ -0,0 +1,114 @@
+// iso_date parse/format against the istringstream + std::get_time + mktime
+// and strftime code the parsers and Paper used before
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "IsoDate.h"
+
+namespace {
+
+    // Dates as the APIs send them: arXiv timestamps, bioRxiv/ChemRxiv days
+    std::vector<std::string> make_dates(bool with_time) {
+        std::vector<std::string> dates;
+        for (int i = 0; i < 1024; ++i) {
+            char text[32];
+            if (with_time) {
+                std::snprintf(text, sizeof(text), "20%02d-%02d-%02dT%02d:%02d:%02dZ",
+                              10 + i % 15, 1 + i % 12, 1 + i % 28, i % 24, i % 60, (i * 7) % 60);
+            } else {
+                std::snprintf(text, sizeof(text), "20%02d-%02d-%02d", 10 + i % 15, 1 + i % 12, 1 + i % 28);
+            }
+            dates.emplace_back(text);
+        }
+        return dates;
+    }
+
+    std::chrono::system_clock::time_point parse_with_get_time(const std::string& text, const char* format) {
+        std::tm tm = {};
+        std::istringstream ss(text);
+        ss >> std::get_time(&tm, format);
+        return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+    }
+
+    std::string format_with_strftime(std::chrono::system_clock::time_point time_point) {
+        auto time_t = std::chrono::system_clock::to_time_t(time_point);
+        std::tm tm{};
+        gmtime_r(&time_t, &tm);
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        return buffer;
+    }
+}
+
+static void BM_IsoDateParseTimestamp(benchmark::State& state) {
+    auto dates = make_dates(true);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(iso_date::parse_epoch_seconds(dates[i++ & 1023]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_IsoDateParseTimestamp);
+
+static void BM_GetTimeParseTimestamp(benchmark::State& state) {
+    auto dates = make_dates(true);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parse_with_get_time(dates[i++ & 1023], "%Y-%m-%dT%H:%M:%SZ"));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_GetTimeParseTimestamp);
+
+static void BM_IsoDateParseDay(benchmark::State& state) {
+    auto dates = make_dates(false);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(iso_date::parse_epoch_seconds(dates[i++ & 1023]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_IsoDateParseDay);
+
+static void BM_GetTimeParseDay(benchmark::State& state) {
+    auto dates = make_dates(false);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parse_with_get_time(dates[i++ & 1023], "%Y-%m-%d"));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_GetTimeParseDay);
+
+static void BM_IsoDateFormat(benchmark::State& state) {
+    std::vector<std::chrono::system_clock::time_point> times;
+    for (const auto& date : make_dates(true)) {
+        times.push_back(iso_date::parse(date));
+    }
+    size_t i = 0;
+    char text[iso_date::kFormattedLength];
+    for (auto _ : state) {
+        auto seconds = std::chrono::floor<std::chrono::seconds>(times[i++ & 1023]).time_since_epoch().count();
+        iso_date::format_epoch_seconds(seconds, text);
+        benchmark::DoNotOptimize(text);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_IsoDateFormat);
+
+static void BM_StrftimeFormat(benchmark::State& state) {
+    std::vector<std::chrono::system_clock::time_point> times;
+    for (const auto& date : make_dates(true)) {
+        times.push_back(iso_date::parse(date));
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(format_with_strftime(times[i++ & 1023]));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_StrftimeFormat);
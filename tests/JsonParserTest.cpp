@@ -0,0 +1,78 @@
+// bioRxiv and ChemRxiv documents, well-formed and not, through whichever JSON
+// backend this build uses (nlohmann, or simdjson with CRAWLER_USE_SIMDJSON).
+// Every case is checked against the same expected output in tests/data/parsers,
+// one Paper::to_json().dump() per line, so both builds must agree with it.
+//
+// CRAWLER_UPDATE_EXPECTED=1 rewrites the expected files from this build's
+// output instead; review the diff before committing it.
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include "parser/PaperParser.h"
+
+namespace {
+    const std::filesystem::path kDataDir = std::filesystem::path(CRAWLER_TEST_DATA_DIR) / "parsers";
+
+    struct Case {
+        std::string source;
+        std::string name;  // <name>.json and <name>.expected.jsonl
+    };
+
+    void PrintTo(const Case& test_case, std::ostream* out) {
+        *out << test_case.name;
+    }
+
+    const std::vector<Case> kCases = {
+            {"biorxiv", "biorxiv_sample"},
+            {"biorxiv", "biorxiv_malformed_items"},
+            {"biorxiv", "biorxiv_truncated"},
+            {"biorxiv", "biorxiv_trailing_garbage"},
+            {"biorxiv", "biorxiv_empty_element"},
+            {"biorxiv", "biorxiv_collection_not_array"},
+            {"biorxiv", "biorxiv_not_object"},
+            {"chemrxiv", "chemrxiv_sample"},
+            {"chemrxiv", "chemrxiv_malformed_items"},
+            {"chemrxiv", "chemrxiv_truncated"},
+            {"chemrxiv", "chemrxiv_trailing_comma"},
+    };
+
+    std::string read_file(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        EXPECT_TRUE(file.is_open()) << path;
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    std::string dump(const std::pmr::vector<Paper>& papers) {
+        std::string out;
+        for (const auto& paper : papers) {
+            out += paper.to_json().dump() + "\n";
+        }
+        return out;
+    }
+
+    class JsonParserTest : public ::testing::TestWithParam<Case> {};
+}
+
+TEST_P(JsonParserTest, MatchesExpectedOutput) {
+    const auto& [source, name] = GetParam();
+    auto content = read_file(kDataDir / (name + ".json"));
+    auto expected_path = kDataDir / (name + ".expected.jsonl");
+    auto parser = PaperParser::create(source);
+
+    auto output = dump(parser->parse_papers(content));
+    if (const char* update = std::getenv("CRAWLER_UPDATE_EXPECTED"); update && std::string(update) == "1") {
+        std::ofstream(expected_path, std::ios::binary | std::ios::trunc) << output;
+        return;
+    }
+    EXPECT_EQ(output, read_file(expected_path));
+
+    // Split into records and parsed chunk by chunk, as large responses are
+    PaperArena arena;
+    auto parallel = parser->parse_papers_parallel(content, 3, 1, [](std::function<void()> task) { task(); },
+                                                  arena);
+    EXPECT_EQ(dump(parallel), read_file(expected_path)) << "parse_papers_parallel";
+}
+
+INSTANTIATE_TEST_SUITE_P(Documents, JsonParserTest, ::testing::ValuesIn(kCases),
+                         [](const auto& info) { return info.param.name; });
@@ -0,0 +1,154 @@
+// JsonlWriter::open after a crash: a torn last line (plain files) or a torn
+// last frame without seek table (.jsonl.zst) is cut, the file is appended to,
+// and reading it back yields every complete line in order and nothing else
+#include <gtest/gtest.h>
+#include <fstream>
+#include "storage/JsonlWriter.h"
+#include "TestPapers.h"
+
+using test_papers::TempDir;
+
+namespace {
+    // Small frames so a few hundred lines span several of them
+    const seekable_zstd::Options kCompression{3, 4096, nullptr};
+
+    std::string line(size_t i) {
+        return "{\"n\":" + std::to_string(i) + ",\"text\":\"" + std::string(20 + i % 90, 'a' + i % 26) + "\"}";
+    }
+
+    std::vector<std::string> lines(size_t from, size_t to) {
+        std::vector<std::string> result;
+        for (size_t i = from; i < to; ++i) {
+            result.push_back(line(i));
+        }
+        return result;
+    }
+
+    void append_lines(const std::string& path, size_t from, size_t to, bool compressed) {
+        JsonlWriter writer(FsyncPolicy::NONE, std::chrono::seconds(1), 4 * 1024 * 1024,
+                           compressed ? std::optional(kCompression) : std::nullopt);
+        ASSERT_TRUE(writer.open(path));
+        for (size_t i = from; i < to; ++i) {
+            ASSERT_TRUE(writer.append(line(i)));
+        }
+        ASSERT_TRUE(writer.close());
+    }
+
+    std::string read_file(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    void write_file(const std::string& path, const std::string& data) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << data;
+    }
+
+    // The decompressed stream of a .zst file, which must end in a seek table
+    std::string decompressed(const std::string& data) {
+        SeekableZstdReader reader;
+        EXPECT_TRUE(reader.open(data.data(), data.size()));
+        EXPECT_TRUE(reader.has_seek_table());
+        std::string stream;
+        for (size_t i = 0; i < reader.frame_count(); ++i) {
+            stream += reader.frame(i);
+        }
+        return stream;
+    }
+
+    // Every line of the file; fails on a final line without newline
+    std::vector<std::string> read_lines(const std::string& path, bool compressed) {
+        auto data = read_file(path);
+        auto stream = compressed ? decompressed(data) : data;
+        std::vector<std::string> result;
+        size_t start = 0;
+        for (size_t end; (end = stream.find('\n', start)) != std::string::npos; start = end + 1) {
+            result.push_back(stream.substr(start, end - start));
+        }
+        EXPECT_EQ(start, stream.size()) << "unterminated last line";
+        return result;
+    }
+
+    // Everything before the seek table, as a crash between the last frame
+    // and the table leaves the file
+    std::string without_seek_table(const std::string& data) {
+        SeekableZstdReader reader;
+        EXPECT_TRUE(reader.open(data.data(), data.size()));
+        return data.substr(0, reader.frames_end());
+    }
+}
+
+TEST(JsonlWriterTest, CutsATornLineAndAppends) {
+    TempDir dir;
+    auto path = dir.file("papers.jsonl");
+    append_lines(path, 0, 200, false);
+    write_file(path, read_file(path) + line(999).substr(0, 17));
+
+    append_lines(path, 200, 300, false);
+    EXPECT_EQ(read_lines(path, false), lines(0, 300));
+}
+
+TEST(JsonlWriterTest, CutsATornLineLongerThanTheScanBlock) {
+    TempDir dir;
+    auto path = dir.file("papers.jsonl");
+    append_lines(path, 0, 10, false);
+    write_file(path, read_file(path) + "{\"text\":\"" + std::string(200 * 1024, 'x'));
+
+    append_lines(path, 10, 20, false);
+    EXPECT_EQ(read_lines(path, false), lines(0, 20));
+}
+
+TEST(JsonlWriterTest, CutsAFileThatIsOnlyATornLine) {
+    TempDir dir;
+    auto path = dir.file("papers.jsonl");
+    write_file(path, line(999).substr(0, 17));
+
+    append_lines(path, 0, 50, false);
+    EXPECT_EQ(read_lines(path, false), lines(0, 50));
+}
+
+TEST(JsonlWriterTest, AppendsToACleanlyClosedCompressedFile) {
+    if (!seekable_zstd::available()) {
+        GTEST_SKIP() << "built without CRAWLER_USE_ZSTD";
+    }
+    TempDir dir;
+    auto path = dir.file("papers.jsonl.zst");
+    append_lines(path, 0, 300, true);
+    append_lines(path, 300, 600, true);
+    EXPECT_EQ(read_lines(path, true), lines(0, 600));
+}
+
+TEST(JsonlWriterTest, CutsATornFrameWithoutSeekTableAndAppends) {
+    if (!seekable_zstd::available()) {
+        GTEST_SKIP() << "built without CRAWLER_USE_ZSTD";
+    }
+    TempDir dir;
+    auto path = dir.file("papers.jsonl.zst");
+    append_lines(path, 0, 300, true);
+
+    // The first frame of other lines, cut short as by a crash mid-write
+    auto other = dir.file("other.jsonl.zst");
+    append_lines(other, 1000, 1100, true);
+    SeekableZstdReader reader;
+    auto other_data = read_file(other);
+    ASSERT_TRUE(reader.open(other_data.data(), other_data.size()));
+    ASSERT_GT(reader.frame_count(), 1u);
+    auto torn = other_data.substr(0, reader.entries(1)[0].compressed_size / 2);
+    write_file(path, without_seek_table(read_file(path)) + torn);
+
+    append_lines(path, 300, 600, true);
+    EXPECT_EQ(read_lines(path, true), lines(0, 600));
+}
+
+TEST(JsonlWriterTest, AppendsAfterALostSeekTable) {
+    if (!seekable_zstd::available()) {
+        GTEST_SKIP() << "built without CRAWLER_USE_ZSTD";
+    }
+    TempDir dir;
+    auto path = dir.file("papers.jsonl.zst");
+    append_lines(path, 0, 300, true);
+    write_file(path, without_seek_table(read_file(path)));
+
+    append_lines(path, 300, 600, true);
+    EXPECT_EQ(read_lines(path, true), lines(0, 600));
+}
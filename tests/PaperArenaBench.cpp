@@ -0,0 +1,105 @@
+// Heap allocations per parsed response with Papers on the default resource
+// against a per-response PaperArena. Global operator new is counted, so the
+// "allocs" counters include everything the parser allocates, not only the
+// Papers' strings and vectors.
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "parser/ArxivParser.h"
+#include "PaperArena.h"
+#include "TestPapers.h"
+
+namespace {
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> allocated_bytes{0};
+
+    void* counted_alloc(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+        size = (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment;
+        if (void* p = std::aligned_alloc(alignment, size)) {
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+
+    // Allocations and bytes per iteration and per paper
+    struct AllocationCounter {
+        size_t start_allocations = allocations.load();
+        size_t start_bytes = allocated_bytes.load();
+
+        void report(benchmark::State& state, size_t papers) const {
+            auto iterations = static_cast<double>(state.iterations());
+            auto count = static_cast<double>(allocations.load() - start_allocations);
+            auto bytes = static_cast<double>(allocated_bytes.load() - start_bytes);
+            state.counters["allocs"] = count / iterations;
+            state.counters["allocs/paper"] = count / iterations / static_cast<double>(papers);
+            state.counters["heap_bytes"] = bytes / iterations;
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * papers));
+        }
+    };
+}
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+// std::pmr's default resource allocates through the aligned forms
+void* operator new(size_t size, std::align_val_t alignment) {
+    return counted_alloc(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return counted_alloc(size, static_cast<size_t>(alignment));
+}
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+// Every string and vector of every Paper is its own heap allocation
+static void BM_ParseDefaultResource(benchmark::State& state) {
+    const auto& text = test_papers::arxiv_feed(static_cast<size_t>(state.range(0)));
+    ArxivParser parser;
+    AllocationCounter counter;
+    for (auto _ : state) {
+        auto papers = parser.parse_papers(text);
+        benchmark::DoNotOptimize(papers.data());
+    }
+    counter.report(state, static_cast<size_t>(state.range(0)));
+}
+BENCHMARK(BM_ParseDefaultResource)->Arg(100)->Arg(2000);
+
+// The response's Papers bump-allocated from one region, released together
+static void BM_ParsePaperArena(benchmark::State& state) {
+    const auto& text = test_papers::arxiv_feed(static_cast<size_t>(state.range(0)));
+    ArxivParser parser;
+    AllocationCounter counter;
+    for (auto _ : state) {
+        PaperArena arena;
+        auto papers = parser.parse_papers(text, arena.region(text.size()));
+        benchmark::DoNotOptimize(papers.data());
+    }
+    counter.report(state, static_cast<size_t>(state.range(0)));
+}
+BENCHMARK(BM_ParsePaperArena)->Arg(100)->Arg(2000);
+
+// Copying arena Papers out to the default resource, what a consumer that
+// keeps papers beyond the batch pays
+static void BM_ParsePaperArenaThenCopy(benchmark::State& state) {
+    const auto& text = test_papers::arxiv_feed(static_cast<size_t>(state.range(0)));
+    ArxivParser parser;
+    AllocationCounter counter;
+    for (auto _ : state) {
+        PaperArena arena;
+        auto papers = parser.parse_papers(text, arena.region(text.size()));
+        std::vector<Paper> kept(papers.begin(), papers.end());
+        benchmark::DoNotOptimize(kept.data());
+    }
+    counter.report(state, static_cast<size_t>(state.range(0)));
+}
+BENCHMARK(BM_ParsePaperArenaThenCopy)->Arg(100)->Arg(2000);
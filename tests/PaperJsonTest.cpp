@@ -0,0 +1,112 @@
+// paper_json::write produces exactly what nlohmann makes of Paper::to_json:
+// dump() for Style::Compact and dump(4) for Style::Pretty. Strings run past
+// 32 bytes with the interesting bytes at every offset, so both the vector
+// loop (AVX2 or SSE2, whichever the build targets) and the scalar tail see
+// them.
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include "storage/PaperJson.h"
+#include "TestPapers.h"
+
+using test_papers::make_paper;
+
+namespace {
+    // Control characters, JSON metacharacters and UTF-8 of every length
+    const std::vector<std::string> kSpecial = {
+            "\"", "\\", "/", "\n", "\r", "\t", "\b", "\f", std::string(1, '\0'), "\x01", "\x1f", "\x7f",
+            "\xc3\xa9",          // é
+            "\xe4\xb8\xad",      // 中
+            "\xf0\x9f\x98\x80",  // 😀
+            "\xef\xbf\xbd",      // U+FFFD itself
+    };
+
+    // Ill-formed UTF-8: stray continuation bytes, truncated sequences,
+    // overlong forms, surrogates and code points past U+10FFFF
+    const std::vector<std::string> kInvalid = {
+            "\x80", "\xbf", "\xc0\xaf", "\xc1\xbf", "\xc3", "\xc3(", "\xe4\xb8", "\xe4\xb8(",
+            "\xe0\x80\xaf", "\xed\xa0\x80", "\xf0\x8f\xbf\xbf", "\xf0\x9f\x98", "\xf4\x90\x80\x80",
+            "\xf5\x80\x80\x80", "\xfe", "\xff",
+    };
+
+    // `special` at offset `at` of a 70-byte ASCII string
+    std::string padded(const std::string& special, size_t at) {
+        std::string text(70, 'x');
+        for (size_t i = 0; i < text.size(); ++i) {
+            text[i] = static_cast<char>('a' + i % 26);
+        }
+        return text.substr(0, at) + special + text.substr(at);
+    }
+
+    Paper with_text(size_t i, const std::string& text) {
+        auto paper = make_paper(i);
+        paper.title = text;
+        paper.abstract = text + std::string(paper.abstract) + text;
+        paper.comment = text;
+        paper.authors.emplace_back(text, "", text);
+        paper.keywords.emplace_back(text);
+        return paper;
+    }
+
+    std::string written(const Paper& paper, paper_json::Style style) {
+        std::string out;
+        size_t size = paper_json::write(paper, out, style);
+        EXPECT_EQ(size, out.size());
+        return out;
+    }
+
+    // nlohmann refuses ill-formed UTF-8 unless told to replace it
+    std::string dumped(const Paper& paper, int indent) {
+        return paper.to_json().dump(indent, ' ', false, nlohmann::json::error_handler_t::replace);
+    }
+
+    void expect_same(const Paper& paper, const std::string& label) {
+        EXPECT_EQ(written(paper, paper_json::Style::Compact), dumped(paper, -1)) << label;
+        EXPECT_EQ(written(paper, paper_json::Style::Pretty), dumped(paper, 4)) << label;
+    }
+}
+
+TEST(PaperJsonTest, MatchesNlohmannOnGeneratedPapers) {
+    for (size_t i = 0; i < 500; ++i) {
+        expect_same(make_paper(i), "paper " + std::to_string(i));
+    }
+}
+
+TEST(PaperJsonTest, MatchesNlohmannOnEscapesAndMultibyteCharacters) {
+    for (size_t s = 0; s < kSpecial.size(); ++s) {
+        for (size_t at = 0; at <= 70; ++at) {
+            expect_same(with_text(s * 71 + at, padded(kSpecial[s], at)),
+                        "special " + std::to_string(s) + " at " + std::to_string(at));
+        }
+    }
+}
+
+TEST(PaperJsonTest, MatchesNlohmannOnInvalidUtf8) {
+    for (size_t s = 0; s < kInvalid.size(); ++s) {
+        for (size_t at = 0; at <= 70; ++at) {
+            expect_same(with_text(s * 71 + at, padded(kInvalid[s], at)),
+                        "invalid " + std::to_string(s) + " at " + std::to_string(at));
+        }
+        // At the very end, where a truncated sequence runs out of input
+        expect_same(with_text(s, std::string(40, 'x') + kInvalid[s]), "invalid " + std::to_string(s) + " at end");
+    }
+}
+
+TEST(PaperJsonTest, EveryStyleParsesBack) {
+    for (const auto& text : kInvalid) {
+        auto paper = with_text(7, padded(text, 33));
+        for (auto style : {paper_json::Style::Compact, paper_json::Style::Pretty}) {
+            auto json = nlohmann::json::parse(written(paper, style));
+            EXPECT_EQ(json["id"], std::string(paper.id));
+            EXPECT_EQ(json["authors"].size(), paper.authors.size());
+        }
+    }
+}
+
+TEST(PaperJsonTest, ViewWritesLikeItsPaper) {
+    for (size_t i = 0; i < kSpecial.size(); ++i) {
+        auto paper = with_text(i, padded(kSpecial[i], 40));
+        std::string from_view;
+        paper_json::write(PaperView::of(paper), from_view, paper_json::Style::Pretty);
+        EXPECT_EQ(from_view, written(paper, paper_json::Style::Pretty)) << "special " << i;
+    }
+}
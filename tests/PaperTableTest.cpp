@@ -0,0 +1,41 @@
+// PaperTable round trips and its overflow checks
+#include <gtest/gtest.h>
+#include "PaperTable.h"
+#include "TestPapers.h"
+
+using test_papers::make_paper;
+
+TEST(PaperTable, RoundTrip) {
+    std::vector<Paper> papers;
+    for (size_t i = 0; i < 100; ++i) {
+        papers.push_back(make_paper(i));
+    }
+    auto table = PaperTable::from_papers(papers);
+    ASSERT_EQ(table.size(), papers.size());
+    for (PaperTable::Row row = 0; row < table.size(); ++row) {
+        EXPECT_EQ(table.to_paper(row).to_json(), papers[row].to_json());
+    }
+}
+
+TEST(PaperTable, OversizedTextThrowsInsteadOfTruncating) {
+    PaperTable table;
+    table.append(make_paper(0));
+
+    Paper paper = make_paper(1);
+    paper.abstract.assign((size_t{1} << 24), 'a');
+    EXPECT_THROW(table.append(paper), std::length_error);
+
+    Paper author = make_paper(2);
+    author.authors.back().name.assign((size_t{1} << 24), 'b');
+    EXPECT_THROW(table.append(author), std::length_error);
+
+    // Nothing of the rejected papers was kept
+    ASSERT_EQ(table.size(), 1u);
+    EXPECT_EQ(table.to_paper(0).to_json(), make_paper(0).to_json());
+
+    // The largest text that fits is stored whole
+    paper.abstract.resize((size_t{1} << 24) - 1);
+    table.append(paper);
+    EXPECT_EQ(table.text(PaperTable::Text::Abstract, 1).size(), paper.abstract.size());
+    EXPECT_EQ(table.categories(1).size(), paper.categories.size());
+}
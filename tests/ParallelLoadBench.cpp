@@ -0,0 +1,154 @@
+// Corpus load throughput against the raw read bandwidth of the disk it is on.
+//
+// Every iteration first drops the corpus files from the page cache
+// (POSIX_FADV_DONTNEED), so the "cold" numbers include the device. Point
+// CRAWLER_BENCH_DIR at a directory on the disk to measure (e.g. an NVMe
+// mount); by default the corpus goes to the system temp dir, which may be
+// tmpfs. CRAWLER_BENCH_PAPERS sets the corpus size (default 100000).
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include "storage/DataStorage.h"
+#include "TestPapers.h"
+
+namespace {
+    struct Corpus {
+        std::filesystem::path dir;
+        std::vector<std::filesystem::path> files;
+        uint64_t bytes = 0;
+        std::unique_ptr<test_papers::TempDir> temp;
+
+        explicit Corpus(const std::string& format) {
+            const char* base = std::getenv("CRAWLER_BENCH_DIR");
+            if (base) {
+                dir = std::filesystem::path(base) / ("crawlpaper_bench_" + format);
+                std::filesystem::remove_all(dir);
+            } else {
+                temp = std::make_unique<test_papers::TempDir>();
+                dir = temp->path() / format;
+            }
+
+            const char* count = std::getenv("CRAWLER_BENCH_PAPERS");
+            size_t papers = count ? std::strtoull(count, nullptr, 10) : 100000;
+            {
+                DataStorage storage;
+                storage.set_max_file_size_mb(64);
+                storage.initialize(dir.string(), format);
+                for (size_t i = 0; i < papers; ++i) {
+                    storage.save_paper(test_papers::make_paper(i));
+                }
+            }
+
+            for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+                if (entry.path().extension() == "." + format) {
+                    files.push_back(entry.path());
+                    bytes += entry.file_size();
+                }
+            }
+        }
+
+        ~Corpus() {
+            if (!temp) {
+                std::error_code error;
+                std::filesystem::remove_all(dir, error);
+            }
+        }
+
+        // Evicts the files from the page cache; dirty pages are written first
+        void drop_cache() const {
+            for (const auto& path : files) {
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd >= 0) {
+                    ::fdatasync(fd);
+                    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                    ::close(fd);
+                }
+            }
+        }
+    };
+
+    const Corpus& corpus(const std::string& format) {
+        static Corpus jsonl("jsonl");
+        static Corpus bin("bin");
+        return format == "bin" ? bin : jsonl;
+    }
+
+    const char* format_of(const benchmark::State& state) {
+        return state.range(0) ? "bin" : "jsonl";
+    }
+
+    void finish(benchmark::State& state, const Corpus& data) {
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.bytes));
+        state.SetLabel(format_of(state));
+    }
+}
+
+// The ceiling: every file read front to back in 4 MiB reads
+static void BM_RawRead(benchmark::State& state) {
+    const auto& data = corpus(format_of(state));
+    std::vector<char> buffer(4 << 20);
+    for (auto _ : state) {
+        state.PauseTiming();
+        data.drop_cache();
+        state.ResumeTiming();
+
+        uint64_t total = 0;
+        for (const auto& path : data.files) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+            ssize_t count = 0;
+            while ((count = ::read(fd, buffer.data(), buffer.size())) > 0) {
+                total += static_cast<uint64_t>(count);
+            }
+            ::close(fd);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    finish(state, data);
+}
+BENCHMARK(BM_RawRead)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// One file after the other on one thread, as scan() reads
+static void BM_SequentialScan(benchmark::State& state) {
+    const auto& data = corpus(format_of(state));
+    for (auto _ : state) {
+        state.PauseTiming();
+        data.drop_cache();
+        state.ResumeTiming();
+
+        DataStorage storage;
+        storage.open_for_reading(data.dir.string());
+        size_t papers = 0;
+        for (Paper& paper : storage.scan()) {
+            benchmark::DoNotOptimize(paper.id.data());
+            ++papers;
+        }
+        benchmark::DoNotOptimize(papers);
+    }
+    finish(state, data);
+}
+BENCHMARK(BM_SequentialScan)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// load_parallel on range(1) threads; range(2) = ordered
+static void BM_LoadParallel(benchmark::State& state) {
+    const auto& data = corpus(format_of(state));
+    for (auto _ : state) {
+        state.PauseTiming();
+        data.drop_cache();
+        state.ResumeTiming();
+
+        DataStorage storage;
+        storage.open_for_reading(data.dir.string());
+        storage.set_load_threads(static_cast<size_t>(state.range(1)));
+        size_t papers = 0;
+        storage.load_parallel({}, [&papers](Paper&&) { ++papers; return true; }, state.range(2) != 0);
+        benchmark::DoNotOptimize(papers);
+    }
+    finish(state, data);
+}
+BENCHMARK(BM_LoadParallel)
+        ->ArgsProduct({{0, 1}, {1, 2, 4, 8, 16}, {0, 1}})
+        ->ArgNames({"bin", "threads", "ordered"})
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
@@ -0,0 +1,144 @@
+// DataStorage::load_parallel(ordered = true) yields exactly what a sequential
+// scan does, over several shards, rotated files and files large enough to be
+// split into ranges
+#include <gtest/gtest.h>
+#include <map>
+#include <mutex>
+#include <set>
+#include "storage/DataStorage.h"
+#include "TestPapers.h"
+
+using test_papers::make_paper;
+using test_papers::TempDir;
+
+namespace {
+    constexpr size_t kPapers = 20000;
+
+    // 20-30 MB in 8 MB files over two shards: every shard rotates at least
+    // once and the full files are split into load ranges
+    void write_corpus(const std::string& dir, const std::string& format) {
+        DataStorage storage;
+        storage.set_max_file_size_mb(8);
+        storage.set_sharding(2, ShardBy::PAPER_ID);
+        ASSERT_TRUE(storage.initialize(dir, format));
+        for (size_t i = 0; i < kPapers; ++i) {
+            ASSERT_TRUE(storage.save_paper(make_paper(i)));
+        }
+        ASSERT_TRUE(storage.flush());
+
+        size_t files = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            files += entry.path().extension() == "." + format;
+        }
+        ASSERT_GE(files, 4u);
+    }
+
+    std::vector<std::string> sequential_ids(const std::string& dir, const ScanFilter& filter) {
+        DataStorage storage;
+        EXPECT_TRUE(storage.open_for_reading(dir));
+        std::vector<std::string> ids;
+        for (Paper& paper : storage.scan(filter)) {
+            ids.emplace_back(paper.id);
+        }
+        return ids;
+    }
+
+    std::vector<std::string> parallel_ids(const std::string& dir, const ScanFilter& filter, bool ordered,
+                                          size_t threads = 4) {
+        DataStorage storage;
+        EXPECT_TRUE(storage.open_for_reading(dir));
+        storage.set_load_threads(threads);
+        std::vector<std::string> ids;
+        std::mutex mutex;  // emit is never called concurrently; this checks it
+        bool ok = storage.load_parallel(filter, [&](Paper&& paper) {
+            std::unique_lock lock(mutex, std::try_to_lock);
+            EXPECT_TRUE(lock.owns_lock());
+            ids.emplace_back(paper.id);
+            return true;
+        }, ordered);
+        EXPECT_TRUE(ok);
+        return ids;
+    }
+
+    class ParallelLoad : public ::testing::TestWithParam<std::string> {
+    protected:
+        static void SetUpTestSuite() {
+            dirs_ = new std::map<std::string, std::unique_ptr<TempDir>>();
+        }
+        static void TearDownTestSuite() {
+            delete dirs_;
+            dirs_ = nullptr;
+        }
+
+        // The corpus for this format, written once per suite
+        std::string corpus_dir() {
+            auto& dir = (*dirs_)[GetParam()];
+            if (!dir) {
+                dir = std::make_unique<TempDir>();
+                write_corpus(dir->path().string(), GetParam());
+            }
+            return dir->path().string();
+        }
+
+        static std::map<std::string, std::unique_ptr<TempDir>>* dirs_;
+    };
+
+    std::map<std::string, std::unique_ptr<TempDir>>* ParallelLoad::dirs_ = nullptr;
+}
+
+TEST_P(ParallelLoad, OrderedMatchesSequentialScan) {
+    auto dir = corpus_dir();
+    auto expected = sequential_ids(dir, {});
+    ASSERT_EQ(expected.size(), kPapers);
+    EXPECT_EQ(parallel_ids(dir, {}, true), expected);
+}
+
+TEST_P(ParallelLoad, OrderedMatchesLoadPapers) {
+    auto dir = corpus_dir();
+    DataStorage storage;
+    ASSERT_TRUE(storage.open_for_reading(dir));
+    std::vector<std::string> expected;
+    for (const auto& paper : storage.load_papers()) {
+        expected.emplace_back(paper.id);
+    }
+    EXPECT_EQ(parallel_ids(dir, {}, true), expected);
+}
+
+TEST_P(ParallelLoad, OrderedMatchesSequentialScanWithFilter) {
+    auto dir = corpus_dir();
+    ScanFilter filter;
+    filter.source = "arxiv";
+    filter.category = "hep-th";
+    auto expected = sequential_ids(dir, filter);
+    ASSERT_FALSE(expected.empty());
+    ASSERT_LT(expected.size(), kPapers);
+    EXPECT_EQ(parallel_ids(dir, filter, true), expected);
+}
+
+TEST_P(ParallelLoad, OrderedDoesNotDependOnThreadCount) {
+    auto dir = corpus_dir();
+    auto expected = parallel_ids(dir, {}, true, 1);
+    for (size_t threads : {2, 3, 8}) {
+        EXPECT_EQ(parallel_ids(dir, {}, true, threads), expected) << threads << " threads";
+    }
+}
+
+TEST_P(ParallelLoad, UnorderedYieldsTheSamePapers) {
+    auto dir = corpus_dir();
+    auto expected = sequential_ids(dir, {});
+    auto ids = parallel_ids(dir, {}, false);
+    EXPECT_EQ(std::multiset<std::string>(ids.begin(), ids.end()),
+              std::multiset<std::string>(expected.begin(), expected.end()));
+}
+
+TEST_P(ParallelLoad, StopsWhenEmitReturnsFalse) {
+    auto dir = corpus_dir();
+    DataStorage storage;
+    ASSERT_TRUE(storage.open_for_reading(dir));
+    storage.set_load_threads(4);
+    size_t emitted = 0;
+    storage.load_parallel({}, [&](Paper&&) { return ++emitted < 100; }, true);
+    EXPECT_EQ(emitted, 100u);
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, ParallelLoad, ::testing::Values("jsonl", "bin"));
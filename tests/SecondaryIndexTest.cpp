@@ -0,0 +1,150 @@
+// The load_* methods return the same papers whether they read the secondary
+// index's posting lists or scan every file: for files written in one go,
+// reopened and appended to, and reopened after being written without index
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <thread>
+#include "storage/DataStorage.h"
+#include "TestPapers.h"
+
+using test_papers::make_paper;
+using test_papers::TempDir;
+
+namespace {
+    using namespace std::chrono;
+
+    constexpr size_t kPapers = 1500;
+
+    std::vector<std::string> ids_of(const std::vector<Paper>& papers) {
+        std::vector<std::string> ids;
+        for (const auto& paper : papers) {
+            ids.emplace_back(paper.id);
+        }
+        return ids;
+    }
+
+    struct Loaded {
+        std::vector<std::string> by_category;
+        std::vector<std::string> by_source;
+        std::vector<std::string> published;
+    };
+
+    Loaded load(const std::string& dir, bool secondary_index) {
+        DataStorage storage;
+        storage.set_secondary_index(secondary_index);
+        EXPECT_TRUE(storage.open_for_reading(dir));
+        Loaded loaded;
+        loaded.by_category = ids_of(storage.load_papers_by_category("hep-th"));
+        loaded.by_source = ids_of(storage.load_papers("biorxiv"));
+        // Starts and ends mid-month, across a month boundary at each end
+        loaded.published = ids_of(storage.load_papers_published(sys_days{2024y / March / 10},
+                                                                sys_days{2024y / June / 3} + hours{12}));
+        return loaded;
+    }
+
+    // The ids among papers [0, count) that each query should find
+    Loaded expected(size_t count) {
+        Loaded loaded;
+        for (size_t i = 0; i < count; ++i) {
+            auto paper = make_paper(i);
+            std::string id(paper.id);
+            if (std::ranges::find(paper.categories, Symbol::intern("hep-th")) != paper.categories.end()) {
+                loaded.by_category.push_back(id);
+            }
+            if (paper.source.str() == "biorxiv") {
+                loaded.by_source.push_back(id);
+            }
+            if (paper.published_date >= sys_days{2024y / March / 10} &&
+                paper.published_date <= sys_days{2024y / June / 3} + hours{12}) {
+                loaded.published.push_back(id);
+            }
+        }
+        return loaded;
+    }
+
+    void expect_same(const std::string& dir, size_t count) {
+        auto indexed = load(dir, true);
+        auto scanned = load(dir, false);
+        auto wanted = expected(count);
+
+        EXPECT_TRUE(std::filesystem::is_directory(std::filesystem::path(dir) / "index"));
+        EXPECT_EQ(indexed.by_category, scanned.by_category);
+        EXPECT_EQ(indexed.by_source, scanned.by_source);
+        EXPECT_EQ(indexed.published, scanned.published);
+
+        // Shards and files reorder the papers, not which ones come back
+        for (auto* ids : {&scanned.by_category, &scanned.by_source, &scanned.published,
+                          &wanted.by_category, &wanted.by_source, &wanted.published}) {
+            std::sort(ids->begin(), ids->end());
+        }
+        EXPECT_EQ(scanned.by_category, wanted.by_category);
+        EXPECT_EQ(scanned.by_source, wanted.by_source);
+        EXPECT_EQ(scanned.published, wanted.published);
+    }
+
+    void write_papers(const std::string& dir, const std::string& format, size_t from, size_t to,
+                      bool secondary_index) {
+        DataStorage storage;
+        storage.set_secondary_index(secondary_index);
+        ASSERT_TRUE(storage.initialize(dir, format));
+        for (size_t i = from; i < to; ++i) {
+            ASSERT_TRUE(storage.save_paper(make_paper(i)));
+        }
+        ASSERT_TRUE(storage.flush());
+    }
+
+    size_t data_files(const std::string& dir, const std::string& format) {
+        size_t files = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            files += entry.path().extension() == "." + format;
+        }
+        return files;
+    }
+
+    // Data files are named after the second they were opened in: starting
+    // right after a second boundary lets two short runs share one file
+    void wait_for_next_second() {
+        auto now = system_clock::now();
+        std::this_thread::sleep_until(ceil<seconds>(now) + milliseconds(5));
+    }
+
+    class SecondaryIndexTest : public ::testing::TestWithParam<std::string> {};
+}
+
+TEST_P(SecondaryIndexTest, SameIdsAsFullScan) {
+    TempDir dir;
+    {
+        DataStorage storage;
+        storage.set_max_file_size_mb(1);
+        storage.set_sharding(2, ShardBy::PAPER_ID);
+        ASSERT_TRUE(storage.initialize(dir.path().string(), GetParam()));
+        for (size_t i = 0; i < kPapers; ++i) {
+            ASSERT_TRUE(storage.save_paper(make_paper(i)));
+        }
+        ASSERT_TRUE(storage.flush());
+    }
+    ASSERT_GE(data_files(dir.path().string(), GetParam()), 2u);
+    expect_same(dir.path().string(), kPapers);
+}
+
+TEST_P(SecondaryIndexTest, SameIdsAfterAppendingToAReopenedFile) {
+    TempDir dir;
+    wait_for_next_second();
+    write_papers(dir.path().string(), GetParam(), 0, kPapers / 2, true);
+    write_papers(dir.path().string(), GetParam(), kPapers / 2, kPapers, true);
+    ASSERT_EQ(data_files(dir.path().string(), GetParam()), 1u) << "the second run did not reopen the file";
+    expect_same(dir.path().string(), kPapers);
+}
+
+TEST_P(SecondaryIndexTest, SameIdsAfterAppendingToAFileWrittenWithoutIndex) {
+    TempDir dir;
+    wait_for_next_second();
+    write_papers(dir.path().string(), GetParam(), 0, kPapers / 2, false);
+    ASSERT_FALSE(std::filesystem::exists(dir.path() / "index"));
+    write_papers(dir.path().string(), GetParam(), kPapers / 2, kPapers, true);
+    ASSERT_EQ(data_files(dir.path().string(), GetParam()), 1u) << "the second run did not reopen the file";
+    expect_same(dir.path().string(), kPapers);
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, SecondaryIndexTest, ::testing::Values("jsonl", "bin"),
+                         [](const auto& info) { return info.param; });
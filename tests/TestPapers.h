@@ -0,0 +1,131 @@
+//
+// Created by huang on 2026/2/8.
+//
+
+#ifndef CRAWLPAPER_TESTPAPERS_H
+#define CRAWLPAPER_TESTPAPERS_H
+
+#endif //CRAWLPAPER_TESTPAPERS_H
+
+#pragma once
+#include <string>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <map>
+#include "Paper.h"
+
+// Helpers shared by the tests and benchmarks
+namespace test_papers {
+
+    // A realistic, fully populated paper; `i` makes the id and text unique
+    inline Paper make_paper(size_t i) {
+        using namespace std::chrono;
+        static const char* kSources[] = {"arxiv", "biorxiv", "chemrxiv"};
+        static const char* kCategories[] = {"cond-mat.mtrl-sci", "hep-th", "quant-ph", "physics.chem-ph"};
+
+        Paper paper;
+        paper.id = "2401." + std::to_string(10000 + i) + "v" + std::to_string(1 + i % 3);
+        paper.title = "On the structure of test paper " + std::to_string(i);
+        paper.abstract = "We study the properties of sample " + std::to_string(i) + ". " +
+                         std::string(600 + i % 400, 'a');
+        paper.authors.emplace_back("Smith J.", "MIT", "0000-0002-1825-0097");
+        paper.authors.emplace_back("Doe A. " + std::to_string(i % 50), "", "");
+        paper.doi = "10.1103/PhysRevB." + std::to_string(i);
+        paper.pdf_url = "http://arxiv.org/pdf/" + std::string(paper.id);
+        paper.source = Symbol::intern(kSources[i % 3]);
+        paper.categories.push_back(Symbol::intern(kCategories[i % 4]));
+        paper.categories.push_back(Symbol::intern(kCategories[(i + 1) % 4]));
+        paper.published_date = sys_days{2024y / January / 1} + days{i % 365} + seconds{i % 86400};
+        paper.updated_date = paper.published_date + hours{24};
+        paper.journal_ref = i % 2 ? "Phys. Rev. B 99, 045123" : "";
+        paper.comment = "12 pages, 3 figures";
+        paper.version = static_cast<int>(1 + i % 3);
+        paper.keywords.emplace_back(i % 2 ? "physics" : "materials");
+        return paper;
+    }
+
+    // One arXiv export API <entry> with every field the parser reads
+    inline std::string arxiv_entry(size_t i) {
+        std::string id = "2401." + std::to_string(10000 + i) + "v1";
+        std::string entry;
+        entry += "  <entry>\n";
+        entry += "    <id>http://arxiv.org/abs/" + id + "</id>\n";
+        entry += "    <updated>2024-01-02T18:00:0" + std::to_string(i % 10) + "Z</updated>\n";
+        entry += "    <published>2024-01-01T18:00:0" + std::to_string(i % 10) + "Z</published>\n";
+        entry += "    <title>Topological phases of matter &amp; their\n  transport, part " +
+                 std::to_string(i) + "</title>\n";
+        entry += "    <summary>  We study the &lt;bulk&gt; and edge states of a model";
+        for (int sentence = 0; sentence < 8; ++sentence) {
+            entry += " with strong spin-orbit coupling and interactions, finding a rich phase diagram";
+        }
+        entry += ".\n</summary>\n";
+        for (int author = 0; author < 4; ++author) {
+            entry += "    <author>\n      <name>Author " + std::to_string(author) + " Name</name>\n";
+            if (author == 0) {
+                entry += "      <arxiv:affiliation xmlns:arxiv=\"http://arxiv.org/schemas/atom\">"
+                         "Massachusetts Institute of Technology</arxiv:affiliation>\n";
+            }
+            entry += "    </author>\n";
+        }
+        entry += "    <arxiv:doi xmlns:arxiv=\"http://arxiv.org/schemas/atom\">10.1103/PhysRevB." +
+                 std::to_string(i) + "</arxiv:doi>\n";
+        entry += "    <link title=\"doi\" href=\"http://dx.doi.org/10.1103/PhysRevB." + std::to_string(i) +
+                 "\" rel=\"related\"/>\n";
+        entry += "    <arxiv:comment xmlns:arxiv=\"http://arxiv.org/schemas/atom\">12 pages, 4 figures"
+                 "</arxiv:comment>\n";
+        entry += "    <arxiv:journal_ref xmlns:arxiv=\"http://arxiv.org/schemas/atom\">Phys. Rev. B 99, "
+                 "045123 (2024)</arxiv:journal_ref>\n";
+        entry += "    <link href=\"http://arxiv.org/abs/" + id + "\" rel=\"alternate\" type=\"text/html\"/>\n";
+        entry += "    <link title=\"pdf\" href=\"http://arxiv.org/pdf/" + id +
+                 "\" rel=\"related\" type=\"application/pdf\"/>\n";
+        entry += "    <arxiv:primary_category xmlns:arxiv=\"http://arxiv.org/schemas/atom\" "
+                 "term=\"cond-mat.str-el\" scheme=\"http://arxiv.org/schemas/atom\"/>\n";
+        entry += "    <category term=\"cond-mat.str-el\" scheme=\"http://arxiv.org/schemas/atom\"/>\n";
+        entry += "    <category term=\"cond-mat.mes-hall\" scheme=\"http://arxiv.org/schemas/atom\"/>\n";
+        entry += "  </entry>\n";
+        return entry;
+    }
+
+    // An arXiv export API response of `entries` entries, built once per size
+    inline const std::string& arxiv_feed(size_t entries) {
+        static std::map<size_t, std::string> feeds;
+        auto& text = feeds[entries];
+        if (text.empty()) {
+            text = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                   "<feed xmlns=\"http://www.w3.org/2005/Atom\">\n"
+                   "  <title type=\"html\">ArXiv Query: search_query=cat:cond-mat</title>\n"
+                   "  <opensearch:totalResults xmlns:opensearch=\"http://a9.com/-/spec/opensearch/1.1/\">"
+                   "100000</opensearch:totalResults>\n";
+            for (size_t i = 0; i < entries; ++i) {
+                text += arxiv_entry(i);
+            }
+            text += "</feed>\n";
+        }
+        return text;
+    }
+
+    // Fresh directory under the system temp dir, removed on destruction
+    class TempDir {
+    public:
+        TempDir() {
+            std::random_device random;
+            path_ = std::filesystem::temp_directory_path() /
+                    ("crawlpaper_test_" + std::to_string(random()) + std::to_string(random()));
+            std::filesystem::create_directories(path_);
+        }
+        ~TempDir() {
+            std::error_code error;
+            std::filesystem::remove_all(path_, error);
+        }
+
+        TempDir(const TempDir&) = delete;
+        TempDir& operator=(const TempDir&) = delete;
+
+        const std::filesystem::path& path() const { return path_; }
+        std::string file(const std::string& name) const { return (path_ / name).string(); }
+
+    private:
+        std::filesystem::path path_;
+    };
+}
@@ -0,0 +1,196 @@
+// Differential test: text_scan:: against the std::regex extractors it replaced
+// (ArxivParser::parse_arxiv_id / parse_doi, BiorxivParser::parse_authors).
+#include <gtest/gtest.h>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+#include "parser/TextScanners.h"
+
+namespace {
+
+    // The original extractors, verbatim apart from the function wrappers
+    std::string regex_arxiv_id(const std::string& id_text) {
+        std::regex id_regex(R"(arxiv\.org/abs/([^/]+)$)");
+        std::smatch match;
+
+        if (std::regex_search(id_text, match, id_regex) && match.size() > 1) {
+            return match[1];
+        }
+        return id_text;
+    }
+
+    std::string regex_find_doi(const std::string& href) {
+        std::regex doi_regex(R"(10\.\d{4,9}/[-._;()/:A-Z0-9]+)", std::regex::icase);
+        std::smatch match;
+
+        if (std::regex_search(href, match, doi_regex)) {
+            return match[0];
+        }
+        return "";
+    }
+
+    std::vector<std::string> regex_split_authors(const std::string& authors_str) {
+        std::vector<std::string> names;
+        std::regex author_regex(R"(([^,]+)(?:,\s*|$))");
+        std::sregex_iterator it(authors_str.begin(), authors_str.end(), author_regex);
+        std::sregex_iterator end;
+
+        while (it != end) {
+            std::smatch match = *it;
+            if (match.size() > 1) {
+                names.push_back(match[1].str());
+            }
+            ++it;
+        }
+        return names;
+    }
+
+    std::vector<std::string> scan_split_authors(const std::string& list) {
+        std::pmr::vector<Author> authors;
+        text_scan::split_authors(list, authors);
+
+        std::vector<std::string> names;
+        for (const auto& author : authors) {
+            names.emplace_back(author.name);
+        }
+        return names;
+    }
+
+    // The one intended difference: the regex could not extract old-style IDs
+    // ("hep-th/9901001v1") and returned the whole text instead
+    void expect_same_arxiv_id(const std::string& text) {
+        std::string scanned(text_scan::arxiv_id(text));
+        std::string expected = regex_arxiv_id(text);
+        if (scanned != expected && text_scan::is_old_style_arxiv_id(scanned)) {
+            EXPECT_EQ(expected, text) << "input: " << text;
+            return;
+        }
+        EXPECT_EQ(scanned, expected) << "input: " << text;
+    }
+
+    // Random strings assembled from fragments the extractors care about
+    std::string random_input(std::mt19937& rng, const std::vector<std::string>& fragments) {
+        std::uniform_int_distribution<size_t> length(0, 12);
+        std::uniform_int_distribution<size_t> pick(0, fragments.size() - 1);
+
+        std::string text;
+        for (size_t i = length(rng); i > 0; --i) {
+            text += fragments[pick(rng)];
+        }
+        return text;
+    }
+
+    constexpr int kFuzzIterations = 20000;
+}
+
+TEST(TextScanners, ArxivIdMatchesRegexOnCorpus) {
+    const std::vector<std::string> corpus = {
+            "http://arxiv.org/abs/2401.00001v2",
+            "http://arxiv.org/abs/2401.00001",
+            "https://arxiv.org/abs/1501.1234v10",
+            "http://arxiv.org/abs/hep-th/9901001v1",
+            "http://arxiv.org/abs/math.AG/0301001v3",
+            "http://arxiv.org/abs/cond-mat/0102536",
+            "2401.00001",
+            "",
+            "arxiv.org/abs/",
+            "arxiv.org/abs/x",
+            "arxiv.org/abs//",
+            "arxiv.org/abs/2401.00001/",
+            "arxiv.org/abs/arxiv.org/abs/2401.00001",
+            "arxiv.org/abs/hep-th/arxiv.org/abs/2401.00001v1",
+            "arxiv.org/abs/a/b/c",
+            "arxiv.org/abs/HEP-TH/9901001",
+            "arxiv.org/abs/hep-th/990100",
+            "arxiv.org/abs/hep-th/9901001v",
+            "arxiv.orgXabs/2401.00001",
+            "ARXIV.ORG/ABS/2401.00001",
+            "http://arxiv.org/abs/2401.00001v2\n",
+            "http://arxiv.org/abs/ 2401.00001",
+    };
+    for (const auto& text : corpus) {
+        expect_same_arxiv_id(text);
+    }
+}
+
+TEST(TextScanners, FindDoiMatchesRegexOnCorpus) {
+    const std::vector<std::string> corpus = {
+            "http://dx.doi.org/10.1103/PhysRevB.99.045123",
+            "https://doi.org/10.1101/2024.01.01.573000",
+            "10.1000/xyz(123);abc:def/ghi",
+            "doi:10.12345678/a",
+            "10.123456789/a",
+            "10.1234567890/a",
+            "10.123/abc",
+            "10.1234/",
+            "10.1234/ ",
+            "10.1234//",
+            "1010.1234/x",
+            "10.10.1234/x",
+            "10.1234 10.5678/y",
+            "10.",
+            "",
+            "no doi here",
+            "10.1234/ABC-def_ghi.jkl?query=1",
+            "10.1234/\xc3\xa9t\xc3\xa9",
+            "x10.99999/Z",
+    };
+    for (const auto& text : corpus) {
+        EXPECT_EQ(std::string(text_scan::find_doi(text)), regex_find_doi(text)) << "input: " << text;
+    }
+}
+
+TEST(TextScanners, SplitAuthorsMatchesRegexOnCorpus) {
+    const std::vector<std::string> corpus = {
+            "Smith J., Doe A., Roe B.",
+            "Smith J.,Doe A.",
+            "Single Author",
+            "",
+            ",",
+            ",,,",
+            "a,,b",
+            "a, ,b",
+            "a ,b",
+            " leading, trailing ",
+            "a,\n\tb",
+            "a,",
+            "a, ",
+            ", a",
+            "\xe5\xbc\xa0\xe4\xb8\x89, \xe6\x9d\x8e\xe5\x9b\x9b",
+    };
+    for (const auto& text : corpus) {
+        EXPECT_EQ(scan_split_authors(text), regex_split_authors(text)) << "input: " << text;
+    }
+}
+
+TEST(TextScanners, ArxivIdMatchesRegexOnRandomInput) {
+    const std::vector<std::string> fragments = {
+            "arxiv.org/abs/", "arxiv.org", "/abs/", "/", ".", "v", "v2", "2401", "00001",
+            "hep-th", "math.AG", "9901001", "-", "a", "Z", " ", "\n"};
+    std::mt19937 rng(20260208);
+    for (int i = 0; i < kFuzzIterations; ++i) {
+        expect_same_arxiv_id(random_input(rng, fragments));
+    }
+}
+
+TEST(TextScanners, FindDoiMatchesRegexOnRandomInput) {
+    const std::vector<std::string> fragments = {
+            "10.", "10", ".", "1", "1234", "56789", "/", "(", ")", ";", ":", "-", "_",
+            "a", "Z", " ", "?", "\xc3"};
+    std::mt19937 rng(20260209);
+    for (int i = 0; i < kFuzzIterations; ++i) {
+        auto text = random_input(rng, fragments);
+        EXPECT_EQ(std::string(text_scan::find_doi(text)), regex_find_doi(text)) << "input: " << text;
+    }
+}
+
+TEST(TextScanners, SplitAuthorsMatchesRegexOnRandomInput) {
+    const std::vector<std::string> fragments = {
+            ",", ", ", " ,", " ", "\t", "\n", "Smith", "J.", "Doe", "a"};
+    std::mt19937 rng(20260210);
+    for (int i = 0; i < kFuzzIterations; ++i) {
+        auto text = random_input(rng, fragments);
+        EXPECT_EQ(scan_split_authors(text), regex_split_authors(text)) << "input: " << text;
+    }
+}